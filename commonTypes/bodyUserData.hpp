@@ -2,7 +2,13 @@
 
 #include <commonTypes/componentMappers.hpp>
 
+#include <Box2D/Box2D.h>
+
+#include <optional>
+
 struct BodyUserData
 {
 	BodyComponentVariant bodyComponentVariant;
+	std::optional<b2Transform> prevTransform;
+	bool pooled = false;
 };
@@ -4,9 +4,17 @@
 
 #include <globals/componentIdGenerator.hpp>
 
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <deque>
+#include <list>
+#include <memory>
+#include <optional>
+#include <ranges>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class ComponentsBase
 {
@@ -211,14 +219,17 @@ public:
 		return components.empty();
 	}
 
-	Container& underlyingContainer()
+	// Components with ids starting from the given one, e.g. the ones added since the previous processing.
+	auto from(ComponentId id)
 	{
-		return components;
+		assert(id <= components.size());
+		return std::ranges::subrange(components.begin() + id, components.end());
 	}
 
-	const Container& underlyingContainer() const
+	auto from(ComponentId id) const
 	{
-		return components;
+		assert(id <= components.size());
+		return std::ranges::subrange(components.cbegin() + id, components.cend());
 	}
 
 	bool contains(ComponentId id) const
@@ -254,107 +265,116 @@ private:
 	Component* last_ = nullptr;
 };
 
+// Components stay in pages of slots, which never move, as mappers, closures and rendering buffers keep pointers to them. Iteration goes over
+// a dense array of their pointers, which is compacted on removal by moving the last pointer into the gap.
 template <typename Component>
 class DynamicComponents : public DynamicComponentsBase
 {
 public:
-	using Container = std::unordered_map<ComponentId, Component>;
+	static constexpr std::uint32_t slotsPerPage = 64;
 
-	template <typename ContainerIterator, typename Value>
+	template <typename Container, typename Value>
 	class IteratorBase
 	{
 	public:
-		using Self = IteratorBase<ContainerIterator, Value>;
+		using Self = IteratorBase<Container, Value>;
 
-		IteratorBase(ContainerIterator initIt):
-			containerIt(initIt)
+		IteratorBase(Container& container, std::uint32_t denseIndex):
+			container(&container),
+			denseIndex(denseIndex)
 		{
 		}
 
 		bool operator !=(Self rhs) const
 		{
-			return containerIt != rhs.containerIt;
+			return denseIndex != rhs.denseIndex;
+		}
+
+		bool operator ==(Self rhs) const
+		{
+			return denseIndex == rhs.denseIndex;
 		}
 
 		Self& operator ++()
 		{
-			++containerIt;
+			++denseIndex;
 			return *this;
 		}
 
 		Value& operator *()
 		{
-			return containerIt->second;
+			return *container->denseComponents[denseIndex];
 		}
 
 		Value* operator ->()
 		{
-			return &containerIt->second;
-		}
-
-		operator ContainerIterator()
-		{
-			return containerIt;
+			return container->denseComponents[denseIndex];
 		}
 
 	private:
-		typename ContainerIterator containerIt;
+		Container* container;
+		std::uint32_t denseIndex;
 	};
 
-	using iterator = IteratorBase<typename Container::iterator, Component>;
-	using const_iterator = IteratorBase<typename Container::const_iterator, const Component>;
+	using iterator = IteratorBase<DynamicComponents, Component>;
+	using const_iterator = IteratorBase<const DynamicComponents, const Component>;
 
 	Component& operator [](ComponentId id)
 	{
-		auto it = components.find(id);
-		assert(it != components.end());
-		return it->second;
+		auto it = idsToSlots.find(id);
+		assert(it != idsToSlots.end());
+		return *slotAt(it->second).component;
 	}
 
 	const Component& operator [](ComponentId id) const
 	{
-		auto it = components.find(id);
-		assert(it != components.end());
-		return it->second;
+		auto it = idsToSlots.find(id);
+		assert(it != idsToSlots.end());
+		return *slotAt(it->second).component;
 	}
 
 	iterator begin()
 	{
-		return iterator(components.begin());
+		return iterator(*this, 0);
 	}
 
 	const_iterator begin() const
 	{
-		return const_iterator(components.cbegin());
+		return const_iterator(*this, 0);
 	}
 
 	iterator end()
 	{
-		return iterator(components.end());
+		return iterator(*this, size());
 	}
 
 	const_iterator end() const
 	{
-		return const_iterator(components.cend());
+		return const_iterator(*this, size());
 	}
 
 	Component& add(const Component& component)
 	{
-		ComponentId id = Globals::ComponentIdGenerator().acquire();
-		auto it = components.insert({ id, component });
-		assert(it.second);
-		last_ = &it.first->second;
-		last_->init(id, false);
-		return *last_;
+		return emplace(component);
 	}
 
 	template <typename... Params>
 	Component& emplace(Params&&... params)
 	{
 		ComponentId id = Globals::ComponentIdGenerator().acquire();
-		auto it = components.try_emplace(id, std::forward<Params>(params)...);
-		assert(it.second);
-		last_ = &it.first->second;
+		const auto slotIndex = acquireSlot();
+		auto& slot = slotAt(slotIndex);
+		slot.component.emplace(std::forward<Params>(params)...);
+		slot.id = id;
+		slot.denseIndex = (std::uint32_t)denseComponents.size();
+
+		[[maybe_unused]] const bool inserted = idsToSlots.emplace(id, slotIndex).second;
+		assert(inserted);
+		denseComponents.push_back(&*slot.component);
+		denseSlots.push_back(slotIndex);
+		++modificationsCount;
+
+		last_ = &*slot.component;
 		last_->init(id, false);
 		return *last_;
 	}
@@ -367,77 +387,86 @@ public:
 
 	ComponentId size() const
 	{
-		return (ComponentId)components.size();
+		return (ComponentId)denseComponents.size();
 	}
 
 	bool empty() const
 	{
-		return components.empty();
-	}
-
-	Container& underlyingContainer()
-	{
-		return components;
+		return denseComponents.empty();
 	}
 
-	const Container& underlyingContainer() const
+	// Changes whenever a component is added or removed, so caches built over the container can tell they are stale.
+	std::uint64_t getModificationsCount() const
 	{
-		return components;
+		return modificationsCount;
 	}
 
 	bool contains(ComponentId id) const
 	{
-		return components.contains(id);
+		return idsToSlots.contains(id);
 	}
 
 	iterator find(ComponentId id)
 	{
-		return iterator(components.find(id));
+		auto it = idsToSlots.find(id);
+		return it == idsToSlots.end() ? end() : iterator(*this, slotAt(it->second).denseIndex);
 	}
 
 	const_iterator find(ComponentId id) const
 	{
-		return const_iterator(components.find(id));
+		auto it = idsToSlots.find(id);
+		return it == idsToSlots.end() ? end() : const_iterator(*this, slotAt(it->second).denseIndex);
 	}
 
 	void teardown() override
 	{
-		for (auto& [id, component] : components)
-			if (component.teardownF)
-				component.teardownF();
+		for (auto* component : denseComponents)
+			if (component->teardownF)
+				component->teardownF();
 	}
 
 	void teardownReset() override
 	{
-		for (auto& [id, component] : components)
-			if (component.teardownF)
+		for (auto* component : denseComponents)
+			if (component->teardownF)
 			{
-				component.teardownF();
-				component.teardownF = nullptr;
+				component->teardownF();
+				component->teardownF = nullptr;
 			}
 	}
 
 	void clear() override
 	{
-		components.clear();
+		for (auto slotIndex : denseSlots)
+			releaseSlot(slotIndex);
+
+		denseComponents.clear();
+		denseSlots.clear();
+		idsToSlots.clear();
+		++modificationsCount;
 		last_ = nullptr;
 	}
 
 	void cleanupEnding() override
 	{
-		auto it = components.begin();
-		while (it != components.end())
+		std::uint32_t denseIndex = 0;
+		while (denseIndex < denseComponents.size())
 		{
-			if (it->second.state == ::ComponentState::Outdated || it->second.state == ::ComponentState::LastShot)
+			auto& component = *denseComponents[denseIndex];
+			if (component.state == ::ComponentState::Outdated || component.state == ::ComponentState::LastShot)
 			{
-				if (it->second.teardownF)
-					it->second.teardownF();
-
-				Globals::ComponentIdGenerator().release(it->first);
-				it = components.erase(it);
+				if (component.teardownF)
+					component.teardownF();
+
+				const auto id = component.getComponentId();
+				Globals::ComponentIdGenerator().release(id);
+				if (last_ == &component)
+					last_ = nullptr;
+				erase(denseIndex);
+				idsToSlots.erase(id);
 			}
 			else
-				++it;
+				++denseIndex;
 		}
 
 		if (empty())
@@ -446,12 +475,80 @@ public:
 
 	void markOutdated() override
 	{
-		for (auto& [id, component] : components)
-			component.state = ::ComponentState::Outdated;
+		for (auto* component : denseComponents)
+			component->state = ::ComponentState::Outdated;
 	}
 
 private:
-	Container components;
+	struct Slot
+	{
+		std::optional<Component> component;
+		ComponentId id = 0;
+		std::uint32_t denseIndex = 0;
+	};
+
+	using Page = std::array<Slot, slotsPerPage>;
+
+	Slot& slotAt(std::uint32_t slotIndex)
+	{
+		return (*pages[slotIndex / slotsPerPage])[slotIndex % slotsPerPage];
+	}
+
+	const Slot& slotAt(std::uint32_t slotIndex) const
+	{
+		return (*pages[slotIndex / slotsPerPage])[slotIndex % slotsPerPage];
+	}
+
+	std::uint32_t acquireSlot()
+	{
+		if (!freeSlots.empty())
+		{
+			const auto slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+			return slotIndex;
+		}
+
+		if (slotsCount == pages.size() * slotsPerPage)
+			pages.push_back(std::make_unique<Page>());
+
+		return slotsCount++;
+	}
+
+	void releaseSlot(std::uint32_t slotIndex)
+	{
+		auto& slot = slotAt(slotIndex);
+		slot.component.reset();
+		slot.id = 0;
+		freeSlots.push_back(slotIndex);
+	}
+
+	void erase(std::uint32_t denseIndex)
+	{
+		const auto slotIndex = denseSlots[denseIndex];
+		const auto lastDenseIndex = (std::uint32_t)denseComponents.size() - 1;
+
+		if (denseIndex != lastDenseIndex)
+		{
+			denseComponents[denseIndex] = denseComponents[lastDenseIndex];
+			denseSlots[denseIndex] = denseSlots[lastDenseIndex];
+			slotAt(denseSlots[denseIndex]).denseIndex = denseIndex;
+		}
+
+		denseComponents.pop_back();
+		denseSlots.pop_back();
+		releaseSlot(slotIndex);
+		++modificationsCount;
+	}
+
+	std::vector<std::unique_ptr<Page>> pages;
+	std::uint32_t slotsCount = 0;
+	std::vector<std::uint32_t> freeSlots;
+
+	std::vector<Component*> denseComponents;
+	std::vector<std::uint32_t> denseSlots;
+	std::unordered_map<ComponentId, std::uint32_t> idsToSlots;
+	std::uint64_t modificationsCount = 0;
+
 	Component* last_ = nullptr;
 };
 
@@ -556,16 +653,6 @@ public:
 		return components.empty();
 	}
 
-	Container& underlyingContainer()
-	{
-		return components;
-	}
-
-	const Container& underlyingContainer() const
-	{
-		return components;
-	}
-
 	iterator remove(iterator it)
 	{
 		return iterator(components.erase(it));
@@ -0,0 +1,67 @@
+#include "frameArena.hpp"
+
+#include <algorithm>
+
+FrameArena::FrameArena(size_t initialCapacity)
+{
+	addBlock(initialCapacity);
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+	assert(alignment && (alignment & (alignment - 1)) == 0);
+
+	auto alignedOffset = (activeBlockOffset + alignment - 1) & ~(alignment - 1);
+	if (alignedOffset + size > blocks[activeBlock].size)
+	{
+		usedInPrevBlocks += activeBlockOffset;
+		if (++activeBlock == blocks.size())
+			addBlock(std::max(size + alignment, blocks.back().size * 2));
+		activeBlockOffset = 0;
+		alignedOffset = 0;
+	}
+
+	activeBlockOffset = alignedOffset + size;
+	peakUsed = std::max(peakUsed, getUsed());
+
+	return blocks[activeBlock].data.get() + alignedOffset;
+}
+
+void FrameArena::reset()
+{
+	// If the frame didn't fit into one block, blocks are merged, so in the steady state the arena doesn't allocate at all.
+	if (blocks.size() > 1)
+	{
+		const size_t capacity = getCapacity();
+		blocks.clear();
+		addBlock(capacity);
+	}
+
+	activeBlock = 0;
+	activeBlockOffset = 0;
+	usedInPrevBlocks = 0;
+}
+
+size_t FrameArena::getUsed() const
+{
+	return usedInPrevBlocks + activeBlockOffset;
+}
+
+size_t FrameArena::getCapacity() const
+{
+	size_t capacity = 0;
+	for (const auto& block : blocks)
+		capacity += block.size;
+	return capacity;
+}
+
+size_t FrameArena::getPeakUsed() const
+{
+	return peakUsed;
+}
+
+void FrameArena::addBlock(size_t minSize)
+{
+	// Blocks are aligned to max_align_t by operator new[].
+	blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(minSize), minSize });
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <globals/frameArena.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Linear allocator for data living no longer than a single frame. Memory is released all at once by reset(), which is done in
+// StateController::stepTeardown(). Destructors of objects placed in the arena are not called, so only trivially destructible
+// objects or objects whose whole memory comes from the arena (e.g. Frame* containers) should be created in it.
+class FrameArena
+{
+public:
+	FrameArena(size_t initialCapacity = 1 << 20);
+
+	void* allocate(size_t size, size_t alignment);
+
+	template <typename Type, typename... Params>
+	Type& create(Params&&... params)
+	{
+		return *new (allocate(sizeof(Type), alignof(Type))) Type(std::forward<Params>(params)...);
+	}
+
+	void reset();
+
+	size_t getUsed() const;
+	size_t getCapacity() const;
+	size_t getPeakUsed() const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+
+	void addBlock(size_t minSize);
+
+	std::vector<Block> blocks;
+	size_t activeBlock = 0;
+	size_t activeBlockOffset = 0;
+	size_t usedInPrevBlocks = 0;
+	size_t peakUsed = 0;
+};
+
+template <typename Type>
+class FrameArenaAllocator
+{
+public:
+	using value_type = Type;
+
+	FrameArenaAllocator() :
+		arena(&Globals::FrameArena())
+	{
+	}
+
+	FrameArenaAllocator(FrameArena& arena) :
+		arena(&arena)
+	{
+	}
+
+	template <typename OtherType>
+	FrameArenaAllocator(const FrameArenaAllocator<OtherType>& other) :
+		arena(other.arena)
+	{
+	}
+
+	Type* allocate(size_t count)
+	{
+		return static_cast<Type*>(arena->allocate(count * sizeof(Type), alignof(Type)));
+	}
+
+	void deallocate(Type*, size_t)
+	{
+	}
+
+	template <typename OtherType>
+	bool operator==(const FrameArenaAllocator<OtherType>& other) const
+	{
+		return arena == other.arena;
+	}
+
+private:
+	template <typename OtherType>
+	friend class FrameArenaAllocator;
+
+	FrameArena* arena;
+};
+
+template <typename Type>
+using FrameVector = std::vector<Type, FrameArenaAllocator<Type>>;
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+using FrameMultimap = std::multimap<Key, Value, Compare, FrameArenaAllocator<std::pair<const Key, Value>>>;
+
+// Move-only std::function replacement. Callables up to bufferSize are stored inline, bigger ones go to the frame arena, so
+// a FrameFunction holding a big callable must not outlive the frame it was created in.
+template <typename Signature, size_t bufferSize = 64>
+class FrameFunction;
+
+template <typename Result, typename... Args, size_t bufferSize>
+class FrameFunction<Result(Args...), bufferSize>
+{
+public:
+	FrameFunction() = default;
+
+	FrameFunction(std::nullptr_t)
+	{
+	}
+
+	template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, FrameFunction>>>
+	FrameFunction(Callable&& callable)
+	{
+		using CallableType = std::decay_t<Callable>;
+		static constexpr bool inlineStorage = sizeof(CallableType) <= bufferSize && alignof(CallableType) <= alignof(std::max_align_t)
+			&& std::is_nothrow_move_constructible_v<CallableType>;
+
+		if constexpr (inlineStorage)
+		{
+			this->callable = new (buffer) CallableType(std::forward<Callable>(callable));
+			operations = &InlineOperations<CallableType>;
+		}
+		else
+		{
+			this->callable = &Globals::FrameArena().create<CallableType>(std::forward<Callable>(callable));
+			operations = &ArenaOperations<CallableType>;
+		}
+	}
+
+	FrameFunction(FrameFunction&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	FrameFunction& operator=(FrameFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			destroy();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	FrameFunction(const FrameFunction&) = delete;
+	FrameFunction& operator=(const FrameFunction&) = delete;
+
+	~FrameFunction()
+	{
+		destroy();
+	}
+
+	Result operator()(Args... args) const
+	{
+		assert(callable);
+		return operations->invoke(callable, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const
+	{
+		return callable != nullptr;
+	}
+
+private:
+	struct Operations
+	{
+		Result(*invoke)(void* callable, Args&&... args);
+		void(*destroy)(void* callable);
+		void*(*move)(void* callable, std::byte* buffer);
+	};
+
+	template <typename CallableType>
+	static constexpr Operations InlineOperations = {
+		[](void* callable, Args&&... args) -> Result { return (*static_cast<CallableType*>(callable))(std::forward<Args>(args)...); },
+		[](void* callable) { static_cast<CallableType*>(callable)->~CallableType(); },
+		[](void* callable, std::byte* buffer) -> void* {
+			auto* moved = new (buffer) CallableType(std::move(*static_cast<CallableType*>(callable)));
+			static_cast<CallableType*>(callable)->~CallableType();
+			return moved;
+		}
+	};
+
+	template <typename CallableType>
+	static constexpr Operations ArenaOperations = {
+		[](void* callable, Args&&... args) -> Result { return (*static_cast<CallableType*>(callable))(std::forward<Args>(args)...); },
+		[](void* callable) { static_cast<CallableType*>(callable)->~CallableType(); },
+		[](void* callable, std::byte*) { return callable; }
+	};
+
+	void moveFrom(FrameFunction& other)
+	{
+		if (!other.callable)
+			return;
+
+		callable = other.operations->move(other.callable, buffer);
+		operations = other.operations;
+		other.callable = nullptr;
+		other.operations = nullptr;
+	}
+
+	void destroy()
+	{
+		if (!callable)
+			return;
+
+		operations->destroy(callable);
+		callable = nullptr;
+		operations = nullptr;
+	}
+
+	alignas(std::max_align_t) std::byte buffer[bufferSize];
+	void* callable = nullptr;
+	const Operations* operations = nullptr;
+};
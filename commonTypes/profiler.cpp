@@ -0,0 +1,339 @@
+#include "profiler.hpp"
+
+#include <ogl/oglProxy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+	constexpr unsigned gpuThreadIndex = 1000;
+
+	std::atomic<unsigned> threadsCounter = 0;
+	thread_local unsigned threadIndex = ~0u;
+	thread_local unsigned zonesDepth = 0;
+
+	unsigned GetThreadIndex()
+	{
+		if (threadIndex == ~0u)
+			threadIndex = threadsCounter++;
+		return threadIndex;
+	}
+}
+
+Profiler::ScopedZone::ScopedZone(Profiler* profiler, const char* name, bool gpu):
+	profiler(profiler),
+	name(name)
+{
+	if (!profiler)
+		return;
+
+	++zonesDepth;
+
+	if (gpu && profiler->gpuTimersAvailable)
+	{
+		gpuBeginQuery = profiler->acquireQuery();
+		glQueryCounter(gpuBeginQuery, GL_TIMESTAMP);
+	}
+
+	start = std::chrono::steady_clock::now();
+}
+
+Profiler::ScopedZone::~ScopedZone()
+{
+	if (!profiler)
+		return;
+
+	--zonesDepth;
+	profiler->endZone(name, start, gpuBeginQuery);
+}
+
+Profiler::Profiler(unsigned framesCapacity):
+	frames(std::max(framesCapacity, 1u))
+{
+}
+
+Profiler::~Profiler()
+{
+	if (!allQueries.empty())
+		glDeleteQueries((GLsizei)allQueries.size(), allQueries.data());
+}
+
+void Profiler::setEnabled(bool value)
+{
+	std::lock_guard lock(mutex);
+
+	enabled = value;
+	frameInProgress = false;
+
+	if (enabled)
+		gpuTimersAvailable = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+bool Profiler::isEnabled() const
+{
+	return enabled;
+}
+
+bool Profiler::areGpuTimersAvailable() const
+{
+	return gpuTimersAvailable;
+}
+
+void Profiler::beginFrame()
+{
+	if (!enabled)
+		return;
+
+	std::lock_guard lock(mutex);
+
+	++frameNumber;
+	auto& frame = currentFrame();
+	frame.frameNumber = frameNumber;
+	frame.zones.clear();
+	frameStart = std::chrono::steady_clock::now();
+	frame.startUs = toUs(frameStart);
+	frame.durationUs = 0.0;
+
+	if (gpuTimersAvailable)
+	{
+		// Slot's previous marker may be still pending, but zones of the overwritten frame are discarded anyway.
+		if (!frame.gpuMarkerQuery)
+			frame.gpuMarkerQuery = acquireQuery();
+		glQueryCounter(frame.gpuMarkerQuery, GL_TIMESTAMP);
+		frame.gpuMarkerTimestamp = -1;
+	}
+
+	frameInProgress = true;
+}
+
+void Profiler::endFrame()
+{
+	if (!enabled || !frameInProgress)
+		return;
+
+	{
+		std::lock_guard lock(mutex);
+
+		auto& frame = currentFrame();
+		frame.durationUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count();
+		frame.zones.push_back({ "frame", GetThreadIndex(), 0, frame.startUs, frame.durationUs, false });
+		frameInProgress = false;
+	}
+
+	resolveGpuZones();
+}
+
+Profiler::ScopedZone Profiler::zone(const char* name, bool gpu)
+{
+	return ScopedZone(enabled && frameInProgress ? this : nullptr, name, gpu);
+}
+
+std::string Profiler::getSummary() const
+{
+	struct ZoneStats
+	{
+		double cpuSum = 0.0;
+		double cpuMax = 0.0;
+		double gpuSum = 0.0;
+		double gpuMax = 0.0;
+	};
+
+	std::lock_guard lock(mutex);
+
+	std::unordered_map<std::string, ZoneStats> namesToStats;
+	std::unordered_map<std::string, std::pair<double, double>> frameNamesToDurations;
+	unsigned framesCount = 0;
+	double frameSum = 0.0;
+	double frameMax = 0.0;
+
+	for (const auto& frame : frames)
+	{
+		if (frame.frameNumber == 0 || frame.durationUs == 0.0)
+			continue;
+
+		++framesCount;
+		frameSum += frame.durationUs;
+		frameMax = std::max(frameMax, frame.durationUs);
+
+		// Zones of the same name are summed per frame, e.g. render passes of all layers.
+		frameNamesToDurations.clear();
+		for (const auto& zone : frame.zones)
+			if (zone.durationUs >= 0.0)
+				(zone.gpu ? frameNamesToDurations[zone.name].second : frameNamesToDurations[zone.name].first) += zone.durationUs;
+
+		for (const auto& [name, durations] : frameNamesToDurations)
+		{
+			auto& stats = namesToStats[name];
+			stats.cpuSum += durations.first;
+			stats.cpuMax = std::max(stats.cpuMax, durations.first);
+			stats.gpuSum += durations.second;
+			stats.gpuMax = std::max(stats.gpuMax, durations.second);
+		}
+	}
+
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(3);
+
+	if (framesCount == 0)
+	{
+		summary << "Profiler: no frames recorded.\n";
+		return summary.str();
+	}
+
+	std::vector<std::pair<std::string, ZoneStats>> sortedStats(namesToStats.begin(), namesToStats.end());
+	std::sort(sortedStats.begin(), sortedStats.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second.cpuSum + lhs.second.gpuSum > rhs.second.cpuSum + rhs.second.gpuSum;
+	});
+
+	summary << "Profiler summary of last " << framesCount << " frames, times in ms (avg / max):\n";
+	summary << "frame: " << frameSum / framesCount / 1000.0 << " / " << frameMax / 1000.0 << "\n";
+	for (const auto& [name, stats] : sortedStats)
+	{
+		if (name == "frame")
+			continue;
+
+		summary << name << ": cpu " << stats.cpuSum / framesCount / 1000.0 << " / " << stats.cpuMax / 1000.0;
+		if (stats.gpuSum > 0.0)
+			summary << ", gpu " << stats.gpuSum / framesCount / 1000.0 << " / " << stats.gpuMax / 1000.0;
+		summary << "\n";
+	}
+
+	return summary.str();
+}
+
+std::string Profiler::toChromeTrace() const
+{
+	std::lock_guard lock(mutex);
+
+	std::vector<const Frame*> sortedFrames;
+	for (const auto& frame : frames)
+		if (frame.frameNumber != 0 && frame.durationUs != 0.0)
+			sortedFrames.push_back(&frame);
+	std::sort(sortedFrames.begin(), sortedFrames.end(), [](const auto* lhs, const auto* rhs) { return lhs->frameNumber < rhs->frameNumber; });
+
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3);
+	json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << gpuThreadIndex << ",\"args\":{\"name\":\"GPU\"}}";
+
+	for (const auto* frame : sortedFrames)
+		for (const auto& zone : frame->zones)
+		{
+			if (zone.durationUs < 0.0)
+				continue;
+
+			json << ",\n{\"name\":\"" << zone.name << "\",\"cat\":\"" << (zone.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"ts\":" << zone.startUs
+				<< ",\"dur\":" << zone.durationUs << ",\"pid\":0,\"tid\":" << zone.threadIndex << ",\"args\":{\"frame\":" << frame->frameNumber << "}}";
+		}
+
+	json << "\n]}\n";
+
+	return json.str();
+}
+
+void Profiler::saveChromeTrace(const std::string& filePath) const
+{
+	std::ofstream file(filePath);
+	if (!file)
+		throw std::runtime_error("Unable to save profiler trace to " + filePath + ".");
+
+	file << toChromeTrace();
+}
+
+void Profiler::endZone(const char* name, std::chrono::steady_clock::time_point start, unsigned gpuBeginQuery)
+{
+	const auto end = std::chrono::steady_clock::now();
+
+	std::lock_guard lock(mutex);
+
+	if (!frameInProgress)
+	{
+		if (gpuBeginQuery)
+			freeQueries.push_back(gpuBeginQuery);
+		return;
+	}
+
+	auto& frame = currentFrame();
+
+	if (gpuBeginQuery)
+	{
+		const unsigned gpuEndQuery = acquireQuery();
+		glQueryCounter(gpuEndQuery, GL_TIMESTAMP);
+		pendingGpuZones.push_back({ frameNumber, frame.zones.size(), gpuBeginQuery, gpuEndQuery });
+		frame.zones.push_back({ name, gpuThreadIndex, zonesDepth, 0.0, -1.0, true });
+	}
+
+	frame.zones.push_back({ name, GetThreadIndex(), zonesDepth, toUs(start), std::chrono::duration<double, std::micro>(end - start).count(), false });
+}
+
+void Profiler::resolveGpuZones()
+{
+	std::lock_guard lock(mutex);
+
+	// Results become available in order, so resolving stops at the first pending one.
+	while (!pendingGpuZones.empty())
+	{
+		const auto& pendingGpuZone = pendingGpuZones.front();
+
+		GLint available = 0;
+		glGetQueryObjectiv(pendingGpuZone.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		auto& frame = frames[pendingGpuZone.frameNumber % frames.size()];
+		if (frame.frameNumber == pendingGpuZone.frameNumber)
+		{
+			GLuint64 beginTimestamp = 0;
+			GLuint64 endTimestamp = 0;
+			glGetQueryObjectui64v(pendingGpuZone.beginQuery, GL_QUERY_RESULT, &beginTimestamp);
+			glGetQueryObjectui64v(pendingGpuZone.endQuery, GL_QUERY_RESULT, &endTimestamp);
+
+			if (frame.gpuMarkerTimestamp < 0)
+			{
+				GLuint64 markerTimestamp = 0;
+				glGetQueryObjectui64v(frame.gpuMarkerQuery, GL_QUERY_RESULT, &markerTimestamp);
+				frame.gpuMarkerTimestamp = (std::int64_t)markerTimestamp;
+			}
+
+			// GPU clock is aligned with CPU one at the frame start, so GPU zones show how far behind the submission they were executed.
+			auto& zone = frame.zones[pendingGpuZone.zoneIndex];
+			zone.startUs = frame.startUs + ((std::int64_t)beginTimestamp - frame.gpuMarkerTimestamp) / 1000.0;
+			zone.durationUs = std::max((std::int64_t)(endTimestamp - beginTimestamp), std::int64_t(0)) / 1000.0;
+		}
+
+		freeQueries.push_back(pendingGpuZone.beginQuery);
+		freeQueries.push_back(pendingGpuZone.endQuery);
+		pendingGpuZones.pop_front();
+	}
+}
+
+unsigned Profiler::acquireQuery()
+{
+	if (freeQueries.empty())
+	{
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		allQueries.push_back(query);
+		return query;
+	}
+
+	const auto query = freeQueries.back();
+	freeQueries.pop_back();
+	return query;
+}
+
+double Profiler::toUs(std::chrono::steady_clock::time_point timePoint) const
+{
+	return std::chrono::duration<double, std::micro>(timePoint - origin).count();
+}
+
+Profiler::Frame& Profiler::currentFrame()
+{
+	return frames[frameNumber % frames.size()];
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped CPU zones (from any thread) and GPU zones (main thread, timer queries when available) recorded into a ring buffer of the last frames.
+// Zone names have to outlive the profiler, string literals are expected.
+class Profiler
+{
+public:
+	struct Zone
+	{
+		const char* name;
+		unsigned threadIndex;
+		unsigned depth;
+		double startUs;
+		double durationUs;
+		bool gpu;
+	};
+
+	struct Frame
+	{
+		std::uint64_t frameNumber = 0;
+		double startUs = 0.0;
+		double durationUs = 0.0;
+		std::vector<Zone> zones;
+
+		unsigned gpuMarkerQuery = 0;
+		std::int64_t gpuMarkerTimestamp = -1;
+	};
+
+	class ScopedZone
+	{
+	public:
+		ScopedZone(Profiler* profiler, const char* name, bool gpu);
+		~ScopedZone();
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		Profiler* profiler;
+		const char* name;
+		std::chrono::steady_clock::time_point start;
+		unsigned gpuBeginQuery = 0;
+	};
+
+	Profiler(unsigned framesCapacity = 600);
+	~Profiler();
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	// Has to be called with the OpenGL context current, as it detects and creates timer queries.
+	void setEnabled(bool value);
+	bool isEnabled() const;
+	bool areGpuTimersAvailable() const;
+
+	void beginFrame();
+	void endFrame();
+
+	// GPU zones measure commands issued within the scope, in addition to the CPU time.
+	[[nodiscard]] ScopedZone zone(const char* name, bool gpu = false);
+
+	std::string getSummary() const;
+	std::string toChromeTrace() const;
+	void saveChromeTrace(const std::string& filePath) const;
+
+private:
+	struct PendingGpuZone
+	{
+		std::uint64_t frameNumber;
+		size_t zoneIndex;
+		unsigned beginQuery;
+		unsigned endQuery;
+	};
+
+	void endZone(const char* name, std::chrono::steady_clock::time_point start, unsigned gpuBeginQuery);
+	void resolveGpuZones();
+	unsigned acquireQuery();
+	double toUs(std::chrono::steady_clock::time_point timePoint) const;
+	Frame& currentFrame();
+
+	// Checked without the lock by zones opened on worker threads.
+	std::atomic<bool> enabled = false;
+	bool gpuTimersAvailable = false;
+	std::atomic<bool> frameInProgress = false;
+
+	std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point frameStart;
+	std::uint64_t frameNumber = 0;
+	std::vector<Frame> frames;
+
+	std::deque<PendingGpuZone> pendingGpuZones;
+	std::vector<unsigned> freeQueries;
+	std::vector<unsigned> allQueries;
+
+	mutable std::mutex mutex;
+};
@@ -20,14 +20,14 @@ StandardRenderTexturesRenderer::~StandardRenderTexturesRenderer()
 			return;
 
 		if (renderMode.blending == StandardRenderMode::Blending::Standard)
-			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+			glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 		else
-			glBlendFunc(GL_ONE, GL_ONE);
+			glProxyBlendFunc(GL_ONE, GL_ONE);
 
 		Tools::TexturedScreenRender(texturedShadersProgram, Globals::Components().standardRenderTexture(renderMode).loaded.textureObject);
 
 		if (renderMode.blending == StandardRenderMode::Blending::Additive)
-			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+			glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 	};
 
 	for (size_t res = 0; res < (size_t)StandardRenderMode::Resolution::COUNT; ++res)
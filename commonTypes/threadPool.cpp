@@ -0,0 +1,137 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	thread_local const ThreadPool* currentPool = nullptr;
+	thread_local unsigned currentWorkerId = 0;
+}
+
+ThreadPool::ThreadPool(unsigned numOfWorkers)
+{
+	queues.reserve(numOfWorkers);
+	for (unsigned i = 0; i < numOfWorkers; ++i)
+		queues.push_back(std::make_unique<WorkerQueue>());
+
+	workers.reserve(numOfWorkers);
+	for (unsigned i = 0; i < numOfWorkers; ++i)
+		workers.emplace_back([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(sleepMutex);
+		stopping = true;
+	}
+	sleepCondition.notify_all();
+
+	for (auto& worker : workers)
+		worker.join();
+}
+
+void ThreadPool::submit(Job job)
+{
+	if (workers.empty())
+	{
+		job();
+		return;
+	}
+
+	const unsigned queueId = isWorkerThread()
+		? currentWorkerId
+		: nextQueueId++ % (unsigned)queues.size();
+
+	{
+		// Counted under the queue lock, so the job can't be popped (and uncounted) before it was counted.
+		std::lock_guard lock(queues[queueId]->mutex);
+		++pendingJobs;
+		queues[queueId]->jobs.push_back(std::move(job));
+	}
+
+	// Passing through the sleep lock orders the notification after a worker's check of pendingJobs, so the wakeup is not lost.
+	{ std::lock_guard lock(sleepMutex); }
+	sleepCondition.notify_one();
+}
+
+bool ThreadPool::tryRunPendingJob()
+{
+	if (workers.empty())
+		return false;
+
+	Job job;
+	if (isWorkerThread()
+		? !tryPopJob(currentWorkerId, true, job)
+		: !tryPopJob(nextQueueId % (unsigned)queues.size(), false, job))
+		return false;
+
+	job();
+	return true;
+}
+
+unsigned ThreadPool::getNumOfWorkers() const
+{
+	return (unsigned)workers.size();
+}
+
+bool ThreadPool::isWorkerThread() const
+{
+	return currentPool == this;
+}
+
+unsigned ThreadPool::DefaultNumOfWorkers()
+{
+	// Calling thread is also doing the work, so it is not counted.
+	return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+void ThreadPool::workerLoop(unsigned workerId)
+{
+	currentPool = this;
+	currentWorkerId = workerId;
+
+	Job job;
+	while (true)
+	{
+		if (tryPopJob(workerId, true, job))
+		{
+			job();
+			job = nullptr;
+			continue;
+		}
+
+		std::unique_lock lock(sleepMutex);
+		sleepCondition.wait(lock, [&]() { return stopping || pendingJobs > 0; });
+		if (stopping && pendingJobs == 0)
+			return;
+	}
+}
+
+bool ThreadPool::tryPopJob(unsigned ownQueueId, bool ownQueue, Job& job)
+{
+	for (unsigned i = 0; i < queues.size(); ++i)
+	{
+		auto& queue = *queues[(ownQueueId + i) % queues.size()];
+		std::lock_guard lock(queue.mutex);
+
+		if (queue.jobs.empty())
+			continue;
+
+		if (i == 0 && ownQueue)
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+		else
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+
+		--pendingJobs;
+		return true;
+	}
+
+	return false;
+}
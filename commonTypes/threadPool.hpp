@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool. Every worker owns a queue and takes its newest jobs first, stealing the oldest ones from other workers when it runs dry.
+class ThreadPool
+{
+public:
+	using Job = std::function<void()>;
+
+	explicit ThreadPool(unsigned numOfWorkers = DefaultNumOfWorkers());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Jobs submitted from a worker go to its own queue, the rest is distributed round-robin. Without workers the job is run immediately.
+	void submit(Job job);
+
+	// Lets a thread waiting for results help the workers instead of blocking. Returns false if there was nothing to run.
+	bool tryRunPendingJob();
+
+	unsigned getNumOfWorkers() const;
+	bool isWorkerThread() const;
+
+	static unsigned DefaultNumOfWorkers();
+
+private:
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void workerLoop(unsigned workerId);
+	bool tryPopJob(unsigned ownQueueId, bool ownQueue, Job& job);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<unsigned> nextQueueId = 0;
+	std::atomic<unsigned> pendingJobs = 0;
+
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+	bool stopping = false;
+};
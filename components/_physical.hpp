@@ -23,7 +23,7 @@ struct Physical : Renderable
 		if (!this->body)
 			return;
 
-		modelMatrixF = [this]() { return Tools::GetModelMatrix(*this->body); };
+		modelMatrixF = [this]() { return Tools::GetInterpolatedModelMatrix(*this->body); };
 		originF = [this]() { return glm::vec3(ToVec2<glm::vec2>(this->body->GetPosition()), 0.0f); };
 	}
 
@@ -90,7 +90,7 @@ struct Physical : Renderable
 		init(getComponentId(), isStatic());
 		if (this->body)
 		{
-			modelMatrixF = [this]() { return Tools::GetModelMatrix(*this->body); };
+			modelMatrixF = [this]() { return Tools::GetInterpolatedModelMatrix(*this->body); };
 			originF = [this]() { return glm::vec3(ToVec2<glm::vec2>(this->body->GetPosition()), 0.0f); };
 		}
 		state = ComponentState::Changed;
@@ -81,6 +81,8 @@ struct Renderable : ComponentBase, RenderableDef
 
 	std::vector<CM::RenderTexture> targetTextures = { Globals::Components().standardRenderTexture() };
 	RenderLayer renderLayer = Globals::Components().defaults().renderLayer;
+	// Allows reordering with other renderables of the same target to reduce state changes, e.g. if opaque and depth tested.
+	bool orderIndependent = false;
 
 	std::deque<RenderableDef> subsequence;
 	unsigned subsequenceBegin = 0;
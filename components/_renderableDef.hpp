@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <optional>
+#include <utility>
 
 namespace Buffers
 {
@@ -162,6 +163,22 @@ struct RenderableDef
 	struct
 	{
 		Buffers::GenericSubBuffers* subBuffers = nullptr;
+
+		// World space bounding box cache, recalculated when the model matrix or local bounds change.
+		struct
+		{
+			glm::mat4 modelMatrix{ 1.0f };
+			std::pair<glm::vec3, glm::vec3> localBounds;
+			std::pair<glm::vec3, glm::vec3> bounds;
+			bool valid = false;
+		} worldBounds;
+
+		// Model matrix of the rendered frame, as modelMatrixF may be stateful and is needed by both culling and drawing.
+		struct
+		{
+			glm::mat4 value{ 1.0f };
+			unsigned renderedFrameId = 0;
+		} modelMatrix;
 	} loaded;
 
 	virtual std::vector<glm::vec3> getPositions(bool transformed = false) const
@@ -25,6 +25,9 @@ namespace Components
 
 			glm::vec2 completeProjectionHSize{ 0.0f };
 			glm::vec2 prevCompleteProjectionHSize{ 0.0f };
+
+			glm::vec3 physicsStepTargetPositionAndProjectionHSize{ 0.0f };
+			glm::vec3 prevPhysicsStepTargetPositionAndProjectionHSize{ 0.0f };
 		} details;
 	};
 }
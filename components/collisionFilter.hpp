@@ -5,6 +5,7 @@
 #include <tools/b2Helpers.hpp>
 
 #include <functional>
+#include <optional>
 
 class b2Fixture;
 
@@ -26,6 +27,8 @@ namespace Components
 		}
 
 		CollisionFilter(unsigned short categoryBits, unsigned short maskBits, std::function<bool(b2Fixture&, b2Fixture&)> handler):
+			categoryBits(categoryBits),
+			maskBits(maskBits),
 			rawFilter([categoryBits, maskBits, handler = std::move(handler)](b2Fixture& fixtureA, b2Fixture& fixtureB)
 			{
 				if (categoryBits == fixtureA.GetFilterData().categoryBits && fixtureB.GetFilterData().categoryBits & maskBits)
@@ -38,6 +41,15 @@ namespace Components
 		{
 		}
 
+		// Set only for category based filters. Fixtures based ones have to be checked against every pair.
+		const std::optional<unsigned short> categoryBits;
+		const unsigned short maskBits = 0;
+
 		const std::function<Result(b2Fixture&, b2Fixture&)> rawFilter;
+
+		bool mayHandle(unsigned short categoryBitsA, unsigned short categoryBitsB) const
+		{
+			return !categoryBits || (*categoryBits == categoryBitsA && categoryBitsB & maskBits) || (*categoryBits == categoryBitsB && categoryBitsA & maskBits);
+		}
 	};
 }
@@ -5,6 +5,7 @@
 #include <tools/b2Helpers.hpp>
 
 #include <functional>
+#include <optional>
 
 class b2Fixture;
 
@@ -22,6 +23,8 @@ namespace Components
 		}
 
 		CollisionHandler(unsigned short categoryBits, unsigned short maskBits, std::function<void(b2Fixture&, b2Fixture&)> handler):
+			categoryBits(categoryBits),
+			maskBits(maskBits),
 			rawHandler([categoryBits, maskBits, handler = std::move(handler)](b2Fixture& fixtureA, b2Fixture& fixtureB)
 			{
 				if (categoryBits == fixtureA.GetFilterData().categoryBits && fixtureB.GetFilterData().categoryBits & maskBits)
@@ -32,6 +35,15 @@ namespace Components
 		{
 		}
 
+		// Set only for category based handlers. Fixtures based ones have to be checked against every contact.
+		const std::optional<unsigned short> categoryBits;
+		const unsigned short maskBits = 0;
+
 		const std::function<void(b2Fixture&, b2Fixture&)> rawHandler;
+
+		bool mayHandle(unsigned short categoryBitsA, unsigned short categoryBitsB) const
+		{
+			return !categoryBits || (*categoryBits == categoryBitsA && categoryBitsB & maskBits) || (*categoryBits == categoryBitsB && categoryBitsA & maskBits);
+		}
 	};
 }
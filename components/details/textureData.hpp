@@ -12,16 +12,19 @@
 struct TextureFile
 {
 	enum class AdditionalConversion { None, DarkToTransparent, TransparentToDark };
+	// Component type of texels kept in the cache and on the GPU. SRGB8 applies to 3 and 4 channels only, others fall back to UNorm8.
+	enum class TexelFormat { UNorm8, SRGB8, Float16, Float32 };
 
 	TextureFile() = default;
 
 	TextureFile(std::string path, int desiredChannels = 0, bool convertToPremultipliedAlpha = true, AdditionalConversion additionalConversion = AdditionalConversion::None,
-		std::function<void(float* data, glm::ivec2 size, int numOfChannels)> customConversionF = nullptr) :
+		std::function<void(float* data, glm::ivec2 size, int numOfChannels)> customConversionF = nullptr, TexelFormat texelFormat = TexelFormat::UNorm8) :
 		path{ std::move(path) },
 		desiredChannels{ desiredChannels },
 		convertToPremultipliedAlpha{ convertToPremultipliedAlpha },
 		additionalConversion{ additionalConversion },
-		customConversionF{ std::move(customConversionF) }
+		customConversionF{ std::move(customConversionF) },
+		texelFormat{ texelFormat }
 	{
 	}
 
@@ -30,6 +33,7 @@ struct TextureFile
 	bool convertToPremultipliedAlpha{};
 	AdditionalConversion additionalConversion{};
 	std::function<void(float* data, glm::ivec2 size, int numOfChannels)> customConversionF;
+	TexelFormat texelFormat{};
 };
 
 struct TextureData
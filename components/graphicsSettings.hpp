@@ -22,5 +22,8 @@ namespace Components
 		bool pointSmooth = false;
 		bool lineSmooth = false;
 		bool force3D = false;
+		bool frustumCulling = true;
+		// Compares the GL state cache with the driver after every rendered frame. Reading the state back stalls, so it's toggled on demand.
+		bool glStateValidation = false;
 	};
 }
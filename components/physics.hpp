@@ -2,6 +2,8 @@
 
 #include "_componentBase.hpp"
 
+#include <tools/discBodiesPool.hpp>
+
 #include <Box2D/Box2D.h>
 
 #include <glm/vec2.hpp>
@@ -14,6 +16,8 @@ namespace Components
 	struct Physics : ComponentBase
 	{
 		std::unique_ptr<b2World> world;
+		// Declared after the world, so pooled bodies are destroyed before it.
+		Tools::DiscBodiesPool shockwaveParticlesPool;
 
 		float simulationDuration = 0.0f;
 		float frameDuration = 0.0f;
@@ -27,6 +31,20 @@ namespace Components
 
 		bool paused = false;
 
+		// Contacts begun or ended during the world step are buffered and dispatched to collision handlers after it, grouped by category bits.
+		bool batchedContacts = false;
+
+		struct FixedStep
+		{
+			bool enabled = false;
+			float rate = 60.0f;
+			int maxSubsteps = 4;
+
+			float accumulator = 0.0f;
+			float interpolationAlpha = 1.0f;
+			int substepsInLastFrame = 0;
+		} fixedStep;
+
 		std::chrono::high_resolution_clock::time_point prevFrameTime;
 	};
 }
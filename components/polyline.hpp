@@ -19,7 +19,7 @@ namespace Components
 			Physical(Tools::CreatePolylineBody(vertices, bodyParams), std::monostate{}, std::move(renderingSetupF), customShadersProgram)
 		{
 			drawMode = GL_LINE_STRIP;
-			bufferDataUsage = GL_DYNAMIC_DRAW;
+			bufferDataUsage = GL_STREAM_DRAW;
 		}
 
 		Polyline(Tools::BodyParams bodyParams = Tools::BodyParams{}.sensor(true),
@@ -28,7 +28,7 @@ namespace Components
 			Physical(Tools::CreateEmptyBody(bodyParams), std::monostate{}, std::move(renderingSetupF), customShadersProgram)
 		{
 			drawMode = GL_LINE_STRIP;
-			bufferDataUsage = GL_DYNAMIC_DRAW;
+			bufferDataUsage = GL_STREAM_DRAW;
 		}
 
 		std::function<std::vector<glm::vec3>(const glm::vec3&, const glm::vec3&)> segmentVerticesGenerator;
@@ -43,26 +43,19 @@ namespace Components
 
 		std::vector<glm::vec3> getPositions(bool transformed = false) const override
 		{
-			auto vertices = transformed
-				? Tools::TransformMat4(Tools::GetVertices(*body), modelMatrixF())
-				: Tools::GetVertices(*body);
+			if (transformed)
+				return generatePositions(Tools::TransformMat4(Tools::GetVertices(*body), modelMatrixF()));
 
-			if ((!segmentVerticesGenerator && !keyVerticesTransformer) || vertices.empty())
-				return vertices;
-			
-			std::vector<glm::vec3> customVertices;
+			if (isGeometryVolatile())
+				return generatePositions(Tools::GetVertices(*body));
 
-			// Box2d keeps body's fixture in reversed order.
-			if (keyVerticesTransformer)
-				keyVerticesTransformer(vertices);
-
-			for (auto it = vertices.begin(); it != vertices.end() - 1; ++it)
+			if (cachedPositionsVersion != fixturesVersion)
 			{
-				auto segmentVertices = segmentVerticesGenerator(*it, *(it + 1));
-				customVertices.insert(customVertices.end(), segmentVertices.begin(), segmentVertices.end());
+				cachedPositions = Tools::GetVertices(*body);
+				cachedPositionsVersion = fixturesVersion;
 			}
 
-			return customVertices;
+			return cachedPositions;
 		}
 
 		const std::vector<glm::vec2> getTexCoords(bool = false) const override
@@ -75,8 +68,26 @@ namespace Components
 			if (stepF)
 				stepF();
 
-			if (loaded.buffers)
-				loaded.buffers->setPositionsBuffer(getPositions());
+			if (!loaded.buffers)
+				return;
+
+			// Streamed buffers are reapplied with the whole component every frame.
+			if (loaded.buffers->isAnyPartStreamActive())
+			{
+				Buffers::CountUpload(true);
+				return;
+			}
+
+			if (!isGeometryVolatile() && uploadedPositionsVersion == fixturesVersion && uploadedBuffers == loaded.buffers)
+			{
+				Buffers::CountUpload(false);
+				return;
+			}
+
+			loaded.buffers->setPositionsBuffer(getPositions());
+			uploadedPositionsVersion = isGeometryVolatile() ? std::nullopt : std::optional(fixturesVersion);
+			uploadedBuffers = loaded.buffers;
+			Buffers::CountUpload(true);
 		}
 
 		void replaceFixtures(const std::vector<glm::vec2>& vertices, const Tools::BodyParams& bodyParams = Tools::BodyParams{}.sensor(true))
@@ -85,6 +96,43 @@ namespace Components
 			if (vertices.size() > 1)
 				Tools::CreatePolylineFixtures(body, vertices, bodyParams);
 			Tools::SetCollisionFilteringBits(*body, Globals::CollisionBits::polyline, Globals::CollisionBits::all);
+			++fixturesVersion;
+		}
+
+		// Generators and transformers may be non-deterministic (e.g. lightnings), so their output is regenerated every frame.
+		// Only such geometry is streamed, others stay in own buffers and are uploaded when fixtures change.
+		bool isGeometryVolatile() const
+		{
+			return segmentVerticesGenerator || keyVerticesTransformer;
 		}
+
+		// Has to be increased if fixtures are modified without replaceFixtures(), so cached geometry is regenerated.
+		unsigned fixturesVersion = 0;
+
+	private:
+		std::vector<glm::vec3> generatePositions(std::vector<glm::vec3> vertices) const
+		{
+			if ((!segmentVerticesGenerator && !keyVerticesTransformer) || vertices.empty())
+				return vertices;
+
+			std::vector<glm::vec3> customVertices;
+
+			// Box2d keeps body's fixture in reversed order.
+			if (keyVerticesTransformer)
+				keyVerticesTransformer(vertices);
+
+			for (auto it = vertices.begin(); it != vertices.end() - 1; ++it)
+			{
+				auto segmentVertices = segmentVerticesGenerator(*it, *(it + 1));
+				customVertices.insert(customVertices.end(), segmentVertices.begin(), segmentVertices.end());
+			}
+
+			return customVertices;
+		}
+
+		mutable std::vector<glm::vec3> cachedPositions;
+		mutable std::optional<unsigned> cachedPositionsVersion;
+		std::optional<unsigned> uploadedPositionsVersion;
+		const Buffers::GenericBuffers* uploadedBuffers = nullptr;
 	};
 }
@@ -3,6 +3,8 @@
 #include "_componentBase.hpp"
 
 #include <ogl/buffers/genericBuffers.hpp>
+#include <ogl/buffers/autoInstancingBuffers.hpp>
+#include <ogl/buffers/streamingBuffer.hpp>
 
 #include <commonTypes/buffersCollections.hpp>
 
@@ -19,5 +21,7 @@ namespace Components
 		BuffersColections<std::unordered_map<ComponentId, Buffers::GenericBuffers>> dynamicOfflineBuffers;
 		std::deque<Buffers::GenericBuffers> staticTFBuffers;
 		std::unordered_map<ComponentId, Buffers::GenericBuffers> dynamicTFBuffers;
+		Buffers::AutoInstancingBuffers autoInstancingBuffers;
+		Buffers::StreamingBuffer streamingBuffer;
 	};
 }
@@ -2,10 +2,14 @@
 
 #include "_componentBase.hpp"
 
+#include "physics.hpp"
+
 #include <tools/b2Helpers.hpp>
 #include <tools/utility.hpp>
+#include <tools/discBodiesPool.hpp>
 
 #include <globals/collisionBits.hpp>
+#include <globals/components.hpp>
 
 #include <Box2D/Box2D.h>
 
@@ -21,24 +25,31 @@ namespace Components
 	{
 		Shockwave(glm::vec2 center, glm::vec2 sourceVelocity, int numOfParticles, float initExplosionVelocity, float initExplosionVelocityRandomMinFactor,
 			float particlesRadius, float particlesDensity, float particlesLinearDamping, bool particlesAsBullets, bool particlesAsSensors):
-			center(center)
+			center(center),
+			particlesPool(Globals::Components().physics().shockwaveParticlesPool)
 		{
 			float angle = Tools::RandomFloat(0.0f, glm::two_pi<float>());
 			const float angleStep = glm::two_pi<float>() / numOfParticles;
+			particles.reserve(numOfParticles);
 			for (int i = 0; i < numOfParticles; ++i)
 			{
-				particles.push_back(Tools::CreateDiscBody(particlesRadius,
-					Tools::BodyParams().position(center).bodyType(b2_dynamicBody).density(particlesDensity).sensor(particlesAsSensors)));
-				particles.back()->SetBullet(particlesAsBullets);
-				particles.back()->SetLinearVelocity(ToVec2<b2Vec2>(sourceVelocity + glm::vec2(glm::cos(angle), glm::sin(angle)) * initExplosionVelocity *
-					Tools::RandomFloat(initExplosionVelocityRandomMinFactor, 1.0f)));
-				particles.back()->SetLinearDamping(particlesLinearDamping);
+				particles.push_back(particlesPool.acquire(particlesRadius, Tools::BodyParams().position(center).bodyType(b2_dynamicBody).density(particlesDensity)
+					.sensor(particlesAsSensors).bullet(particlesAsBullets).linearDamping(particlesLinearDamping)
+					.velocity(sourceVelocity + glm::vec2(glm::cos(angle), glm::sin(angle)) * initExplosionVelocity * Tools::RandomFloat(initExplosionVelocityRandomMinFactor, 1.0f))));
 				angle += angleStep;
 			}
 		}
 
+		~Shockwave()
+		{
+			// Pool is kept instead of accessing it through globals, as shockwaves are also destroyed along with all components.
+			for (auto& particle : particles)
+				particlesPool.release(std::move(particle));
+		}
+
 		const glm::vec2 center;
 		std::vector<Body> particles;
+		Tools::DiscBodiesPool& particlesPool;
 
 		void init(ComponentId id, bool static_) override
 		{
@@ -39,6 +39,7 @@ namespace Components
 		struct Limits
 		{
 			int maxTextureUnits{ 0 };
+			int maxTextureSize{ 0 };
 		} limits;
 	};
 }
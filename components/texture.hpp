@@ -14,7 +14,9 @@
 #include <vector>
 #include <variant>
 #include <functional>
+#include <future>
 #include <optional>
+#include <utility>
 
 namespace Components
 {
@@ -42,6 +44,8 @@ namespace Components
 		glm::vec2 scale{ 1.0f };
 		bool preserveAspectRatio = false;
 		glm::vec4 borderColor{ 0.0f };
+		// Static file texture may be packed into a shared atlas page, if its sampling is clamped. Not for textures bound directly by custom shaders.
+		bool atlasPacking = false;
 
 		std::function<std::pair<glm::ivec2, glm::ivec2>(glm::ivec2)> sourceFragmentCornerAndSizeF;
 		std::function<TextureSubData()> subImagesF;
@@ -52,6 +56,12 @@ namespace Components
 
 			glm::ivec2 size = { 0, 0 };
 			int numOfChannels = 0;
+			GLint internalFormat = 0;
+			// Normalized corner and size of the region within the atlas page bound as the texture object.
+			std::optional<std::pair<glm::vec2, glm::vec2>> atlasRegion;
+
+			// Pending decoding of the file source. Placeholder texel or previous content is bound until it's uploaded.
+			std::shared_future<void> decoding;
 
 			GLint getFormat() const
 			{
@@ -38,6 +38,7 @@
 #include <components/appStateHandler.hpp>
 
 #include "componentIdGenerator.hpp"
+#include "frameArena.hpp"
 
 namespace Globals
 {
@@ -341,6 +342,7 @@ namespace Globals
 	void InitializeComponents()
 	{
 		InitializeComponentIdGenerator();
+		InitializeFrameArena();
 		componentsHolder = std::make_unique<ComponentsHolder>();
 	}
 
@@ -0,0 +1,20 @@
+#include "frameArena.hpp"
+
+#include <commonTypes/frameArena.hpp>
+
+#include <memory>
+
+namespace Globals
+{
+	static std::unique_ptr<::FrameArena> frameArena;
+
+	void InitializeFrameArena()
+	{
+		frameArena = std::make_unique<::FrameArena>();
+	}
+
+	::FrameArena& FrameArena()
+	{
+		return *frameArena;
+	}
+}
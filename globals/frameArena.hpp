@@ -0,0 +1,9 @@
+#pragma once
+
+class FrameArena;
+
+namespace Globals
+{
+	void InitializeFrameArena();
+	FrameArena& FrameArena();
+}
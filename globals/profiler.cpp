@@ -0,0 +1,25 @@
+#include "profiler.hpp"
+
+#include <commonTypes/profiler.hpp>
+
+#include <memory>
+
+namespace Globals
+{
+	static std::unique_ptr<::Profiler> profiler;
+
+	void InitializeProfiler()
+	{
+		profiler = std::make_unique<::Profiler>();
+	}
+
+	void DestroyProfiler()
+	{
+		profiler.reset();
+	}
+
+	::Profiler& Profiler()
+	{
+		return *profiler;
+	}
+}
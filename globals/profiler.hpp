@@ -0,0 +1,10 @@
+#pragma once
+
+class Profiler;
+
+namespace Globals
+{
+	void InitializeProfiler();
+	void DestroyProfiler();
+	Profiler& Profiler();
+}
@@ -4,6 +4,7 @@
 
 namespace ShadersUtils::Programs
 {
+	struct Phong3DFrameBlock;
 	struct BasicPhong;
 	struct TexturedPhong;
 	struct Basic;
@@ -37,8 +38,9 @@ namespace Globals
 		void frameSetup();
 
 	private:
-		std::unique_ptr<ShadersUtils::Programs::BasicPhong> basicPhong_ = std::make_unique<ShadersUtils::Programs::BasicPhong>();
-		std::unique_ptr<ShadersUtils::Programs::TexturedPhong> texturedPhong_ = std::make_unique<ShadersUtils::Programs::TexturedPhong>();
+		std::unique_ptr<ShadersUtils::Programs::Phong3DFrameBlock> phong3DFrameBlock_ = std::make_unique<ShadersUtils::Programs::Phong3DFrameBlock>();
+		std::unique_ptr<ShadersUtils::Programs::BasicPhong> basicPhong_ = std::make_unique<ShadersUtils::Programs::BasicPhong>(*phong3DFrameBlock_);
+		std::unique_ptr<ShadersUtils::Programs::TexturedPhong> texturedPhong_ = std::make_unique<ShadersUtils::Programs::TexturedPhong>(*phong3DFrameBlock_);
 		std::unique_ptr<ShadersUtils::Programs::Basic> basic_ = std::make_unique<ShadersUtils::Programs::Basic>();
 		std::unique_ptr<ShadersUtils::Programs::Julia> julia_ = std::make_unique<ShadersUtils::Programs::Julia>();
 		std::unique_ptr<ShadersUtils::Programs::Billboards> billboards_ = std::make_unique<ShadersUtils::Programs::Billboards>();
@@ -0,0 +1,25 @@
+#include "threadPool.hpp"
+
+#include <commonTypes/threadPool.hpp>
+
+#include <memory>
+
+namespace Globals
+{
+	static std::unique_ptr<::ThreadPool> threadPool;
+
+	void InitializeThreadPool()
+	{
+		threadPool = std::make_unique<::ThreadPool>();
+	}
+
+	void DestroyThreadPool()
+	{
+		threadPool.reset();
+	}
+
+	::ThreadPool& ThreadPool()
+	{
+		return *threadPool;
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+class ThreadPool;
+
+namespace Globals
+{
+	void InitializeThreadPool();
+	void DestroyThreadPool();
+	ThreadPool& ThreadPool();
+}
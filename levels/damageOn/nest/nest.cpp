@@ -21,6 +21,8 @@
 #include <components/mainFramebufferRenderer.hpp>
 #include <globals/components.hpp>
 
+#include <commonTypes/frameArena.hpp>
+
 #include <systems/textures.hpp>
 #include <globals/systems.hpp>
 
@@ -32,6 +34,7 @@
 #include <tools/gameHelpers.hpp>
 #include <tools/particleSystemHelpers.hpp>
 #include <tools/glmHelpers.hpp>
+#include <tools/spatialHash.hpp>
 
 #include <ogl/uniformsUtils.hpp>
 #include <ogl/renderingHelpers.hpp>
@@ -134,6 +137,7 @@ namespace Levels::DamageOn
 			//textures.last().scale = glm::vec2(30.0f);
 
 			embryoTextureId = staticTextures.emplace("textures/damageOn/embryo.png").getComponentId();
+			staticTextures.last().atlasPacking = true;
  
 			fogTextureId = staticTextures.emplace("textures/damageOn/fog.png", GL_REPEAT).getComponentId();
 			staticTextures.last().scale = glm::vec2(0.15f);
@@ -145,6 +149,7 @@ namespace Levels::DamageOn
 
 			jetfireAnimationTextureId = staticTextures.emplace("textures/damageOn/jetfire.png").getComponentId();
 			staticTextures.last().minFilter = GL_LINEAR;
+			staticTextures.last().atlasPacking = true;
 
 			jetfireAnimatedTextureId = staticAnimatedTextures.add({ CM::Texture(jetfireAnimationTextureId, true), { 992, 1019 }, { 8, 8 }, { 0, 0 }, 897, 895, { 88, 125 }, 0.1f, 64, 0,
 					AnimationData::Direction::Forward, AnimationData::Mode::Repeat, AnimationData::TextureLayout::Horizontal }).getComponentId();
@@ -212,6 +217,9 @@ namespace Levels::DamageOn
 			auto& dynamicDecorations = Globals::Components().decorations();
 			auto& dynamicTextures = Globals::Components().textures();
 			auto& physics = Globals::Components().physics();
+			// Explosions produce bursts of shockwave particles contacts and chain explosions of bodies.
+			physics.batchedContacts = true;
+			physics.shockwaveParticlesPool.preallocate(2048);
 
 			const glm::vec2 levelHSize(dynamicTextures[backgroundTextureId].loaded.getAspectRatio() * levelParams.mapHHeight, levelParams.mapHHeight);
 
@@ -302,10 +310,6 @@ namespace Levels::DamageOn
 
 		void step()
 		{
-			postSteps.clear();
-			deferredWeaponsSteps.clear();
-			deferredWeaponsPostSteps.clear();
-
 			const auto& keyboard = Globals::Components().keyboard();
 			const auto& mouse = Globals::Components().mouse();
 			const auto& physics = Globals::Components().physics();
@@ -334,6 +338,10 @@ namespace Levels::DamageOn
 				type.cache.decoration.state = ComponentState::Changed;
 			}
 
+			enemiesSpatialHash.clear();
+			for (auto& [enemyId, enemyInst] : enemyGameComponents.idsToInst)
+				enemiesSpatialHash.insert(enemyInst.actor.getOrigin2D(), enemyInst.radius, &enemyInst);
+
 			for (auto& [playerId, playerInst]: playerGameComponents.idsToInst)
 			{
 				const bool keyboardApplying = gameParams.gamepad.firstPlayer ? true : playerInst.playerNum == 0;
@@ -479,29 +487,34 @@ namespace Levels::DamageOn
 					weaponsPostStep(playerInst);
 				});
 
-				std::multimap<float, EnemyType::Inst*> enemiesByDistance;
-				for (auto& [enemyId, enemyInst] : enemyGameComponents.idsToInst)
-					enemiesByDistance.emplace(glm::distance(getWeaponSourcePoint(playerInst), enemyInst.actor.getOrigin2D()), &enemyInst);
-
+				// Only enemies within weapons range can be shot, and as the nearest ones, their sequence numbers are the same as if all enemies were sorted.
+				// Deaths of the rest are handled by enemiesDeathStep().
 				const auto weaponSourcePoint = getWeaponSourcePoint(playerInst);
+				enemiesSpatialHash.queryRadius(weaponSourcePoint, getMaxWeaponDistance(playerInst), enemiesInRange);
+
 				const unsigned seed = randomDevice();
-				auto enemySeqsByDistance = std::make_shared<std::multimap<float, int>>();
-				auto aimedEnemySeqsByDistance = std::make_shared<std::multimap<float, int>>();
+				auto* enemySeqsByDistance = &Globals::FrameArena().create<FrameMultimap<float, int>>();
+				auto* aimedEnemySeqsByDistance = &Globals::FrameArena().create<FrameMultimap<float, int>>();
 				int enemySeq = 0;
 				int aimedEnemySeq = 0;
-				for (auto& [distance, enemyInst] : enemiesByDistance)
+
+				// Aiming at any enemy, even out of range, disables combined weapons for automatic targets.
+				const bool anyAimedEnemy = playerInst.aiming && !enemiesInRange.empty()
+					&& enemiesSpatialHash.anyInCone(weaponSourcePoint, playerInst.aimingD1, playerInst.aimingD2);
+
+				for (const auto& [enemyEntry, distance] : enemiesInRange)
 				{
+					auto* enemyInst = enemyEntry->value;
+
 					enemySeqsByDistance->emplace(distance, enemySeq);
-					deferredWeaponsSteps.push_back([&, &enemyInst = *enemyInst, enemySeq, enemySeqsByDistance, aimedEnemySeq, aimedEnemySeqsByDistance, seed]() {
+					deferredWeaponsSteps.push_back([&, &enemyInst = *enemyInst, enemySeq, enemySeqsByDistance, anyAimedEnemy, seed]() {
 						weaponsStep(playerInst, enemyInst, enemySeq, *enemySeqsByDistance, seed, WeaponType::Aiming::Auto);
-						if (aimedEnemySeqsByDistance->empty())
+						if (!anyAimedEnemy)
 							weaponsStep(playerInst, enemyInst, enemySeq, *enemySeqsByDistance, seed, WeaponType::Aiming::Combined);
 					});
 					++enemySeq;
 
-					if (playerInst.aiming && (Tools::IsPointBetweenVectors(enemyInst->actor.getOrigin2D(), weaponSourcePoint, playerInst.aimingD1, playerInst.aimingD2) ||
-						Tools::DoesRayIntersectCircle(weaponSourcePoint, playerInst.aimingD1, enemyInst->actor.getOrigin2D(), enemyInst->radius) ||
-						Tools::DoesRayIntersectCircle(weaponSourcePoint, playerInst.aimingD2, enemyInst->actor.getOrigin2D(), enemyInst->radius)))
+					if (playerInst.aiming && EnemiesSpatialHash::IsInCone(weaponSourcePoint, playerInst.aimingD1, playerInst.aimingD2, *enemyEntry))
 					{
 						aimedEnemySeqsByDistance->emplace(distance, aimedEnemySeq);
 						deferredWeaponsSteps.push_back([&, &enemyInst = *enemyInst, aimedEnemySeq, aimedEnemySeqsByDistance, seed]() {
@@ -529,7 +542,7 @@ namespace Levels::DamageOn
 					weaponsPostStep(enemyInst);
 				});
 
-				std::multimap<float, PlayerType::Inst*> playersByDistance;
+				FrameMultimap<float, PlayerType::Inst*> playersByDistance;
 				for (auto& [playerId, playerInst]: playerGameComponents.idsToInst)
 					playersByDistance.emplace(glm::distance(getWeaponSourcePoint(enemyInst), playerInst.actor.getOrigin2D()), &playerInst);
 
@@ -556,7 +569,7 @@ namespace Levels::DamageOn
 				}
 				
 				const unsigned seed = randomDevice();
-				auto playerSeqsByDistance = std::make_shared<std::multimap<float, int>>();
+				auto* playerSeqsByDistance = &Globals::FrameArena().create<FrameMultimap<float, int>>();
 				int playerSeq = 0;
 				for (auto& [distance, playerInst] : playersByDistance)
 				{
@@ -579,10 +592,16 @@ namespace Levels::DamageOn
 
 			for (auto& deferredWeaponsStep : deferredWeaponsSteps)
 				deferredWeaponsStep();
+			enemiesDeathStep();
 			for (auto& deferredWeaponsPostStep : deferredWeaponsPostSteps)
 				deferredWeaponsPostStep();
 			for (auto& postStep : postSteps)
 				postStep();
+
+			// Cleared here rather than at the beginning of the step, because closures may reference the frame arena, which is reset in the step teardown.
+			postSteps.clear();
+			deferredWeaponsSteps.clear();
+			deferredWeaponsPostSteps.clear();
 		}
 
 	private:
@@ -1200,11 +1219,8 @@ namespace Levels::DamageOn
 
 		void weaponsStep(auto& sourceInst, auto& targetInst, int targetSeq, const auto& targetSeqsByDistance, unsigned seed, WeaponType::Aiming aiming)
 		{
-			static constexpr bool playerTarget = std::is_same_v<std::remove_cvref_t<decltype(targetInst)>, PlayerType::Inst>;
-
 			const auto& physics = Globals::Components().physics();
 			const auto& sourceActor = sourceInst.actor;
-			auto& targetType = targetInst.type;
 			auto& targetActor = targetInst.actor; 
 
 			if (sourceActor.isEnabled() && targetActor.isEnabled())
@@ -1286,6 +1302,16 @@ namespace Levels::DamageOn
 				}
 			}
 
+			deathStep(targetInst);
+		}
+
+		void deathStep(auto& targetInst)
+		{
+			static constexpr bool playerTarget = std::is_same_v<std::remove_cvref_t<decltype(targetInst)>, PlayerType::Inst>;
+
+			auto& targetType = targetInst.type;
+			auto& targetActor = targetInst.actor;
+
 			if (targetInst.hp <= 0.0f && targetActor.isEnabled())
 			{
 				const float basePitch = [&]() {
@@ -1331,6 +1357,20 @@ namespace Levels::DamageOn
 			}
 		}
 
+		void enemiesDeathStep()
+		{
+			for (const auto& entry : enemiesSpatialHash.getEntries())
+				deathStep(*entry.value);
+		}
+
+		float getMaxWeaponDistance(const auto& inst) const
+		{
+			float maxDistance = 0.0f;
+			for (auto weaponId : inst.weaponIds)
+				maxDistance = std::max(maxDistance, weaponGameComponents.idsToInst.at(weaponId).type.init.distance);
+			return maxDistance;
+		}
+
 		void sparkingHandler(const auto& sourceInst, auto& targetInst, auto& weaponInst, float distance)
 		{
 			const auto& physics = Globals::Components().physics();
@@ -2217,9 +2257,9 @@ namespace Levels::DamageOn
 		GameComponents<PlayerType> playerGameComponents;
 		GameComponents<EnemyType> enemyGameComponents;
 
-		std::vector<std::function<void()>> deferredWeaponsSteps;
-		std::vector<std::function<void()>> deferredWeaponsPostSteps;
-		std::vector<std::function<void()>> postSteps;
+		std::vector<FrameFunction<void()>> deferredWeaponsSteps;
+		std::vector<FrameFunction<void()>> deferredWeaponsPostSteps;
+		std::vector<FrameFunction<void()>> postSteps;
 
 		std::unordered_set<ComponentId> playerSourceExplosions;
 		std::unordered_set<ComponentId> enemySourceExplosions;
@@ -2234,6 +2274,10 @@ namespace Levels::DamageOn
 			std::shared_ptr<Tools::SoundsLimitter> kills = Tools::SoundsLimitter::create(8);
 		} playerSoundLimitters, enemieSoundLimitters;
 
+		using EnemiesSpatialHash = Tools::SpatialHash<EnemyType::Inst*>;
+		EnemiesSpatialHash enemiesSpatialHash{ 10.0f };
+		std::vector<EnemiesSpatialHash::QueryResult> enemiesInRange;
+
 		std::vector<int> shuffledTargetSeqsInRange;
 		std::unordered_map<int, int> shuffledInRangeTargetSeqsMapping;
 
@@ -14,8 +14,7 @@
 
 #include <tools/Shapes2D.hpp>
 #include <tools/colorBufferEditor.hpp>
-
-#include <execution>
+#include <tools/parallelFor.hpp>
 
 namespace
 {
@@ -183,25 +182,23 @@ namespace Levels
 		{
 			const auto& physics = Globals::Components().physics();
 			const float neighborsColorFactor = 1.0f - centerColorFactor;
-			auto innerLoop = [&](const auto y) {
-				for (int x = 0; x < colorBuffer.getRes().x; ++x)
-				{
-					const glm::ivec2 d = Tools::StableRandom::Std3Random::HashRange({ range.x, range.x }, { range.y, range.y }, glm::ivec3(x, y, physics.frameCount));
-					const glm::vec3 newColor = colorBuffer.getColor({ x, y }) * centerColorFactor +
-						(colorBuffer.getColor({ x - d.x, y - d.y }) + colorBuffer.getColor({ x, y - d.y }) + colorBuffer.getColor({ x + d.x, y - d.y }) + colorBuffer.getColor({ x - d.x, y }) + colorBuffer.getColor({ x + d.x, y }) +
-							colorBuffer.getColor({ x - d.x, y + d.y }) + colorBuffer.getColor({ x, y + d.y }) + colorBuffer.getColor({ x + d.x, y + d.y })) / 8.0f * neighborsColorFactor;
-					colorBuffer.putColor({ x, y }, newColor);
-				}
+			// Tiles keep neighbors' rows in cache.
+			auto processTile = [&](const glm::ivec2 tileBegin, const glm::ivec2 tileEnd) {
+				for (int y = tileBegin.y; y < tileEnd.y; ++y)
+					for (int x = tileBegin.x; x < tileEnd.x; ++x)
+					{
+						const glm::ivec2 d = Tools::StableRandom::Std3Random::HashRange({ range.x, range.x }, { range.y, range.y }, glm::ivec3(x, y, physics.frameCount));
+						const glm::vec3 newColor = colorBuffer.getColor({ x, y }) * centerColorFactor +
+							(colorBuffer.getColor({ x - d.x, y - d.y }) + colorBuffer.getColor({ x, y - d.y }) + colorBuffer.getColor({ x + d.x, y - d.y }) + colorBuffer.getColor({ x - d.x, y }) + colorBuffer.getColor({ x + d.x, y }) +
+								colorBuffer.getColor({ x - d.x, y + d.y }) + colorBuffer.getColor({ x, y + d.y }) + colorBuffer.getColor({ x + d.x, y + d.y })) / 8.0f * neighborsColorFactor;
+						colorBuffer.putColor({ x, y }, newColor);
+					}
 				};
 
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
-			{
-				Tools::ItToId itToId(colorBuffer.getRes().y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), innerLoop);
-			}
+				Tools::ParallelFor2D({ 0, 0 }, colorBuffer.getRes(), { 64, 64 }, processTile);
 			else
-				for (int y = 0; y < colorBuffer.getRes().y; ++y)
-					innerLoop(y);
+				processTile({ 0, 0 }, colorBuffer.getRes());
 		}
 
 		void flames(auto& colorBuffer, float newColorFactor = 0.249f, glm::vec3 initRgbMin = glm::vec3(-200), glm::vec3 initRgbMax = glm::vec3(200))
@@ -218,10 +215,7 @@ namespace Levels
 			};
 
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
-			{
-				Tools::ItToId itToId(1, colorBuffer.getRes().y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), innerLoop);
-			}
+				Tools::ParallelFor(1, colorBuffer.getRes().y, 0, innerLoop);
 			else
 				for (int y = 1; y < colorBuffer.getRes().y; ++y)
 					innerLoop(y);
@@ -262,13 +256,10 @@ namespace Levels
 		void none(auto& colorBuffer)
 		{
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
-			{
-				Tools::ItToId itToId(colorBuffer.getRes().y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), [&](const auto y) {
+				Tools::ParallelFor(0, colorBuffer.getRes().y, 0, [&](const auto y) {
 					for (int x = 0; x < colorBuffer.getRes().x; ++x)
 						colorBuffer.putColor({ x, y }, colorBuffer.getColor({ x, y }));
 				});
-			}
 		}
 
 		ComponentId mainTextureId{};
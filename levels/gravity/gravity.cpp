@@ -86,6 +86,7 @@ namespace Levels
 			flame1AnimationTexture = textures.size();
 			textures.emplace("textures/flame animation 1.jpg");
 			textures.last().minFilter = GL_LINEAR;
+			textures.last().atlasPacking = true;
 
 			missile1Texture = textures.size();
 			textures.emplace("textures/missile 1.png");
@@ -178,7 +179,7 @@ namespace Levels
 				Globals::Components().staticWalls().emplace(
 					Tools::CreateBoxBody({ Tools::RandomFloat(0.1f, 1.0f), Tools::RandomFloat(0.1f, 1.0f) },
 						Tools::BodyParams().position(pos).angle(angle).bodyType(b2_dynamicBody).density(0.02f)),
-					CM::Texture(spaceRockTexture, true));
+					CM::Texture(spaceRockTexture, true)).orderIndependent = true;
 			}
 
 			debrisEnd = Globals::Components().staticWalls().size();
@@ -211,6 +212,9 @@ namespace Levels
 
 		void setCollisionCallbacks()
 		{
+			// Enough for a few simultaneous missile explosions.
+			Globals::Components().physics().shockwaveParticlesPool.preallocate(512);
+
 			Globals::Components().beginCollisionHandlers().emplace(Globals::CollisionBits::projectile, Globals::CollisionBits::all,
 				[this](const auto& fixtureA, const auto& fixtureB) {
 					for (const auto* fixture : { &fixtureA, &fixtureB })
@@ -13,8 +13,7 @@
 #include <tools/Shapes2D.hpp>
 #include <tools/colorBufferEditor.hpp>
 #include <tools/utility.hpp>
-
-#include <execution>
+#include <tools/parallelFor.hpp>
 
 namespace
 {
@@ -124,26 +123,23 @@ namespace Levels
 		{
 			const auto& physics = Globals::Components().physics();
 			const float neighborsColorFactor = 1.0f - centerColorFactor;
-			auto innerLoop = [&](const auto y_) {
-				const int y = (int)y_;
-				for (int x = 0; x < colorBuffer.getRes().x; ++x)
-				{
-					const glm::ivec2 d = Tools::StableRandom::Std3Random::HashRange(glm::ivec2(range.x, range.x), glm::ivec2(range.y, range.y), glm::ivec3(x, y, physics.frameCount));
-					const glm::vec3 newColor = colorBuffer.getColor({ x, y }) * centerColorFactor +
-						(colorBuffer.getColor({ x - d.x, y - d.y }) + colorBuffer.getColor({ x, y - d.y }) + colorBuffer.getColor({ x + d.x, y - d.y }) + colorBuffer.getColor({ x - d.x, y }) + colorBuffer.getColor({ x + d.x, y }) +
-							colorBuffer.getColor({ x - d.x, y + d.y }) + colorBuffer.getColor({ x, y + d.y }) + colorBuffer.getColor({ x + d.x, y + d.y })) / 8.0f * neighborsColorFactor;
-					colorBuffer.putColor({ x, y }, newColor);
-				}
+			// Tiles keep neighbors' rows in cache.
+			auto processTile = [&](const glm::ivec2 tileBegin, const glm::ivec2 tileEnd) {
+				for (int y = tileBegin.y; y < tileEnd.y; ++y)
+					for (int x = tileBegin.x; x < tileEnd.x; ++x)
+					{
+						const glm::ivec2 d = Tools::StableRandom::Std3Random::HashRange(glm::ivec2(range.x, range.x), glm::ivec2(range.y, range.y), glm::ivec3(x, y, physics.frameCount));
+						const glm::vec3 newColor = colorBuffer.getColor({ x, y }) * centerColorFactor +
+							(colorBuffer.getColor({ x - d.x, y - d.y }) + colorBuffer.getColor({ x, y - d.y }) + colorBuffer.getColor({ x + d.x, y - d.y }) + colorBuffer.getColor({ x - d.x, y }) + colorBuffer.getColor({ x + d.x, y }) +
+								colorBuffer.getColor({ x - d.x, y + d.y }) + colorBuffer.getColor({ x, y + d.y }) + colorBuffer.getColor({ x + d.x, y + d.y })) / 8.0f * neighborsColorFactor;
+						colorBuffer.putColor({ x, y }, newColor);
+					}
 			};
 
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
-			{
-				Tools::ItToId itToId(colorBuffer.getRes().y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), innerLoop);
-			}
+				Tools::ParallelFor2D({ 0, 0 }, colorBuffer.getRes(), { 64, 64 }, processTile);
 			else
-				for (int y = 0; y < colorBuffer.getRes().y; ++y)
-					innerLoop(y);
+				processTile({ 0, 0 }, colorBuffer.getRes());
 
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
 				editor->swapBuffers(false);
@@ -163,10 +159,7 @@ namespace Levels
 			};
 
 			if constexpr (ColorBufferEditor::IsDoubleBuffering())
-			{
-				Tools::ItToId itToId(1, colorBuffer.getRes().y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), innerLoop);
-			}
+				Tools::ParallelFor(1, colorBuffer.getRes().y, 0, innerLoop);
 			else
 				for (int y = 1; y < colorBuffer.getRes().y; ++y)
 					innerLoop(y);
@@ -453,14 +453,14 @@ namespace Levels
 					particlesInstance.customShadersProgram = &billboardsShader;
 					particlesInstance.renderingSetupF = [&](auto&) mutable -> std::function<void()> {
 						billboardsShader.vp(Globals::Components().vpDefault2D().getVP());
-						glActiveTexture(GL_TEXTURE0);
-						glBindTexture(GL_TEXTURE_2D, explosionTexture.component->loaded.textureObject);
+						glProxyActiveTexture(GL_TEXTURE0);
+						glProxyBindTexture(GL_TEXTURE_2D, explosionTexture.component->loaded.textureObject);
 						billboardsShader.texture0(0);
 
 						if (params.blendMode == Params::BlendMode::Additive)
 						{
-							glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-							return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+							glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
+							return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 						}
 
 						return nullptr;
@@ -471,8 +471,8 @@ namespace Levels
 					particlesInstance.renderingSetupF = [&](auto&) mutable -> std::function<void()> {
 						if (params.blendMode == Params::BlendMode::Additive)
 						{
-							glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-							return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+							glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
+							return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 						}
 
 						return nullptr;
@@ -487,8 +487,8 @@ namespace Levels
 
 						if (params.blendMode == Params::BlendMode::Additive)
 						{
-							glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-							return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+							glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
+							return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 						}
 
 						return nullptr;
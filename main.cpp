@@ -49,10 +49,17 @@
 #include "globals/shaders.hpp"
 #include "globals/components.hpp"
 #include "globals/systems.hpp"
+#include "globals/threadPool.hpp"
+#include "globals/profiler.hpp"
+
+#include "commonTypes/profiler.hpp"
 
 #include "ogl/oglHelpers.hpp"
 
 #include "tools/utility.hpp"
+#include "tools/frameBenchmark.hpp"
+#include "tools/texelKernels.hpp"
+#include "tools/systemsScheduler.hpp"
 
 #include <SDL.h>
 
@@ -71,6 +78,10 @@
 #include <type_traits>
 #include <thread>
 #include <iostream>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <algorithm>
 
 const bool debugFullscreen = false;
 const bool releaseFullscreen = true;
@@ -101,19 +112,144 @@ debugFullscreen;
 releaseFullscreen;
 #endif
 
+struct BenchmarkScenario
+{
+	const char* name;
+	std::function<std::unique_ptr<Levels::Level>()> createLevel;
+	unsigned defaultFrames;
+	int fixedRate;
+};
+
+const std::array benchmarkScenarios = {
+	BenchmarkScenario{ "gravity", []() { return std::make_unique<Levels::Gravity>(); }, 3600, 60 },
+	BenchmarkScenario{ "nest", []() { return std::make_unique<Levels::DamageOn::Nest>(); }, 3600, 60 },
+	BenchmarkScenario{ "playground", []() { return std::make_unique<Levels::Playground>(); }, 3600, 60 }
+};
+
 std::unique_ptr<Levels::Level> activeLevel;
+std::unique_ptr<Tools::FrameBenchmark> frameBenchmark;
+const BenchmarkScenario* activeBenchmarkScenario = nullptr;
+std::unique_ptr<Tools::SystemsScheduler> systemsScheduler;
+bool serialSystems = false;
+bool profile = false;
+bool benchmarkTexelKernels = false;
+
+// Usage: [--serial-systems] [--profile] [--benchmark <gravity|nest|playground> [frames]] [--benchmark-texel-kernels]
+static void ParseCommandLine(const std::string& commandLine)
+{
+	std::istringstream commandLineStream(commandLine);
+	std::string arg;
+
+	while (commandLineStream >> arg)
+	{
+		if (arg == "--serial-systems")
+		{
+			serialSystems = true;
+			continue;
+		}
+
+		if (arg == "--profile")
+		{
+			profile = true;
+			continue;
+		}
+
+		if (arg == "--benchmark-texel-kernels")
+		{
+			benchmarkTexelKernels = true;
+			continue;
+		}
+
+		if (arg != "--benchmark")
+			continue;
+
+		std::string scenarioName;
+		commandLineStream >> scenarioName;
+
+		auto scenarioIt = std::find_if(benchmarkScenarios.begin(), benchmarkScenarios.end(), [&](const auto& scenario) {
+			return scenario.name == scenarioName;
+		});
+		if (scenarioIt == benchmarkScenarios.end())
+			throw std::runtime_error("Unknown benchmark scenario: " + scenarioName + ".");
+
+		unsigned frames = scenarioIt->defaultFrames;
+		if (commandLineStream >> frames; commandLineStream.fail())
+		{
+			commandLineStream.clear();
+			frames = scenarioIt->defaultFrames;
+		}
+
+		activeBenchmarkScenario = &*scenarioIt;
+		frameBenchmark = std::make_unique<Tools::FrameBenchmark>(scenarioIt->name, frames, 1.0f / scenarioIt->fixedRate);
+	}
+}
+
+template <typename Function>
+static void MeasureSystem(const char* systemName, Function&& function)
+{
+	const auto profilerZone = Globals::Profiler().zone(systemName);
+
+	if (frameBenchmark)
+		frameBenchmark->measure(systemName, std::forward<Function>(function));
+	else
+		function();
+}
+
+static void InitSystemsScheduler()
+{
+	using Resource = Tools::SystemsScheduler::Resource;
+	using Access = Tools::SystemsScheduler::Access;
+
+	systemsScheduler = std::make_unique<Tools::SystemsScheduler>(Globals::ThreadPool());
+
+	auto addSystem = [](const char* systemName, Access access, auto systemF) {
+		systemsScheduler->addSystem(access, [systemName, systemF]() { MeasureSystem(systemName, systemF); });
+	};
+
+	// Declarations cover also side effects of components' step functions provided by levels, e.g. detonating missiles or decorations playing sounds.
+	// Steps which may emplace components write component ids. Decorations follow bodies, so they are stepped after structures moved them.
+	// Overlaps: texture stepping runs alongside actors, temporaries and structures, camera and audio alongside decoration buffer and texture updates.
+	// Buffers and textures are updated after components were stepped, so changes made by other systems' steps are picked up in the same frame.
+	addSystem("textures", Access{}.writes({ Resource::Textures }),
+		[]() { Globals::Systems().textures().stepComponents(); });
+	addSystem("actors", Access{}.reads({ Resource::Structures }).writes({ Resource::Actors, Resource::Physics, Resource::Temporaries, Resource::Decorations, Resource::Audio, Resource::OpenGL,
+		Resource::ComponentIds }).mainThread(true),
+		[]() { Globals::Systems().actors().step(); });
+	addSystem("temporaries", Access{}.writes({ Resource::Temporaries, Resource::Physics, Resource::Decorations, Resource::Audio, Resource::ComponentIds }),
+		[]() { Globals::Systems().temporaries().stepComponents(); });
+	addSystem("temporariesBuffers", Access{}.writes({ Resource::Temporaries, Resource::OpenGL }).mainThread(true),
+		[]() { Globals::Systems().temporaries().updateDynamicBuffers(); });
+	// Polylines update their buffers while stepping.
+	addSystem("structures", Access{}.writes({ Resource::Structures, Resource::Physics, Resource::OpenGL, Resource::ComponentIds }).mainThread(true),
+		[]() { Globals::Systems().structures().step(); });
+	addSystem("decorations", Access{}.reads({ Resource::Physics, Resource::Actors, Resource::Camera }).writes({ Resource::Decorations, Resource::Textures, Resource::Audio, Resource::ComponentIds }),
+		[]() { Globals::Systems().decorations().stepComponents(); });
+	addSystem("decorationsBuffers", Access{}.writes({ Resource::Decorations, Resource::OpenGL }).mainThread(true),
+		[]() { Globals::Systems().decorations().updateDynamicBuffers(); });
+	addSystem("texturesUpdate", Access{}.writes({ Resource::Textures, Resource::OpenGL }).mainThread(true),
+		[]() {
+			Globals::Systems().textures().updateDynamicTextures();
+			Globals::Systems().textures().updateDynamicRenderTextures();
+		});
+	addSystem("camera", Access{}.reads({ Resource::Physics, Resource::Actors }).writes({ Resource::Camera }),
+		[]() { Globals::Systems().camera().step(); });
+	addSystem("audio", Access{}.reads({ Resource::Physics, Resource::Actors, Resource::Camera }).writes({ Resource::Audio }),
+		[]() { Globals::Systems().audio().step(); });
+}
 
 static void InitOGL()
 {
 	const GLenum glewInitResult = glewInit();
 	assert(GLEW_OK == glewInitResult);
 
+	glProxyResyncState();
+
 	if (glDebug)
 		glProxyEnableDebugOutput(glDebugMinSeverity, glDebugPerformance);
 
 	Tools::VSync(true);
 	glProxySetBlend(true);
-	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 static void InitSDL()
@@ -129,13 +265,23 @@ static void InitEngine()
 	InitOGL();
 	InitSDL();
 
+	Globals::InitializeProfiler();
+	Globals::InitializeThreadPool();
 	Globals::InitializeShaders();
 	Globals::InitializeComponents();
 	Globals::InitializeSystems();
+
+	InitSystemsScheduler();
 }
 
 static void InitLevel()
 {
+	if (activeBenchmarkScenario)
+	{
+		activeLevel = activeBenchmarkScenario->createLevel();
+		return;
+	}
+
 	//activeLevel = std::make_unique<Levels::RaceEditor>();
 	//activeLevel = std::make_unique<Levels::Race>();
 
@@ -185,10 +331,22 @@ static void PostInit()
 	Globals::Systems().decorations().postInit();
 	Globals::Systems().renderingController().postInit();
 	Globals::Systems().audio().postInit();
+
+	if (frameBenchmark)
+	{
+		Globals::Components().physics().forceRefreshRateOrTimeBasedStep = 1;
+		Globals::Systems().stateController().changeRefreshRate(activeBenchmarkScenario->fixedRate);
+	}
+
+	if (profile)
+		Globals::Profiler().setEnabled(true);
 }
 
 static void PrepareFrame()
 {
+	if (frameBenchmark)
+		frameBenchmark->frameBegin();
+
 	if (Globals::Components().physics().paused)
 	{
 		Globals::Systems().stateController().stepSetup();
@@ -197,32 +355,52 @@ static void PrepareFrame()
 	}
 	else
 	{
-		Globals::Systems().stateController().stepSetup();
-		Globals::Systems().physics().step();
-		Globals::Systems().deferredActions().step();
+		MeasureSystem("stepSetup", []() { Globals::Systems().stateController().stepSetup(); });
+		MeasureSystem("physics", []() { Globals::Systems().physics().step(); });
+		MeasureSystem("deferredActions", []() { Globals::Systems().deferredActions().step(); });
 
-		activeLevel->step();
+		MeasureSystem("level", []() { activeLevel->step(); });
 
-		Globals::Systems().textures().step();
-		Globals::Systems().actors().step();
-		Globals::Systems().temporaries().step();
-		Globals::Systems().structures().step();
-		Globals::Systems().decorations().step();
-		Globals::Systems().camera().step();
-		Globals::Systems().audio().step();
-		Globals::Systems().stateController().stepTeardown();
+		systemsScheduler->run(!serialSystems);
+		MeasureSystem("stepTeardown", []() { Globals::Systems().stateController().stepTeardown(); });
 	}
 
-	Globals::Systems().stateController().renderSetup();
-	Globals::Systems().renderingController().render();
-	Globals::Systems().stateController().renderTeardown();
+	// Benchmark runs measure simulation only, so rendering is skipped entirely. They still need the window and its GL context, as levels create
+	// shaders, textures and buffers during setup and systems upload them while stepping. There is no windowless (headless) mode yet.
+	if (!frameBenchmark)
+	{
+		MeasureSystem("renderSetup", []() { Globals::Systems().stateController().renderSetup(); });
+		Globals::Systems().renderingController().render();
+		MeasureSystem("renderTeardown", []() { Globals::Systems().stateController().renderTeardown(); });
+	}
 
 	if (!Globals::Components().physics().paused)
-		Globals::Systems().cleaner().step();
+		MeasureSystem("cleaner", []() { Globals::Systems().cleaner().step(); });
+
+	if (frameBenchmark)
+		frameBenchmark->frameDone();
 
 	//std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+static void FinishBenchmark()
+{
+	const auto resultsPath = std::string("benchmark_") + activeBenchmarkScenario->name + ".json";
+	frameBenchmark->saveJson(resultsPath);
+
+	std::cout << frameBenchmark->toJson();
+	std::cout << "Benchmark results saved to " << resultsPath << "\n";
+
+	if (Globals::Profiler().isEnabled())
+	{
+		const auto tracePath = std::string("profile_") + activeBenchmarkScenario->name + ".json";
+		Globals::Profiler().saveChromeTrace(tracePath);
+
+		std::cout << Globals::Profiler().getSummary();
+		std::cout << "Profiler trace saved to " << tracePath << "\n";
+	}
+}
+
 static void TearDown()
 {
 	activeLevel.reset();
@@ -231,6 +409,9 @@ static void TearDown()
 	Globals::DestroyComponents();
 	Globals::DestroySystems();
 	Globals::DestroyShaders();
+	systemsScheduler.reset();
+	Globals::DestroyThreadPool();
+	Globals::DestroyProfiler();
 
 	SDL_Quit();
 }
@@ -401,6 +582,36 @@ int APIENTRY WinMain(
 
 	std::cout << "WinMain begin\n";
 
+	try
+	{
+		ParseCommandLine(lpCmdLine);
+	}
+	catch (const std::runtime_error& error)
+	{
+		MessageBox(nullptr, error.what(), "Runtime error",
+			MB_OK | MB_ICONEXCLAMATION);
+		return 1;
+	}
+
+	// Microbenchmark doesn't need the engine, it exits right after saving the results, as the console is closed with the process.
+	if (benchmarkTexelKernels)
+	{
+		const std::string resultsPath = "benchmark_texelKernels.txt";
+		const auto results = Tools::TexelKernels::Benchmark();
+
+		std::ofstream file(resultsPath);
+		if (!file)
+		{
+			MessageBox(nullptr, ("Unable to save benchmark results to " + resultsPath + ".").c_str(), "Runtime error", MB_OK | MB_ICONEXCLAMATION);
+			return 1;
+		}
+		file << results;
+
+		std::cout << results;
+		std::cout << "Benchmark results saved to " << resultsPath << "\n";
+		return 0;
+	}
+
 	if (forcedScreenMode.enabled)
 	{
 		DEVMODE dmScreenSettings;
@@ -477,7 +688,9 @@ int APIENTRY WinMain(
 			if (newPos)
 			{
 				Globals::Systems().stateController().changeWindowLocation(*newPos);
-				Globals::Systems().stateController().changeRefreshRate(GetDeviceCaps(hDC, VREFRESH));
+				Globals::Systems().stateController().changeRefreshRate(activeBenchmarkScenario
+					? activeBenchmarkScenario->fixedRate
+					: GetDeviceCaps(hDC, VREFRESH));
 				newPos = {};
 			}
 
@@ -487,7 +700,7 @@ int APIENTRY WinMain(
 				newSize = {};
 			}
 
-			if (prevFocus != focus)
+			if (prevFocus != focus && !frameBenchmark)
 			{
 				keys = {};
 				Globals::Systems().stateController().setWindowFocus(focus);
@@ -501,7 +714,19 @@ int APIENTRY WinMain(
 				first = false;
 			}
 
-			if (focus)
+			if (frameBenchmark)
+			{
+				Globals::Profiler().beginFrame();
+				PrepareFrame();
+				Globals::Profiler().endFrame();
+
+				if (frameBenchmark->finished())
+				{
+					FinishBenchmark();
+					break;
+				}
+			}
+			else if (focus)
 			{
 				if (!Globals::Components().physics().paused)
 				{
@@ -511,6 +736,8 @@ int APIENTRY WinMain(
 				else
 					Tools::SetMouseCursorVisibility(true);
 
+				Globals::Profiler().beginFrame();
+
 				Globals::Systems().stateController().handleKeyboard(keys);
 				Globals::Systems().stateController().handleMouseButtons();
 				Globals::Systems().stateController().handleSDL();
@@ -519,9 +746,13 @@ int APIENTRY WinMain(
 
 				Globals::Components().mouse().delta = { 0, 0 };
 
-				glFinish(); // Not sure why, but it helps with stuttering in some scenarios, e.g. if projectile was launched (release + lower display refresh rate => bigger stuttering without it).
+				MeasureSystem("finish", []() {
+					glFinish(); // Not sure why, but it helps with stuttering in some scenarios, e.g. if projectile was launched (release + lower display refresh rate => bigger stuttering without it).
+				});
 				//GdiFlush();
-				SwapBuffers(hDC);
+				MeasureSystem("swapBuffers", [&]() { SwapBuffers(hDC); });
+
+				Globals::Profiler().endFrame();
 			}
 			else
 				Tools::SetMouseCursorVisibility(true);
@@ -0,0 +1,91 @@
+#include "autoInstancingBuffers.hpp"
+
+#include "genericBuffers.hpp"
+
+#include <ogl/shaders/programBase.hpp>
+
+#include <cassert>
+
+namespace Buffers
+{
+	AutoInstancingBuffers::AutoInstancingBuffers()
+	{
+		glGenBuffers(1, &transformsBuffer);
+		glGenBuffers(1, &colorsBuffer);
+
+		glVertexAttrib4f(GenericSubBuffers::instancedColorAttribIdx, 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	AutoInstancingBuffers::~AutoInstancingBuffers()
+	{
+		glProxyDeleteBuffers(1, &transformsBuffer);
+		glProxyDeleteBuffers(1, &colorsBuffer);
+	}
+
+	void AutoInstancingBuffers::clear()
+	{
+		transforms.clear();
+		colors.clear();
+	}
+
+	void AutoInstancingBuffers::addInstance(const glm::mat4& transform, const glm::vec4& color)
+	{
+		transforms.push_back(transform);
+		colors.push_back(color);
+	}
+
+	size_t AutoInstancingBuffers::getNumOfInstances() const
+	{
+		return transforms.size();
+	}
+
+	void AutoInstancingBuffers::draw(ShadersUtils::AccessorBase& program, const GenericSubBuffers& representativeBuffers)
+	{
+		assert(!representativeBuffers.isInstancingActive());
+
+		if (transforms.empty())
+			return;
+
+		glProxyBindVertexArray(representativeBuffers.vertexArray);
+
+		// Orphaning lets the driver hand out fresh storage instead of waiting for previous draws using the buffer.
+		glProxyBindBuffer(GL_ARRAY_BUFFER, transformsBuffer);
+		glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(transforms.front()), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, transforms.size() * sizeof(transforms.front()), transforms.data());
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			glVertexAttribPointer(GenericSubBuffers::instancedTransformAttribIdx + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
+			glVertexAttribDivisor(GenericSubBuffers::instancedTransformAttribIdx + i, 1);
+			glEnableVertexAttribArray(GenericSubBuffers::instancedTransformAttribIdx + i);
+		}
+
+		glProxyBindBuffer(GL_ARRAY_BUFFER, colorsBuffer);
+		glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(colors.front()), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, colors.size() * sizeof(colors.front()), colors.data());
+		glVertexAttribPointer(GenericSubBuffers::instancedColorAttribIdx, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glVertexAttribDivisor(GenericSubBuffers::instancedColorAttribIdx, 1);
+		glEnableVertexAttribArray(GenericSubBuffers::instancedColorAttribIdx);
+
+		glProxyUseProgram(program.getProgramId());
+		program.flushUniforms();
+
+		const auto drawMode = representativeBuffers.renderable->drawMode;
+		if (representativeBuffers.isIndicingActive())
+			glDrawElementsInstanced(drawMode, representativeBuffers.drawCount, GL_UNSIGNED_INT, nullptr, (GLsizei)transforms.size());
+		else
+			glDrawArraysInstanced(drawMode, 0, representativeBuffers.drawCount, (GLsizei)transforms.size());
+
+		// Representative's VAO is restored to the non instanced state, including current values of attributes, which become undefined after the draw.
+		static const glm::mat4 identity(1.0f);
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			glDisableVertexAttribArray(GenericSubBuffers::instancedTransformAttribIdx + i);
+			glVertexAttribDivisor(GenericSubBuffers::instancedTransformAttribIdx + i, 0);
+			glVertexAttrib4fv(GenericSubBuffers::instancedTransformAttribIdx + i, &identity[i][0]);
+		}
+
+		glDisableVertexAttribArray(GenericSubBuffers::instancedColorAttribIdx);
+		glVertexAttribDivisor(GenericSubBuffers::instancedColorAttribIdx, 0);
+		glVertexAttrib4f(GenericSubBuffers::instancedColorAttribIdx, 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+}
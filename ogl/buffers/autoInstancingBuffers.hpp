@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ogl/oglProxy.hpp>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+
+namespace ShadersUtils
+{
+	struct AccessorBase;
+}
+
+namespace Buffers
+{
+	struct GenericSubBuffers;
+
+	// Per-frame instance data for drawing identical geometries in a single instanced draw call. Instance attributes are attached to the VAO
+	// of the representative buffers for the duration of the draw, so their vertex data is reused.
+	class AutoInstancingBuffers
+	{
+	public:
+		AutoInstancingBuffers();
+		AutoInstancingBuffers(const AutoInstancingBuffers&) = delete;
+		~AutoInstancingBuffers();
+
+		void clear();
+		void addInstance(const glm::mat4& transform, const glm::vec4& color);
+		size_t getNumOfInstances() const;
+
+		void draw(ShadersUtils::AccessorBase& program, const GenericSubBuffers& representativeBuffers);
+
+	private:
+		std::vector<glm::mat4> transforms;
+		std::vector<glm::vec4> colors;
+
+		GLuint transformsBuffer = 0;
+		GLuint colorsBuffer = 0;
+	};
+}
@@ -1,18 +1,60 @@
 #include "genericBuffers.hpp"
 
+#include <components/renderingBuffers.hpp>
+
 #include <ogl/oglProxy.hpp>
 #include <tools/utility.hpp>
 
+#include <glm/common.hpp>
+
 #include <algorithm>
 #include <execution>
+#include <string>
 
 namespace
 {
 	constexpr bool parallelProcessing = true;
+
+	// Hashed data is kept, so geometries with equal hashes can be compared.
+	template <typename Value>
+	size_t StoreAndHashData(std::string& storage, const Value* data, size_t count)
+	{
+		storage.assign(reinterpret_cast<const char*>(data), count * sizeof(Value));
+		return std::hash<std::string>{}(storage);
+	}
+
+	template <typename Value>
+	size_t StoreAndHashUniformData(std::string& storage, const Value& value, unsigned count)
+	{
+		size_t hash = StoreAndHashData(storage, &value, 1);
+		storage.append(reinterpret_cast<const char*>(&count), sizeof(count));
+		Tools::HashCombine(hash, count);
+		return hash;
+	}
+
+	Buffers::UploadsCounters uploadsCounters;
 }
 
 namespace Buffers
 {
+	const UploadsCounters& GetUploadsCounters()
+	{
+		return uploadsCounters;
+	}
+
+	void ResetUploadsCounters()
+	{
+		uploadsCounters = {};
+	}
+
+	void CountUpload(bool issued)
+	{
+		if (issued)
+			++uploadsCounters.issued;
+		else
+			++uploadsCounters.skipped;
+	}
+
 	GenericSubBuffers::GenericSubBuffers(bool defaultVAO)
 	{
 		if (!defaultVAO)
@@ -46,6 +88,18 @@ namespace Buffers
 		instancedNormalTransformsBuffer(other.instancedNormalTransformsBuffer),
 		indicesBuffer(other.indicesBuffer),
 
+		positionsHash(other.positionsHash),
+		positionsBounds(other.positionsBounds),
+		colorsHash(other.colorsHash),
+		texCoordsHash(other.texCoordsHash),
+		indicesHash(other.indicesHash),
+		positionsData(std::move(other.positionsData)),
+		colorsData(std::move(other.colorsData)),
+		texCoordsData(std::move(other.texCoordsData)),
+		indicesData(std::move(other.indicesData)),
+		streamed(other.streamed),
+		geometryHashed(other.geometryHashed),
+
 		numOfAllocatedPositions(other.numOfAllocatedPositions),
 		numOfAllocatedColors(other.numOfAllocatedColors),
 		numOfAllocatedVelocitiesAndTimes(other.numOfAllocatedVelocitiesAndTimes),
@@ -56,7 +110,8 @@ namespace Buffers
 		numOfAllocatedInstancedNormalTransforms(other.numOfAllocatedInstancedNormalTransforms),
 		numOfAllocatedIndices(other.numOfAllocatedIndices),
 
-		allocatedBufferDataUsage(other.allocatedBufferDataUsage)
+		allocatedBufferDataUsage(other.allocatedBufferDataUsage),
+		streamedAttribsMask(other.streamedAttribsMask)
 	{
 		other.expired = true;
 	}
@@ -66,76 +121,109 @@ namespace Buffers
 		if (expired)
 			return;
 
-		glDeleteBuffers(1, &positionsBuffer);
+		glProxyDeleteBuffers(1, &positionsBuffer);
 
 		if (colorsBuffer)
-			glDeleteBuffers(1, &*colorsBuffer);
+			glProxyDeleteBuffers(1, &*colorsBuffer);
 
 		if (velocitiesAndTimesBuffer)
-			glDeleteBuffers(1, &*velocitiesAndTimesBuffer);
+			glProxyDeleteBuffers(1, &*velocitiesAndTimesBuffer);
 
 		if (hSizesAndAnglesBuffer)
-			glDeleteBuffers(1, &*hSizesAndAnglesBuffer);
+			glProxyDeleteBuffers(1, &*hSizesAndAnglesBuffer);
 
 		if (texCoordsBuffer)
-			glDeleteBuffers(1, &*texCoordsBuffer);
+			glProxyDeleteBuffers(1, &*texCoordsBuffer);
 
 		if (normalsBuffer)
-			glDeleteBuffers(1, &*normalsBuffer);
+			glProxyDeleteBuffers(1, &*normalsBuffer);
 
 		if (instancedTransformsBuffer)
-			glDeleteBuffers(1, &*instancedTransformsBuffer);
+			glProxyDeleteBuffers(1, &*instancedTransformsBuffer);
 
 		if (instancedNormalTransformsBuffer)
-			glDeleteBuffers(1, &*instancedNormalTransformsBuffer);
+			glProxyDeleteBuffers(1, &*instancedNormalTransformsBuffer);
 
 		if (indicesBuffer)
-			glDeleteBuffers(1, &*indicesBuffer);
+			glProxyDeleteBuffers(1, &*indicesBuffer);
 
-		glDeleteVertexArrays(1, &vertexArray);
+		glProxyDeleteVertexArrays(1, &vertexArray);
 	}
 
 	void GenericSubBuffers::setPositionsBuffer(const std::vector<glm::vec3>& positions)
 	{
 		glProxyBindVertexArray(vertexArray);
 
-		glBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
-		if (numOfAllocatedPositions < positions.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+		if (auto* data = streamAttrib(positionAttribIdx, 3, positions.size() * sizeof(glm::vec3)))
+			std::copy(positions.begin(), positions.end(), static_cast<glm::vec3*>(data));
+		else
 		{
-			glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(positions.front()), positions.data(), renderable->bufferDataUsage);
-			numOfAllocatedPositions = positions.size();
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			glProxyBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
+			unstreamAttrib(positionAttribIdx, 3);
+			if (numOfAllocatedPositions < positions.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(positions.front()), positions.data(), renderable->bufferDataUsage);
+				numOfAllocatedPositions = positions.size();
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+			else
+				glBufferSubData(GL_ARRAY_BUFFER, positionAttribIdx, positions.size() * sizeof(positions.front()), positions.data());
 		}
-		else
-			glBufferSubData(GL_ARRAY_BUFFER, positionAttribIdx, positions.size() * sizeof(positions.front()), positions.data());
 
 		glEnableVertexAttribArray(positionAttribIdx);
 
 		drawCount = (GLsizei)positions.size();
+		positionsHash = std::nullopt;
+		positionsData.clear();
+		if (geometryHashed && positions.size() <= autoInstancingMaxVertices)
+			positionsHash = StoreAndHashData(positionsData, positions.data(), positions.size());
+
+		positionsBounds = std::nullopt;
+		if (!positions.empty())
+		{
+			positionsBounds.emplace(positions.front(), positions.front());
+			for (const auto& position : positions)
+			{
+				positionsBounds->first = glm::min(positionsBounds->first, position);
+				positionsBounds->second = glm::max(positionsBounds->second, position);
+			}
+		}
 	}
 
 	void GenericSubBuffers::setPositionsBuffer(glm::vec3 position, unsigned count)
 	{
 		glProxyBindVertexArray(vertexArray);
 
-		glBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
-		if (numOfAllocatedPositions < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+		if (auto* data = streamAttrib(positionAttribIdx, 3, count * sizeof(position)))
+			std::fill_n(static_cast<glm::vec3*>(data), count, position);
+		else
 		{
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(position), nullptr, renderable->bufferDataUsage);
-			numOfAllocatedPositions = count;
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			glProxyBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
+			unstreamAttrib(positionAttribIdx, 3);
+			if (numOfAllocatedPositions < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, count * sizeof(position), nullptr, renderable->bufferDataUsage);
+				numOfAllocatedPositions = count;
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+
+			glClearBufferData(GL_ARRAY_BUFFER, GL_RGB32F, GL_RGB, GL_FLOAT, &position);
 		}
 
-		glClearBufferData(GL_ARRAY_BUFFER, GL_RGB32F, GL_RGB, GL_FLOAT, &position);
 		glEnableVertexAttribArray(positionAttribIdx);
 
 		drawCount = count;
+		positionsHash = std::nullopt;
+		positionsData.clear();
+		if (geometryHashed && count <= autoInstancingMaxVertices)
+			positionsHash = StoreAndHashUniformData(positionsData, position, count);
+		positionsBounds = std::nullopt;
 	}
 
 	void GenericSubBuffers::allocateTFPositionsBuffer(unsigned count)
 	{
-		glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, positionsBuffer);
-		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, positionAttribIdx, positionsBuffer);
+		glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, positionsBuffer);
+		glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, positionAttribIdx, positionsBuffer);
 		if (numOfAllocatedPositions < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
 			glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, count * sizeof(glm::vec3), nullptr, renderable->bufferDataUsage);
@@ -154,22 +242,37 @@ namespace Buffers
 		{
 			glVertexAttrib4f(colorAttribIdx, 1.0f, 1.0f, 1.0f, 1.0f);
 			glDisableVertexAttribArray(colorAttribIdx);
+			colorsHash = 0;
+			colorsData.clear();
 			return;
 		}
 
-		if (colorsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
-		else
-			createColorsBuffer();
+		colorsHash = 0;
+		colorsData.clear();
+		if (positionsHash)
+			colorsHash = StoreAndHashData(colorsData, colors.data(), colors.size());
 
-		if (numOfAllocatedColors < colors.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+		if (auto* data = streamAttrib(colorAttribIdx, 4, colors.size() * sizeof(glm::vec4)))
+			std::copy(colors.begin(), colors.end(), static_cast<glm::vec4*>(data));
+		else
 		{
-			glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(colors.front()), colors.data(), renderable->bufferDataUsage);
-			numOfAllocatedColors = colors.size();
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (colorsBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
+				unstreamAttrib(colorAttribIdx, 4);
+			}
+			else
+				createColorsBuffer();
+
+			if (numOfAllocatedColors < colors.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(colors.front()), colors.data(), renderable->bufferDataUsage);
+				numOfAllocatedColors = colors.size();
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+			else
+				glBufferSubData(GL_ARRAY_BUFFER, 0, colors.size() * sizeof(colors.front()), colors.data());
 		}
-		else
-			glBufferSubData(GL_ARRAY_BUFFER, 0, colors.size() * sizeof(colors.front()), colors.data());
 
 		glEnableVertexAttribArray(colorAttribIdx);
 	}
@@ -178,6 +281,11 @@ namespace Buffers
 	{
 		glProxyBindVertexArray(vertexArray);
 
+		colorsHash = 0;
+		colorsData.clear();
+		if (positionsHash)
+			colorsHash = StoreAndHashUniformData(colorsData, color, count);
+
 		if (count == 0)
 		{
 			glVertexAttrib4f(colorAttribIdx, color.x, color.y, color.z, color.w);
@@ -185,30 +293,39 @@ namespace Buffers
 			return;
 		}
 
-		if (colorsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
+		if (auto* data = streamAttrib(colorAttribIdx, 4, count * sizeof(color)))
+			std::fill_n(static_cast<glm::vec4*>(data), count, color);
 		else
-			createColorsBuffer();
-
-		if (numOfAllocatedColors < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(color), nullptr, renderable->bufferDataUsage);
-			numOfAllocatedColors = count;
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (colorsBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
+				unstreamAttrib(colorAttribIdx, 4);
+			}
+			else
+				createColorsBuffer();
+
+			if (numOfAllocatedColors < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, count * sizeof(color), nullptr, renderable->bufferDataUsage);
+				numOfAllocatedColors = count;
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+
+			glClearBufferData(GL_ARRAY_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, &color);
 		}
 
-		glClearBufferData(GL_ARRAY_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, &color);
 		glEnableVertexAttribArray(colorAttribIdx);
 	}
 
 	void GenericSubBuffers::allocateTFColorsBuffer(unsigned count)
 	{
 		if (colorsBuffer)
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *colorsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *colorsBuffer);
 		else
 			createColorsBuffer(GL_TRANSFORM_FEEDBACK_BUFFER);
 
-		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, colorAttribIdx, *colorsBuffer);
+		glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, colorAttribIdx, *colorsBuffer);
 
 		if (numOfAllocatedColors < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
@@ -229,19 +346,27 @@ namespace Buffers
 			return;
 		}
 
-		if (velocitiesAndTimesBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
+		if (auto* data = streamAttrib(velocityAndTimeAttribIdx, 4, velocitiesAndTimes.size() * sizeof(glm::vec4)))
+			std::copy(velocitiesAndTimes.begin(), velocitiesAndTimes.end(), static_cast<glm::vec4*>(data));
 		else
-			createVelocitiesAndTimesBuffer();
-
-		if (numOfAllocatedVelocitiesAndTimes < velocitiesAndTimes.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
-			glBufferData(GL_ARRAY_BUFFER, velocitiesAndTimes.size() * sizeof(velocitiesAndTimes.front()), velocitiesAndTimes.data(), renderable->bufferDataUsage);
-			numOfAllocatedVelocitiesAndTimes = velocitiesAndTimes.size();
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (velocitiesAndTimesBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
+				unstreamAttrib(velocityAndTimeAttribIdx, 4);
+			}
+			else
+				createVelocitiesAndTimesBuffer();
+
+			if (numOfAllocatedVelocitiesAndTimes < velocitiesAndTimes.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, velocitiesAndTimes.size() * sizeof(velocitiesAndTimes.front()), velocitiesAndTimes.data(), renderable->bufferDataUsage);
+				numOfAllocatedVelocitiesAndTimes = velocitiesAndTimes.size();
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+			else
+				glBufferSubData(GL_ARRAY_BUFFER, 0, velocitiesAndTimes.size() * sizeof(velocitiesAndTimes.front()), velocitiesAndTimes.data());
 		}
-		else
-			glBufferSubData(GL_ARRAY_BUFFER, 0, velocitiesAndTimes.size() * sizeof(velocitiesAndTimes.front()), velocitiesAndTimes.data());
 
 		glEnableVertexAttribArray(velocityAndTimeAttribIdx);
 	}
@@ -257,30 +382,39 @@ namespace Buffers
 			return;
 		}
 
-		if (velocitiesAndTimesBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
+		if (auto* data = streamAttrib(velocityAndTimeAttribIdx, 4, count * sizeof(velocityAndTime)))
+			std::fill_n(static_cast<glm::vec4*>(data), count, velocityAndTime);
 		else
-			createVelocitiesAndTimesBuffer();
-
-		if (numOfAllocatedVelocitiesAndTimes < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(velocityAndTime), nullptr, renderable->bufferDataUsage);
-			numOfAllocatedVelocitiesAndTimes = count;
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (velocitiesAndTimesBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
+				unstreamAttrib(velocityAndTimeAttribIdx, 4);
+			}
+			else
+				createVelocitiesAndTimesBuffer();
+
+			if (numOfAllocatedVelocitiesAndTimes < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, count * sizeof(velocityAndTime), nullptr, renderable->bufferDataUsage);
+				numOfAllocatedVelocitiesAndTimes = count;
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+
+			glClearBufferData(GL_ARRAY_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, &velocityAndTime);
 		}
 
-		glClearBufferData(GL_ARRAY_BUFFER, GL_RGBA32F, GL_RGBA, GL_FLOAT, &velocityAndTime);
 		glEnableVertexAttribArray(velocityAndTimeAttribIdx);
 	}
 
 	void GenericSubBuffers::allocateTFVelocitiesAndTimesBuffer(unsigned count)
 	{
 		if (velocitiesAndTimesBuffer)
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *velocitiesAndTimesBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *velocitiesAndTimesBuffer);
 		else
 			createVelocitiesAndTimesBuffer(GL_TRANSFORM_FEEDBACK_BUFFER);
 
-		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, velocityAndTimeAttribIdx, *velocitiesAndTimesBuffer);
+		glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, velocityAndTimeAttribIdx, *velocitiesAndTimesBuffer);
 
 		if (numOfAllocatedVelocitiesAndTimes < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
@@ -300,19 +434,27 @@ namespace Buffers
 			glDisableVertexAttribArray(hSizeAndAngleAttribIdx);
 			return;
 		}
-		if (hSizesAndAnglesBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
+		if (auto* data = streamAttrib(hSizeAndAngleAttribIdx, 3, hSizes.size() * sizeof(glm::vec3)))
+			std::copy(hSizes.begin(), hSizes.end(), static_cast<glm::vec3*>(data));
 		else
-			createHSizesAndAnglesBuffer();
-
-		if (numOfAllocatedHSizesAndAngles < hSizes.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
-			glBufferData(GL_ARRAY_BUFFER, hSizes.size() * sizeof(hSizes.front()), hSizes.data(), renderable->bufferDataUsage);
-			numOfAllocatedHSizesAndAngles = hSizes.size();
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (hSizesAndAnglesBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
+				unstreamAttrib(hSizeAndAngleAttribIdx, 3);
+			}
+			else
+				createHSizesAndAnglesBuffer();
+
+			if (numOfAllocatedHSizesAndAngles < hSizes.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, hSizes.size() * sizeof(hSizes.front()), hSizes.data(), renderable->bufferDataUsage);
+				numOfAllocatedHSizesAndAngles = hSizes.size();
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+			else
+				glBufferSubData(GL_ARRAY_BUFFER, 0, hSizes.size() * sizeof(hSizes.front()), hSizes.data());
 		}
-		else
-			glBufferSubData(GL_ARRAY_BUFFER, 0, hSizes.size() * sizeof(hSizes.front()), hSizes.data());
 
 		glEnableVertexAttribArray(hSizeAndAngleAttribIdx);
 	}
@@ -328,30 +470,39 @@ namespace Buffers
 			return;
 		}
 
-		if (hSizesAndAnglesBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
+		if (auto* data = streamAttrib(hSizeAndAngleAttribIdx, 3, count * sizeof(hSizeAndAngle)))
+			std::fill_n(static_cast<glm::vec3*>(data), count, hSizeAndAngle);
 		else
-			createHSizesAndAnglesBuffer();
-
-		if (numOfAllocatedHSizesAndAngles < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
-			glBufferData(GL_ARRAY_BUFFER, count * sizeof(hSizeAndAngle), nullptr, renderable->bufferDataUsage);
-			numOfAllocatedHSizesAndAngles = count;
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (hSizesAndAnglesBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
+				unstreamAttrib(hSizeAndAngleAttribIdx, 3);
+			}
+			else
+				createHSizesAndAnglesBuffer();
+
+			if (numOfAllocatedHSizesAndAngles < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, count * sizeof(hSizeAndAngle), nullptr, renderable->bufferDataUsage);
+				numOfAllocatedHSizesAndAngles = count;
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+
+			glClearBufferData(GL_ARRAY_BUFFER, GL_RGB32F, GL_RGB, GL_FLOAT, &hSizeAndAngle);
 		}
 
-		glClearBufferData(GL_ARRAY_BUFFER, GL_RGB32F, GL_RGB, GL_FLOAT, &hSizeAndAngle);
 		glEnableVertexAttribArray(hSizeAndAngleAttribIdx);
 	}
 
 	void GenericSubBuffers::allocateTFHSizesAndAnglesBuffer(unsigned count)
 	{
 		if (hSizesAndAnglesBuffer)
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *hSizesAndAnglesBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *hSizesAndAnglesBuffer);
 		else
 			createHSizesAndAnglesBuffer(GL_TRANSFORM_FEEDBACK_BUFFER);
 
-		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, hSizeAndAngleAttribIdx, *hSizesAndAnglesBuffer);
+		glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, hSizeAndAngleAttribIdx, *hSizesAndAnglesBuffer);
 
 		if (numOfAllocatedHSizesAndAngles < count || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
 		{
@@ -369,22 +520,37 @@ namespace Buffers
 		{
 			glVertexAttrib2f(texCoordAttribIdx, 0.0f, 0.0f);
 			glDisableVertexAttribArray(texCoordAttribIdx);
+			texCoordsHash = 0;
+			texCoordsData.clear();
 			return;
 		}
 
-		if (texCoordsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *texCoordsBuffer);
-		else
-			createTexCoordsBuffer();
+		texCoordsHash = 0;
+		texCoordsData.clear();
+		if (positionsHash)
+			texCoordsHash = StoreAndHashData(texCoordsData, texCoords.data(), texCoords.size());
 
-		if (numOfAllocatedTexCoords < texCoords.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+		if (auto* data = streamAttrib(texCoordAttribIdx, 2, texCoords.size() * sizeof(glm::vec2)))
+			std::copy(texCoords.begin(), texCoords.end(), static_cast<glm::vec2*>(data));
+		else
 		{
-			glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(texCoords.front()), texCoords.data(), renderable->bufferDataUsage);
-			numOfAllocatedTexCoords = texCoords.size();
-			allocatedBufferDataUsage = renderable->bufferDataUsage;
+			if (texCoordsBuffer)
+			{
+				glProxyBindBuffer(GL_ARRAY_BUFFER, *texCoordsBuffer);
+				unstreamAttrib(texCoordAttribIdx, 2);
+			}
+			else
+				createTexCoordsBuffer();
+
+			if (numOfAllocatedTexCoords < texCoords.size() || !allocatedBufferDataUsage || *allocatedBufferDataUsage != renderable->bufferDataUsage)
+			{
+				glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(texCoords.front()), texCoords.data(), renderable->bufferDataUsage);
+				numOfAllocatedTexCoords = texCoords.size();
+				allocatedBufferDataUsage = renderable->bufferDataUsage;
+			}
+			else
+				glBufferSubData(GL_ARRAY_BUFFER, 0, texCoords.size() * sizeof(texCoords.front()), texCoords.data());
 		}
-		else
-			glBufferSubData(GL_ARRAY_BUFFER, 0, texCoords.size() * sizeof(texCoords.front()), texCoords.data());
 
 		glEnableVertexAttribArray(texCoordAttribIdx);
 	}
@@ -401,7 +567,7 @@ namespace Buffers
 		}
 
 		if (normalsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *normalsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *normalsBuffer);
 		else
 			createNormalsBuffer();
 
@@ -433,7 +599,7 @@ namespace Buffers
 		}
 
 		if (instancedTransformsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *instancedTransformsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *instancedTransformsBuffer);
 		else
 			createInstancedTransformsBuffer();
 
@@ -468,7 +634,7 @@ namespace Buffers
 		}
 
 		if (instancedNormalTransformsBuffer)
-			glBindBuffer(GL_ARRAY_BUFFER, *instancedNormalTransformsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *instancedNormalTransformsBuffer);
 		else
 			createInstancedNormalTransformsBuffer();
 
@@ -492,8 +658,13 @@ namespace Buffers
 		if (indices.empty())
 			return;
 
+		indicesHash = 0;
+		indicesData.clear();
+		if (positionsHash)
+			indicesHash = StoreAndHashData(indicesData, indices.data(), indices.size());
+
 		if (indicesBuffer)
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
+			glProxyBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
 		else
 			createIndicesBuffer();
 
@@ -519,6 +690,31 @@ namespace Buffers
 		return numOfAllocatedIndices;
 	}
 
+	bool GenericSubBuffers::isStreamActive() const
+	{
+		return streamedAttribsMask;
+	}
+
+	std::optional<size_t> GenericSubBuffers::getGeometryHash() const
+	{
+		if (!geometryHashed || !positionsHash || (size_t)drawCount > autoInstancingMaxVertices)
+			return std::nullopt;
+
+		size_t geometryHash = *positionsHash;
+		Tools::HashCombine(geometryHash, colorsHash);
+		Tools::HashCombine(geometryHash, texCoordsHash);
+		Tools::HashCombine(geometryHash, indicesHash);
+		Tools::HashCombine(geometryHash, drawCount);
+
+		return geometryHash;
+	}
+
+	bool GenericSubBuffers::hasSameGeometry(const GenericSubBuffers& other) const
+	{
+		return drawCount == other.drawCount && positionsData == other.positionsData && colorsData == other.colorsData
+			&& texCoordsData == other.texCoordsData && indicesData == other.indicesData;
+	}
+
 	void GenericSubBuffers::swapActiveBuffers(GenericSubBuffers& other)
 	{
 		assert(other.vertexArray == 0);
@@ -531,14 +727,15 @@ namespace Buffers
 
 		assert(numOfAllocatedPositions == other.numOfAllocatedPositions);
 		std::swap(positionsBuffer, other.positionsBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
+		positionsBounds = std::nullopt;
+		glProxyBindBuffer(GL_ARRAY_BUFFER, positionsBuffer);
 		glVertexAttribPointer(positionAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 
 		if (other.colorsBuffer && colorsBuffer)
 		{
 			assert(numOfAllocatedColors == other.numOfAllocatedColors);
 			std::swap(colorsBuffer, other.colorsBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *colorsBuffer);
 			glVertexAttribPointer(colorAttribIdx, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
 		}
 
@@ -546,7 +743,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedVelocitiesAndTimes == other.numOfAllocatedVelocitiesAndTimes);
 			std::swap(velocitiesAndTimesBuffer, other.velocitiesAndTimesBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *velocitiesAndTimesBuffer);
 			glVertexAttribPointer(velocityAndTimeAttribIdx, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
 		}
 
@@ -554,7 +751,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedHSizesAndAngles == other.numOfAllocatedHSizesAndAngles);
 			std::swap(hSizesAndAnglesBuffer, other.hSizesAndAnglesBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *hSizesAndAnglesBuffer);
 			glVertexAttribPointer(hSizeAndAngleAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 		}
 
@@ -562,7 +759,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedTexCoords == other.numOfAllocatedTexCoords);
 			std::swap(texCoordsBuffer, other.texCoordsBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *texCoordsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *texCoordsBuffer);
 			glVertexAttribPointer(texCoordAttribIdx, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 		}
 
@@ -570,7 +767,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedNormals == other.numOfAllocatedNormals);
 			std::swap(normalsBuffer, other.normalsBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *normalsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *normalsBuffer);
 			glVertexAttribPointer(normalAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 		}
 
@@ -578,7 +775,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedInstancedTransforms == other.numOfAllocatedInstancedTransforms);
 			std::swap(instancedTransformsBuffer, other.instancedTransformsBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *instancedTransformsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *instancedTransformsBuffer);
 			for (unsigned i = 0; i < 4; ++i)
 			{
 				glVertexAttribPointer(instancedTransformAttribIdx + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
@@ -590,7 +787,7 @@ namespace Buffers
 		{
 			assert(numOfAllocatedInstancedNormalTransforms == other.numOfAllocatedInstancedNormalTransforms);
 			std::swap(instancedNormalTransformsBuffer, other.instancedNormalTransformsBuffer);
-			glBindBuffer(GL_ARRAY_BUFFER, *instancedNormalTransformsBuffer);
+			glProxyBindBuffer(GL_ARRAY_BUFFER, *instancedNormalTransformsBuffer);
 			for (unsigned i = 0; i < 3; ++i)
 			{
 				glVertexAttribPointer(instancedNormalTransformAttribIdx + i, 3, GL_FLOAT, GL_FALSE, sizeof(glm::mat3), (void*)(sizeof(glm::vec3) * i));
@@ -602,14 +799,41 @@ namespace Buffers
 		{
 			assert(numOfAllocatedIndices == other.numOfAllocatedIndices);
 			std::swap(indicesBuffer, other.indicesBuffer);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
+			glProxyBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
 		}
 	}
 
+	void* GenericSubBuffers::streamAttrib(unsigned attribIdx, GLint numOfComponents, size_t size)
+	{
+		if (!streamed)
+			return nullptr;
+
+		auto& streamingBuffer = Globals::Components().renderingBuffers().streamingBuffer;
+		const auto allocation = streamingBuffer.allocate(size);
+		if (!allocation)
+			return nullptr;
+
+		glProxyBindBuffer(GL_ARRAY_BUFFER, streamingBuffer.getBufferId());
+		glVertexAttribPointer(attribIdx, numOfComponents, GL_FLOAT, GL_FALSE, 0, (void*)allocation->offset);
+		streamedAttribsMask |= 1u << attribIdx;
+
+		return allocation->data;
+	}
+
+	void GenericSubBuffers::unstreamAttrib(unsigned attribIdx, GLint numOfComponents)
+	{
+		if (!(streamedAttribsMask & (1u << attribIdx)))
+			return;
+
+		// Own buffer has to be bound to GL_ARRAY_BUFFER.
+		glVertexAttribPointer(attribIdx, numOfComponents, GL_FLOAT, GL_FALSE, 0, nullptr);
+		streamedAttribsMask &= ~(1u << attribIdx);
+	}
+
 	void GenericSubBuffers::createPositionsBuffer(unsigned target)
 	{
 		glGenBuffers(1, &positionsBuffer);
-		glBindBuffer(target, positionsBuffer);
+		glProxyBindBuffer(target, positionsBuffer);
 		glVertexAttribPointer(positionAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -618,7 +842,7 @@ namespace Buffers
 		assert(!colorsBuffer);
 		colorsBuffer = 0;
 		glGenBuffers(1, &*colorsBuffer);
-		glBindBuffer(target, *colorsBuffer);
+		glProxyBindBuffer(target, *colorsBuffer);
 		glVertexAttribPointer(colorAttribIdx, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -627,7 +851,7 @@ namespace Buffers
 		assert(!velocitiesAndTimesBuffer);
 		velocitiesAndTimesBuffer = 0;
 		glGenBuffers(1, &*velocitiesAndTimesBuffer);
-		glBindBuffer(target, *velocitiesAndTimesBuffer);
+		glProxyBindBuffer(target, *velocitiesAndTimesBuffer);
 		glVertexAttribPointer(velocityAndTimeAttribIdx, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -636,7 +860,7 @@ namespace Buffers
 		assert(!hSizesAndAnglesBuffer);
 		hSizesAndAnglesBuffer = 0;
 		glGenBuffers(1, &*hSizesAndAnglesBuffer);
-		glBindBuffer(target, *hSizesAndAnglesBuffer);
+		glProxyBindBuffer(target, *hSizesAndAnglesBuffer);
 		glVertexAttribPointer(hSizeAndAngleAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -645,7 +869,7 @@ namespace Buffers
 		assert(!texCoordsBuffer);
 		texCoordsBuffer = 0;
 		glGenBuffers(1, &*texCoordsBuffer);
-		glBindBuffer(target, *texCoordsBuffer);
+		glProxyBindBuffer(target, *texCoordsBuffer);
 		glVertexAttribPointer(texCoordAttribIdx, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -654,7 +878,7 @@ namespace Buffers
 		assert(!normalsBuffer);
 		normalsBuffer = 0;
 		glGenBuffers(1, &*normalsBuffer);
-		glBindBuffer(target, *normalsBuffer);
+		glProxyBindBuffer(target, *normalsBuffer);
 		glVertexAttribPointer(normalAttribIdx, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 	}
 
@@ -663,7 +887,7 @@ namespace Buffers
 		assert(!instancedTransformsBuffer);
 		instancedTransformsBuffer = 0;
 		glGenBuffers(1, &*instancedTransformsBuffer);
-		glBindBuffer(target, *instancedTransformsBuffer);
+		glProxyBindBuffer(target, *instancedTransformsBuffer);
 		for (unsigned i = 0; i < 4; ++i)
 		{
 			glVertexAttribPointer(instancedTransformAttribIdx + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
@@ -676,7 +900,7 @@ namespace Buffers
 		assert(!instancedNormalTransformsBuffer);
 		instancedNormalTransformsBuffer = 0;
 		glGenBuffers(1, &*instancedNormalTransformsBuffer);
-		glBindBuffer(target, *instancedNormalTransformsBuffer);
+		glProxyBindBuffer(target, *instancedNormalTransformsBuffer);
 		for (unsigned i = 0; i < 3; ++i)
 		{
 			glVertexAttribPointer(instancedNormalTransformAttribIdx + i, 3, GL_FLOAT, GL_FALSE, sizeof(glm::mat3), (void*)(sizeof(glm::vec3) * i));
@@ -689,7 +913,7 @@ namespace Buffers
 		assert(!indicesBuffer);
 		indicesBuffer = 0;
 		glGenBuffers(1, &*indicesBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
+		glProxyBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *indicesBuffer);
 	}
 
 	GenericBuffers::GenericBuffers(bool defaultVAO) :
@@ -728,51 +952,58 @@ namespace Buffers
 		return normalTransforms;
 	}
 
+	bool GenericBuffers::isAnyPartStreamActive() const
+	{
+		return isStreamActive() || std::any_of(subsequence.begin(), subsequence.end(), [](const auto& subBuffers) {
+			return subBuffers.isStreamActive();
+		});
+	}
+
 	void GenericBuffers::bindActiveTFBuffers() const
 	{
-		glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, positionsBuffer);
-		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, positionAttribIdx, positionsBuffer);
+		glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, positionsBuffer);
+		glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, positionAttribIdx, positionsBuffer);
 
 		if (colorsBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *colorsBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, colorAttribIdx, *colorsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *colorsBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, colorAttribIdx, *colorsBuffer);
 		}
 
 		if (velocitiesAndTimesBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *velocitiesAndTimesBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, velocityAndTimeAttribIdx, *velocitiesAndTimesBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *velocitiesAndTimesBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, velocityAndTimeAttribIdx, *velocitiesAndTimesBuffer);
 		}
 
 		if (hSizesAndAnglesBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *hSizesAndAnglesBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, hSizeAndAngleAttribIdx, *hSizesAndAnglesBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *hSizesAndAnglesBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, hSizeAndAngleAttribIdx, *hSizesAndAnglesBuffer);
 		}
 
 		if (texCoordsBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *texCoordsBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, texCoordAttribIdx, *texCoordsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *texCoordsBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, texCoordAttribIdx, *texCoordsBuffer);
 		}
 
 		if (normalsBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *normalsBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, normalAttribIdx, *normalsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *normalsBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, normalAttribIdx, *normalsBuffer);
 		}
 
 		if (instancedTransformsBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *instancedTransformsBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, instancedTransformAttribIdx, *instancedTransformsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *instancedTransformsBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, instancedTransformAttribIdx, *instancedTransformsBuffer);
 		}
 
 		if (instancedNormalTransformsBuffer)
 		{
-			glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *instancedNormalTransformsBuffer);
-			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, instancedNormalTransformAttribIdx, *instancedNormalTransformsBuffer);
+			glProxyBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, *instancedNormalTransformsBuffer);
+			glProxyBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, instancedNormalTransformAttribIdx, *instancedNormalTransformsBuffer);
 		}
 	}
 }
@@ -15,14 +15,28 @@
 #include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 
+#include <cstdint>
 #include <optional>
 #include <functional>
+#include <string>
 #include <vector>
 #include <deque>
 #include <variant>
+#include <utility>
 
 namespace Buffers
 {
+	struct UploadsCounters
+	{
+		std::uint64_t issued = 0;
+		std::uint64_t skipped = 0;
+	};
+
+	// Geometry re-uploads requested by dynamic shapes since the last reset. Skipped ones had unchanged inputs.
+	const UploadsCounters& GetUploadsCounters();
+	void ResetUploadsCounters();
+	void CountUpload(bool issued);
+
 	struct GenericSubBuffers
 	{
 		GenericSubBuffers(bool defaultVAO = false);
@@ -51,6 +65,11 @@ namespace Buffers
 
 		bool isInstancingActive() const;
 		bool isIndicingActive() const;
+		// Some attributes currently live in a region of the streaming buffer, which is reused a few frames later.
+		bool isStreamActive() const;
+		std::optional<size_t> getGeometryHash() const;
+		// Geometry hashes may collide, so this has to be checked before the geometry of one is drawn for the other.
+		bool hasSameGeometry(const GenericSubBuffers& other) const;
 
 		void swapActiveBuffers(GenericSubBuffers& other);
 
@@ -62,6 +81,10 @@ namespace Buffers
 		static constexpr unsigned normalAttribIdx = 5;
 		static constexpr unsigned instancedTransformAttribIdx = 6;
 		static constexpr unsigned instancedNormalTransformAttribIdx = 10;
+		static constexpr unsigned instancedColorAttribIdx = 13;
+
+		// Vertex data of bigger geometries is not hashed, as instancing them automatically wouldn't pay off.
+		static constexpr size_t autoInstancingMaxVertices = 64;
 
 		RenderableDef* renderable = nullptr;
 
@@ -79,6 +102,26 @@ namespace Buffers
 		std::optional<GLuint> instancedNormalTransformsBuffer;
 		std::optional<GLuint> indicesBuffer;
 
+		std::optional<size_t> positionsHash;
+		size_t colorsHash = 0;
+		size_t texCoordsHash = 0;
+		size_t indicesHash = 0;
+		std::string positionsData;
+		std::string colorsData;
+		std::string texCoordsData;
+		std::string indicesData;
+
+		// Local space bounding box of uploaded positions. Unknown if positions are generated or written by transform feedback.
+		std::optional<std::pair<glm::vec3, glm::vec3>> positionsBounds;
+
+		// Set by frustum culling for the duration of a single draw, if the part is outside of the view.
+		mutable bool culled = false;
+
+		// Per vertex attributes are written into the shared streaming buffer instead of own buffers. Requires the data to be set every frame.
+		bool streamed = false;
+		// Small geometry of auto-instancing candidates is hashed and kept for comparison when set. Others are not instanced automatically.
+		bool geometryHashed = false;
+
 	private:
 		void createPositionsBuffer(unsigned target = GL_ARRAY_BUFFER);
 		void createColorsBuffer(unsigned target = GL_ARRAY_BUFFER);
@@ -90,6 +133,9 @@ namespace Buffers
 		void createInstancedNormalTransformsBuffer(unsigned target = GL_ARRAY_BUFFER);
 		void createIndicesBuffer();
 
+		void* streamAttrib(unsigned attribIdx, GLint numOfComponents, size_t size);
+		void unstreamAttrib(unsigned attribIdx, GLint numOfComponents);
+
 		size_t numOfAllocatedPositions = 0;
 		size_t numOfAllocatedColors = 0;
 		size_t numOfAllocatedVelocitiesAndTimes = 0;
@@ -100,6 +146,7 @@ namespace Buffers
 		size_t numOfAllocatedInstancedNormalTransforms = 0;
 		size_t numOfAllocatedIndices = 0;
 		std::optional<GLenum> allocatedBufferDataUsage;
+		unsigned streamedAttribsMask = 0;
 
 		bool expired = false;
 	};
@@ -114,11 +161,16 @@ namespace Buffers
 
 		void bindActiveTFBuffers() const;
 
+		// Main part or any of subsequence parts has to be set again every frame, as its data lives in the streaming buffer.
+		bool isAnyPartStreamActive() const;
+
 		void applyComponent(auto& renderableComponent, bool staticComponent)
 		{
 			auto applyMainPart = [&]() {
 				GenericSubBuffers::renderable = &renderableComponent;
 				renderable = &renderableComponent;
+				streamed = IsStreamed(renderableComponent, staticComponent);
+				geometryHashed = IsAutoInstancingCandidate(renderableComponent, streamed);
 
 				if (!staticComponent && (!renderableComponent.isEnabled() || !renderableComponent.renderF()) && renderableComponent.loaded.buffers)
 					return;
@@ -140,6 +192,7 @@ namespace Buffers
 					auto& subBuffers = ReuseOrEmplaceBack(subsequence, subBuffersIt);
 
 					subBuffers.renderable = &renderableDef;
+					subBuffers.streamed = IsStreamed(renderableComponent, staticComponent);
 					renderableDef.loaded.subBuffers = &subBuffers;
 
 					if (!staticComponent && (!renderableComponent.isEnabled() || !renderableComponent.renderF()) && renderableComponent.loaded.buffers)
@@ -199,7 +252,7 @@ namespace Buffers
 
 			auto setAndDraw = [&](const GenericSubBuffers& buffers)
 			{
-				if (!(buffers.renderable->renderF)())
+				if (buffers.culled || !(buffers.renderable->renderF)())
 					return;
 
 				glProxyBindVertexArray(buffers.vertexArray);
@@ -218,6 +271,9 @@ namespace Buffers
 
 				postSetup(buffers);
 
+				glProxyUseProgram(program.getProgramId());
+				program.flushUniforms();
+
 				if (isInstancingActive())
 				{
 					if (isIndicingActive())
@@ -259,6 +315,23 @@ namespace Buffers
 		std::vector<glm::mat3> normalTransforms;
 
 	private:
+		// Transform feedback swaps own buffers, so its renderables are never streamed. Neither is stable geometry of components tracking its changes.
+		static bool IsStreamed(const auto& renderableComponent, bool staticComponent)
+		{
+			if constexpr (requires { renderableComponent.isGeometryVolatile(); })
+				if (!renderableComponent.isGeometryVolatile())
+					return false;
+
+			return !staticComponent && renderableComponent.bufferDataUsage == GL_STREAM_DRAW && !renderableComponent.tfShaderProgram;
+		}
+
+		// Only reorderable parts with rarely changing geometry may be batched with others, so only theirs is worth hashing and keeping.
+		static bool IsAutoInstancingCandidate(const auto& renderableComponent, bool streamed)
+		{
+			return renderableComponent.orderIndependent && !streamed && renderableComponent.bufferDataUsage == GL_STATIC_DRAW
+				&& !renderableComponent.tfShaderProgram && renderableComponent.subsequence.empty();
+		}
+
 		inline void RenderableComponentCommonsToBuffersCommons(auto& renderableDef, Buffers::GenericSubBuffers& buffers)
 		{
 			if (renderableDef.forcedPositionsCount)
@@ -0,0 +1,104 @@
+#include "streamingBuffer.hpp"
+
+namespace
+{
+	constexpr size_t allocationsAlignment = 16;
+}
+
+namespace Buffers
+{
+	StreamingBuffer::StreamingBuffer(size_t regionSize, unsigned numOfRegions):
+		regionSize(regionSize),
+		numOfRegions(numOfRegions),
+		regionsFences(numOfRegions, nullptr)
+	{
+		if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+			return;
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &buffer);
+		glProxyBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferStorage(GL_ARRAY_BUFFER, regionSize * numOfRegions, nullptr, flags);
+		mappedData = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * numOfRegions, flags));
+
+		if (!mappedData)
+		{
+			glProxyDeleteBuffers(1, &buffer);
+			buffer = 0;
+		}
+	}
+
+	StreamingBuffer::~StreamingBuffer()
+	{
+		for (auto fence : regionsFences)
+			if (fence)
+				glDeleteSync(fence);
+
+		if (!buffer)
+			return;
+
+		glProxyBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glProxyDeleteBuffers(1, &buffer);
+	}
+
+	bool StreamingBuffer::isAvailable() const
+	{
+		return mappedData;
+	}
+
+	GLuint StreamingBuffer::getBufferId() const
+	{
+		return buffer;
+	}
+
+	std::optional<StreamingBuffer::Allocation> StreamingBuffer::allocate(size_t size)
+	{
+		if (!mappedData)
+			return std::nullopt;
+
+		if (rendered)
+			nextRegion();
+
+		const size_t alignedUsage = (currentRegionUsage + allocationsAlignment - 1) / allocationsAlignment * allocationsAlignment;
+		if (alignedUsage + size > regionSize)
+			return std::nullopt;
+
+		currentRegionUsage = alignedUsage + size;
+		const size_t offset = currentRegion * regionSize + alignedUsage;
+
+		return Allocation{ mappedData + offset, (GLintptr)offset };
+	}
+
+	void StreamingBuffer::frameRendered()
+	{
+		rendered = true;
+	}
+
+	void StreamingBuffer::nextRegion()
+	{
+		rendered = false;
+
+		// Fence covers all draws issued so far, including ones of paused frames which kept using the same region.
+		regionsFences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		currentRegion = (currentRegion + 1) % numOfRegions;
+		currentRegionUsage = 0;
+
+		if (auto& fence = regionsFences[currentRegion])
+		{
+			GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			while (true)
+			{
+				const GLenum waitResult = glClientWaitSync(fence, waitFlags, 1'000'000);
+				if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED || waitResult == GL_WAIT_FAILED)
+					break;
+				waitFlags = 0;
+			}
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ogl/oglProxy.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace Buffers
+{
+	// Ring buffer for vertex data rewritten every frame. It is persistently mapped, so data is written directly into memory read by the GPU, and split
+	// into regions used by consecutive frames, each guarded by a fence, so a region is reused only after the GPU finished drawing from it.
+	class StreamingBuffer
+	{
+	public:
+		struct Allocation
+		{
+			void* data;
+			GLintptr offset;
+		};
+
+		StreamingBuffer(size_t regionSize = 4 * 1024 * 1024, unsigned numOfRegions = 3);
+		StreamingBuffer(const StreamingBuffer&) = delete;
+		~StreamingBuffer();
+
+		// Requires persistent mapping (OpenGL 4.4 or ARB_buffer_storage).
+		bool isAvailable() const;
+		GLuint getBufferId() const;
+
+		// Returns nullopt if unavailable or the region of the current frame is full, own buffers should be used then.
+		std::optional<Allocation> allocate(size_t size);
+
+		// Allocations after rendering go to the next region. Nothing is advanced if there are no new allocations, e.g. during a pause.
+		void frameRendered();
+
+	private:
+		void nextRegion();
+
+		const size_t regionSize;
+		const unsigned numOfRegions;
+
+		GLuint buffer = 0;
+		char* mappedData = nullptr;
+
+		std::vector<GLsync> regionsFences;
+		unsigned currentRegion = 0;
+		size_t currentRegionUsage = 0;
+		bool rendered = false;
+	};
+}
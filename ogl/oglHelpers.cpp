@@ -16,8 +16,8 @@ namespace Tools
 		if (!cond)
 			return;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-		glViewport(0, 0, localFbViewportSize.x, localFbViewportSize.y);
+		glProxyBindFramebuffer(fbo);
+		glProxyViewport(0, 0, localFbViewportSize.x, localFbViewportSize.y);
 	}
 
 	ConditionalScopedFramebuffer::~ConditionalScopedFramebuffer()
@@ -25,8 +25,8 @@ namespace Tools
 		if (!cond)
 			return;
 
-		glBindFramebuffer(GL_FRAMEBUFFER, defaultFBO);
-		glViewport(0, 0, defaultFbViewportSize.x, defaultFbViewportSize.y);
+		glProxyBindFramebuffer(defaultFBO);
+		glProxyViewport(0, 0, defaultFbViewportSize.x, defaultFbViewportSize.y);
 	}
 
 	void VSync(bool enabled)
@@ -1,163 +1,390 @@
 #include "oglProxy.hpp"
 
 #include <iostream>
-
-#ifndef GL_USE_PROGRAM_PROXY_OPTIMISATION_DISABLED
+#include <array>
+#include <cassert>
 
 namespace
 {
-	GLuint currentProgramId = 0;
-	GLuint currentVAO = 0;
-	bool blend = false;
-	bool depthTest = false;
-	bool cullFace = false;
-	bool pointSmooth = false;
-	bool lineSmooth = false;
-	GLfloat pointSize = 0.0f;
-	GLfloat lineWidth = 0.0f;
 	GLenum debugOutputMinSeverity = 0;
 	bool debugOutputPerformance = false;
 }
 
+#ifndef GL_USE_PROGRAM_PROXY_OPTIMISATION_DISABLED
+
+namespace
+{
+	constexpr unsigned numOfCachedTextureUnits = 32;
+
+	struct State
+	{
+		GLuint currentProgramId = 0;
+		GLuint currentVAO = 0;
+		bool blend = false;
+		bool depthTest = false;
+		bool cullFace = false;
+		bool pointSmooth = false;
+		bool lineSmooth = false;
+		GLfloat pointSize = 0.0f;
+		GLfloat lineWidth = 0.0f;
+		GLuint framebuffer = 0;
+		std::array<GLint, 4> viewport{};
+		GLenum blendSFactor = GL_ONE;
+		GLenum blendDFactor = GL_ZERO;
+		GLenum activeTexture = GL_TEXTURE0;
+		std::array<GLuint, numOfCachedTextureUnits> textures2D{};
+		GLuint arrayBuffer = 0;
+		GLuint uniformBuffer = 0;
+
+		bool operator ==(const State&) const = default;
+	};
+
+	State state;
+
+	GLuint* CachedBufferBinding(GLenum target)
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER: return &state.arrayBuffer;
+		case GL_UNIFORM_BUFFER: return &state.uniformBuffer;
+		default: return nullptr;
+		}
+	}
+
+	GLuint GetInteger(GLenum pname)
+	{
+		GLint value;
+		glGetIntegerv(pname, &value);
+		return static_cast<GLuint>(value);
+	}
+
+	GLfloat GetFloat(GLenum pname)
+	{
+		GLfloat value;
+		glGetFloatv(pname, &value);
+		return value;
+	}
+
+	// Leaves the last cached texture unit active, callers restore the cached one.
+	State ReadDriverState()
+	{
+		State driverState;
+
+		driverState.currentProgramId = GetInteger(GL_CURRENT_PROGRAM);
+		driverState.currentVAO = GetInteger(GL_VERTEX_ARRAY_BINDING);
+		driverState.blend = glIsEnabled(GL_BLEND);
+		driverState.depthTest = glIsEnabled(GL_DEPTH_TEST);
+		driverState.cullFace = glIsEnabled(GL_CULL_FACE);
+		driverState.pointSmooth = glIsEnabled(GL_POINT_SMOOTH);
+		driverState.lineSmooth = glIsEnabled(GL_LINE_SMOOTH);
+		driverState.pointSize = GetFloat(GL_POINT_SIZE);
+		driverState.lineWidth = GetFloat(GL_LINE_WIDTH);
+		driverState.framebuffer = GetInteger(GL_DRAW_FRAMEBUFFER_BINDING);
+		glGetIntegerv(GL_VIEWPORT, driverState.viewport.data());
+		driverState.blendSFactor = GetInteger(GL_BLEND_SRC_RGB);
+		driverState.blendDFactor = GetInteger(GL_BLEND_DST_RGB);
+		driverState.activeTexture = GetInteger(GL_ACTIVE_TEXTURE);
+		for (unsigned i = 0; i < numOfCachedTextureUnits; ++i)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			driverState.textures2D[i] = GetInteger(GL_TEXTURE_BINDING_2D);
+		}
+		driverState.arrayBuffer = GetInteger(GL_ARRAY_BUFFER_BINDING);
+		driverState.uniformBuffer = GetInteger(GL_UNIFORM_BUFFER_BINDING);
+
+		return driverState;
+	}
+
+	void SetCap(GLenum cap, bool enabled)
+	{
+		if (enabled)
+			glEnable(cap);
+		else
+			glDisable(cap);
+	}
+}
+
 void glProxyUseProgram(GLuint id)
 {
-	if (id != currentProgramId)
+	if (id != state.currentProgramId)
 	{
 		glUseProgram(id);
-		currentProgramId = id;
+		state.currentProgramId = id;
 	}
 }
 
 void glProxyBindVertexArray(GLuint vao)
 {
-	if (vao != currentVAO)
+	if (vao != state.currentVAO)
 	{
 		glBindVertexArray(vao);
-		currentVAO = vao;
+		state.currentVAO = vao;
 	}
 }
 
 void glProxySetBlend(bool enabled)
 {
-	if (enabled != blend)
+	if (enabled != state.blend)
 	{
-		if (enabled)
-			glEnable(GL_BLEND);
-		else
-			glDisable(GL_BLEND);
-		blend = enabled;
+		SetCap(GL_BLEND, enabled);
+		state.blend = enabled;
 	}
 }
 
 void glProxySetDepthTest(bool enabled)
 {
-	if (enabled != depthTest)
+	if (enabled != state.depthTest)
 	{
-		if (enabled)
-			glEnable(GL_DEPTH_TEST);
-		else
-			glDisable(GL_DEPTH_TEST);
-		depthTest = enabled;
+		SetCap(GL_DEPTH_TEST, enabled);
+		state.depthTest = enabled;
 	}
 }
 
 void glProxySetCullFace(bool enabled)
 {
-	if (enabled != cullFace)
+	if (enabled != state.cullFace)
 	{
-		if (enabled)
-			glEnable(GL_CULL_FACE);
-		else
-			glDisable(GL_CULL_FACE);
-		cullFace = enabled;
+		SetCap(GL_CULL_FACE, enabled);
+		state.cullFace = enabled;
 	}
 }
 
 void glProxySetPointSmooth(bool enabled)
 {
-	if (enabled != pointSmooth)
+	if (enabled != state.pointSmooth)
 	{
-		if (enabled)
-			glEnable(GL_POINT_SMOOTH);
-		else
-			glDisable(GL_POINT_SMOOTH);
-		pointSmooth = enabled;
+		SetCap(GL_POINT_SMOOTH, enabled);
+		state.pointSmooth = enabled;
 	}
 }
 
 void glProxySetLineSmooth(bool enabled)
 {
-	if (enabled != lineSmooth)
+	if (enabled != state.lineSmooth)
 	{
-		if (enabled)
-			glEnable(GL_LINE_SMOOTH);
-		else
-			glDisable(GL_LINE_SMOOTH);
-		lineSmooth = enabled;
+		SetCap(GL_LINE_SMOOTH, enabled);
+		state.lineSmooth = enabled;
 	}
 }
 
 void glProxyPointSize(GLfloat size)
 {
-	if (size != pointSize)
+	if (size != state.pointSize)
 	{
 		glPointSize(size);
-		pointSize = size;
+		state.pointSize = size;
 	}
 }
 
 void glProxyLineWidth(GLfloat width)
 {
-	if (width != lineWidth)
+	if (width != state.lineWidth)
 	{
 		glLineWidth(width);
-		lineWidth = width;
+		state.lineWidth = width;
 	}
 }
 
 GLuint glProxyGetCurrentProgramId()
 {
-	return currentProgramId;
+	return state.currentProgramId;
 }
 
 GLuint glProxyGetCurrentVertexArray()
 {
-	return currentVAO;
+	return state.currentVAO;
 }
 
 bool glProxyIsBlendEnabled()
 {
-	return blend;
+	return state.blend;
 }
 
 bool glProxyIsDepthTestEnabled()
 {
-	return depthTest;
+	return state.depthTest;
 }
 
 bool glProxyIsCullFaceEnabled()
 {
-	return cullFace;
+	return state.cullFace;
 }
 
 bool glProxyIsPointSmoothEnabled()
 {
-	return pointSmooth;
+	return state.pointSmooth;
 }
 
 bool glProxyIsLineSmoothEnabled()
 {
-	return lineSmooth;
+	return state.lineSmooth;
 }
 
 GLfloat glProxyGetPointSize()
 {
-	return pointSize;
+	return state.pointSize;
 }
 
 GLfloat glProxyGetLineWidth()
 {
-	return lineWidth;
+	return state.lineWidth;
+}
+
+void glProxyBindFramebuffer(GLuint fbo)
+{
+	if (fbo != state.framebuffer)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		state.framebuffer = fbo;
+	}
+}
+
+void glProxyViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	const std::array<GLint, 4> viewport = { x, y, width, height };
+	if (viewport != state.viewport)
+	{
+		glViewport(x, y, width, height);
+		state.viewport = viewport;
+	}
+}
+
+void glProxyBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (sfactor != state.blendSFactor || dfactor != state.blendDFactor)
+	{
+		glBlendFunc(sfactor, dfactor);
+		state.blendSFactor = sfactor;
+		state.blendDFactor = dfactor;
+	}
+}
+
+void glProxyActiveTexture(GLenum texture)
+{
+	assert(texture - GL_TEXTURE0 < numOfCachedTextureUnits);
+	if (texture != state.activeTexture)
+	{
+		glActiveTexture(texture);
+		state.activeTexture = texture;
+	}
+}
+
+void glProxyBindTexture(GLenum target, GLuint texture)
+{
+	if (target != GL_TEXTURE_2D)
+	{
+		glBindTexture(target, texture);
+		return;
+	}
+
+	auto& binding = state.textures2D[state.activeTexture - GL_TEXTURE0];
+	if (texture != binding)
+	{
+		glBindTexture(target, texture);
+		binding = texture;
+	}
+}
+
+void glProxyBindBuffer(GLenum target, GLuint buffer)
+{
+	auto* binding = CachedBufferBinding(target);
+	if (!binding)
+	{
+		glBindBuffer(target, buffer);
+		return;
+	}
+
+	if (buffer != *binding)
+	{
+		glBindBuffer(target, buffer);
+		*binding = buffer;
+	}
+}
+
+void glProxyBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	glBindBufferBase(target, index, buffer);
+
+	// Binding to an indexed binding point binds to the generic one as well.
+	if (auto* binding = CachedBufferBinding(target))
+		*binding = buffer;
+}
+
+void glProxyDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	glDeleteTextures(n, textures);
+
+	for (GLsizei i = 0; i < n; ++i)
+		for (auto& binding : state.textures2D)
+			if (binding == textures[i])
+				binding = 0;
+}
+
+void glProxyDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	glDeleteBuffers(n, buffers);
+
+	for (GLsizei i = 0; i < n; ++i)
+		for (auto* binding : { &state.arrayBuffer, &state.uniformBuffer })
+			if (*binding == buffers[i])
+				*binding = 0;
+}
+
+void glProxyDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	glDeleteFramebuffers(n, framebuffers);
+
+	for (GLsizei i = 0; i < n; ++i)
+		if (state.framebuffer == framebuffers[i])
+			state.framebuffer = 0;
+}
+
+void glProxyDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	glDeleteVertexArrays(n, arrays);
+
+	for (GLsizei i = 0; i < n; ++i)
+		if (state.currentVAO == arrays[i])
+			state.currentVAO = 0;
+}
+
+void glProxyResyncState()
+{
+	state = ReadDriverState();
+	glActiveTexture(state.activeTexture);
+}
+
+bool glProxyValidateState()
+{
+	const State driverState = ReadDriverState();
+	glActiveTexture(state.activeTexture);
+	if (driverState == state)
+		return true;
+
+	auto check = [](const char* name, const auto& cached, const auto& driver) {
+		if (cached != driver)
+			std::cout << "glProxy: " << name << " cache out of sync with the driver state" << std::endl;
+	};
+
+	check("program", state.currentProgramId, driverState.currentProgramId);
+	check("vertex array", state.currentVAO, driverState.currentVAO);
+	check("blend", state.blend, driverState.blend);
+	check("depth test", state.depthTest, driverState.depthTest);
+	check("cull face", state.cullFace, driverState.cullFace);
+	check("point smooth", state.pointSmooth, driverState.pointSmooth);
+	check("line smooth", state.lineSmooth, driverState.lineSmooth);
+	check("point size", state.pointSize, driverState.pointSize);
+	check("line width", state.lineWidth, driverState.lineWidth);
+	check("framebuffer", state.framebuffer, driverState.framebuffer);
+	check("viewport", state.viewport, driverState.viewport);
+	check("blend sfactor", state.blendSFactor, driverState.blendSFactor);
+	check("blend dfactor", state.blendDFactor, driverState.blendDFactor);
+	check("active texture", state.activeTexture, driverState.activeTexture);
+	check("2D textures", state.textures2D, driverState.textures2D);
+	check("array buffer", state.arrayBuffer, driverState.arrayBuffer);
+	check("uniform buffer", state.uniformBuffer, driverState.uniformBuffer);
+
+	return false;
 }
 
 #endif
@@ -115,6 +115,71 @@ inline GLfloat glProxyGetLineWidth()
 	GLfloat width;
 	glGetFloatv(GL_LINE_WIDTH, &width);
 	return width;
+}
+
+inline void glProxyBindFramebuffer(GLuint fbo)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
+
+inline void glProxyViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	glViewport(x, y, width, height);
+}
+
+inline void glProxyBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	glBlendFunc(sfactor, dfactor);
+}
+
+inline void glProxyActiveTexture(GLenum texture)
+{
+	glActiveTexture(texture);
+}
+
+inline void glProxyBindTexture(GLenum target, GLuint texture)
+{
+	glBindTexture(target, texture);
+}
+
+inline void glProxyBindBuffer(GLenum target, GLuint buffer)
+{
+	glBindBuffer(target, buffer);
+}
+
+inline void glProxyBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	glBindBufferBase(target, index, buffer);
+}
+
+inline void glProxyDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	glDeleteTextures(n, textures);
+}
+
+inline void glProxyDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	glDeleteBuffers(n, buffers);
+}
+
+inline void glProxyDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+	glDeleteFramebuffers(n, framebuffers);
+}
+
+inline void glProxyDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	glDeleteVertexArrays(n, arrays);
+}
+
+inline void glProxyResyncState()
+{
+}
+
+inline bool glProxyValidateState()
+{
+	return true;
+}
 
 #else
 
@@ -138,6 +203,29 @@ bool glProxyIsLineSmoothEnabled();
 GLfloat glProxyGetPointSize();
 GLfloat glProxyGetLineWidth();
 
+// Only GL_FRAMEBUFFER target, i.e. both draw and read framebuffers are bound.
+void glProxyBindFramebuffer(GLuint fbo);
+void glProxyViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void glProxyBlendFunc(GLenum sfactor, GLenum dfactor);
+void glProxyActiveTexture(GLenum texture);
+// Bindings of GL_TEXTURE_2D target are cached per texture unit, other targets are passed through.
+void glProxyBindTexture(GLenum target, GLuint texture);
+// Bindings of GL_ARRAY_BUFFER and GL_UNIFORM_BUFFER targets are cached. GL_ELEMENT_ARRAY_BUFFER binding is a part of VAO state, so it's passed through
+// like other targets.
+void glProxyBindBuffer(GLenum target, GLuint buffer);
+void glProxyBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+// Deleting bound objects resets their bindings to 0, so deletion has to go through the proxy as well.
+void glProxyDeleteTextures(GLsizei n, const GLuint* textures);
+void glProxyDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glProxyDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void glProxyDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+
+// Invalidation hook. Reloads the cache from the driver, e.g. at startup or after code bypassing the proxy modified the state.
+void glProxyResyncState();
+// Compares the cache with the driver state, printing mismatches. Slow, intended for debug builds.
+bool glProxyValidateState();
+
 #endif
 
 void glProxyEnableDebugOutput(GLenum minSeverity = GL_DEBUG_SEVERITY_LOW, bool performance = true);
@@ -37,14 +37,14 @@ namespace
 	inline void TexturedRenderInitialization(auto& shadersProgram, const auto& textureComponent,
 		glm::vec2 translate, float rotate, glm::vec2 scale, const glm::mat4& additionalTransform, unsigned textureId)
 	{
-		glActiveTexture(GL_TEXTURE0 + textureId);
-		glBindTexture(GL_TEXTURE_2D, textureComponent.loaded.textureObject);
+		glProxyActiveTexture(GL_TEXTURE0 + textureId);
+		glProxyBindTexture(GL_TEXTURE_2D, textureComponent.loaded.textureObject);
 
 		if (textureId == 0)
 			shadersProgram.numOfTextures(1);
 
 		shadersProgram.textures(textureId, textureId);
-		shadersProgram.texturesBaseTransform(textureId, Tools::TextureTransform(textureComponent)
+		shadersProgram.texturesBaseTransform(textureId, Tools::AtlasRegionTransform(textureComponent) * Tools::TextureTransform(textureComponent)
 			* Tools::TextureTransform(translate, rotate, scale) * additionalTransform);
 	}
 
@@ -54,15 +54,15 @@ namespace
 		const auto& texture = animatedTextureComponent.getTexture();
 		const auto additionalTransformation = Tools::TextureTransform(texture.translate, texture.rotate, texture.scale);
 
-		glActiveTexture(GL_TEXTURE0 + textureId);
-		glBindTexture(GL_TEXTURE_2D, texture.component->loaded.textureObject);
+		glProxyActiveTexture(GL_TEXTURE0 + textureId);
+		glProxyBindTexture(GL_TEXTURE_2D, texture.component->loaded.textureObject);
 
 		if (textureId == 0)
 			shadersProgram.numOfTextures(1);
 
 		shadersProgram.textures(textureId, textureId);
-		shadersProgram.texturesBaseTransform(textureId, animatedTextureComponent.getFrameTransformation(speedScale) * Tools::TextureTransform(*texture.component)
-			* additionalTransformation * Tools::TextureTransform(translate, rotate, scale) * additionalTransform);
+		shadersProgram.texturesBaseTransform(textureId, Tools::AtlasRegionTransform(*texture.component) * animatedTextureComponent.getFrameTransformation(speedScale)
+			* Tools::TextureTransform(*texture.component) * additionalTransformation * Tools::TextureTransform(translate, rotate, scale) * additionalTransform);
 	}
 
 	inline void BlendingTexturedRenderInitialization(auto& shadersProgram, const Components::BlendingTexture& blendingTextureComponent,
@@ -184,7 +184,7 @@ namespace Tools
 		static std::array<glm::vec3, numOfVertices> customPositions;
 
 		glProxyBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glProxyBindBuffer(GL_ARRAY_BUFFER, 0);
 
 		if (positionsGenerator)
 		{
@@ -201,8 +201,8 @@ namespace Tools
 		glVertexAttribPointer(Buffers::GenericBuffers::texCoordAttribIdx, 2, GL_FLOAT, false, 0, &defaultTexCoords);
 		glEnableVertexAttribArray(Buffers::GenericBuffers::texCoordAttribIdx);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureObject);
+		glProxyActiveTexture(GL_TEXTURE0);
+		glProxyBindTexture(GL_TEXTURE_2D, textureObject);
 		glProxyUseProgram(shadersProgram.getProgramId());
 		
 		shadersProgram.model(glm::mat4(1.0f));
@@ -214,7 +214,8 @@ namespace Tools
 		
 		if (customSetup)
 			customSetup();
-		
+
+		shadersProgram.flushUniforms();
 		glDrawArrays(GL_TRIANGLES, 0, numOfVertices);
 	}
 
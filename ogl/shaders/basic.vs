@@ -3,6 +3,7 @@
 in vec3 bPos;
 in vec4 bColor;
 layout(location = 6) in mat4 bInstancedTransform;
+layout(location = 13) in vec4 bInstancedColor;
 
 out vec4 vColor;
 
@@ -11,6 +12,6 @@ uniform mat4 vp;
 
 void main()
 {
-	vColor = bColor;
+	vColor = bColor * bInstancedColor;
 	gl_Position = vp * bInstancedTransform * model * vec4(bPos, 1.0);
 }
@@ -8,27 +8,44 @@ flat in vec3 vFlatNormal;
 
 out vec4 fColor;
 
-uniform vec4 color;
-uniform vec3 clearColor;
-uniform int numOfLights;
-uniform vec3 lightsPos[128];
-uniform vec3 lightsCol[128];
-uniform float lightsAttenuation[128];
-uniform float lightsDarkColorFactor[128];
-uniform float ambient;
-uniform float diffuse;
-uniform vec3 viewPos;
-uniform float specular;
-uniform float specularFocus;
-uniform float specularMaterialColorFactor;
-uniform vec4 illumination;
-uniform vec3 darkColor;
-uniform bool flatColor;
-uniform bool flatNormal;
-uniform bool lightModelColorNormalization;
-uniform bool lightModelEnabled;
-uniform float fogAmplification;
-uniform float forcedAlpha;
+struct Phong3DLight
+{
+	vec3 pos;
+	float attenuation;
+	vec3 col;
+	float darkColorFactor;
+};
+
+layout(std140, binding = 0) uniform Phong3DFrame
+{
+	mat4 vp;
+	vec3 viewPos;
+	int numOfLights;
+	vec3 clearColor;
+	Phong3DLight lights[128];
+};
+
+layout(std140, binding = 1) uniform Phong3DMaterial
+{
+	mat4 model;
+	mat3 normalMatrix;
+	vec4 color;
+	vec4 illumination;
+	vec3 darkColor;
+	float ambient;
+	float diffuse;
+	float specular;
+	float specularFocus;
+	float specularMaterialColorFactor;
+	float fogAmplification;
+	float forcedAlpha;
+	float alphaDiscardTreshold;
+	bool flatColor;
+	bool flatNormal;
+	bool lightModelColorNormalization;
+	bool lightModelEnabled;
+	bool gpuSideInstancedNormalTransforms;
+};
 
 float getAmbientFactor()
 {
@@ -47,7 +64,7 @@ float getSpecularFactor(const vec3 lightDir, const vec3 normal, const vec3 viewD
 
 float getLightAttenuation(int lightId)
 {
-	const float d = distance(vPos, lightsPos[lightId]) * lightsAttenuation[lightId];
+	const float d = distance(vPos, lights[lightId].pos) * lights[lightId].attenuation;
 	return 1.0 / (1.0 + d * d);
 }
 
@@ -78,9 +95,9 @@ void main()
 
 		for (int i = 0; i < numOfLights; ++i)
 		{
-			const vec3 lightDir = normalize(lightsPos[i] - vPos);
-			lightModelColor += mix(partialDarkColor, partialDarkColor * lightsDarkColorFactor[i] + vColor.rgb * color.rgb * lightsCol[i] * (getAmbientFactor() + getDiffuseFactor(lightDir, normal, frontFactor))
-				+ mix(vec3(1.0f), vColor.rgb * color.rgb, specularMaterialColorFactor) * lightsCol[i] * getSpecularFactor(lightDir, normal, viewDir, frontFactor), getLightAttenuation(i));
+			const vec3 lightDir = normalize(lights[i].pos - vPos);
+			lightModelColor += mix(partialDarkColor, partialDarkColor * lights[i].darkColorFactor + vColor.rgb * color.rgb * lights[i].col * (getAmbientFactor() + getDiffuseFactor(lightDir, normal, frontFactor))
+				+ mix(vec3(1.0f), vColor.rgb * color.rgb, specularMaterialColorFactor) * lights[i].col * getSpecularFactor(lightDir, normal, viewDir, frontFactor), getLightAttenuation(i));
 		}
 
 		if (lightModelColorNormalization)
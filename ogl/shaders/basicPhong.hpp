@@ -1,6 +1,7 @@
 #pragma once
 
 #include "programBase.hpp"
+#include "phong3DBlocks.hpp"
 
 namespace ShadersUtils
 {
@@ -8,70 +9,75 @@ namespace ShadersUtils
 	{
 		struct BasicPhongAccessor : AccessorBase
 		{
-			using AccessorBase::AccessorBase;
+			static constexpr GLuint materialBindingPoint = 1;
 
-			BasicPhongAccessor(ProgramId program):
+			BasicPhongAccessor(ProgramId program, Phong3DFrameBlock& frameBlock):
 				AccessorBase(program),
-				model(program, "model"),
-				vp(program, "vp"),
-				normalMatrix(program, "normalMatrix"),
-				color(program, "color"),
-				clearColor(program, "clearColor"),
-				numOfLights(program, "numOfLights"),
-				lightsPos(program, "lightsPos"),
-				lightsCol(program, "lightsCol"),
-				lightsAttenuation(program, "lightsAttenuation"),
-				lightsDarkColorFactor(program, "lightsDarkColorFactor"),
-				ambient(program, "ambient"),
-				diffuse(program, "diffuse"),
-				viewPos(program, "viewPos"),
-				specular(program, "specular"),
-				specularFocus(program, "specularFocus"),
-				specularMaterialColorFactor(program, "specularMaterialColorFactor"),
-				illumination(program, "illumination"),
-				darkColor(program, "darkColor"),
-				flatColor(program, "flatColor"),
-				flatNormal(program, "flatNormal"),
-				lightModelColorNormalization(program, "lightModelColorNormalization"),
-				lightModelEnabled(program, "lightModelEnabled"),
-				gpuSideInstancedNormalTransforms(program, "gpuSideInstancedNormalTransforms"),
-				fogAmplification(program, "fogAmplification"),
-				forcedAlpha(program, "forcedAlpha")
+				materialBlock(materialBindingPoint),
+				model(materialBlock, materialBlock.data.model),
+				vp(frameBlock, frameBlock.data.vp),
+				normalMatrix(materialBlock, materialBlock.data.normalMatrix),
+				color(materialBlock, materialBlock.data.color),
+				clearColor(frameBlock, frameBlock.data.clearColor),
+				numOfLights(frameBlock, frameBlock.data.numOfLights),
+				lightsPos(frameBlock, frameBlock.data.lights[0].pos, sizeof(Phong3DFrameData::Light)),
+				lightsCol(frameBlock, frameBlock.data.lights[0].col, sizeof(Phong3DFrameData::Light)),
+				lightsAttenuation(frameBlock, frameBlock.data.lights[0].attenuation, sizeof(Phong3DFrameData::Light)),
+				lightsDarkColorFactor(frameBlock, frameBlock.data.lights[0].darkColorFactor, sizeof(Phong3DFrameData::Light)),
+				ambient(materialBlock, materialBlock.data.ambient),
+				diffuse(materialBlock, materialBlock.data.diffuse),
+				viewPos(frameBlock, frameBlock.data.viewPos),
+				specular(materialBlock, materialBlock.data.specular),
+				specularFocus(materialBlock, materialBlock.data.specularFocus),
+				specularMaterialColorFactor(materialBlock, materialBlock.data.specularMaterialColorFactor),
+				illumination(materialBlock, materialBlock.data.illumination),
+				darkColor(materialBlock, materialBlock.data.darkColor),
+				flatColor(materialBlock, materialBlock.data.flatColor),
+				flatNormal(materialBlock, materialBlock.data.flatNormal),
+				lightModelColorNormalization(materialBlock, materialBlock.data.lightModelColorNormalization),
+				lightModelEnabled(materialBlock, materialBlock.data.lightModelEnabled),
+				gpuSideInstancedNormalTransforms(materialBlock, materialBlock.data.gpuSideInstancedNormalTransforms),
+				fogAmplification(materialBlock, materialBlock.data.fogAmplification),
+				forcedAlpha(materialBlock, materialBlock.data.forcedAlpha)
 			{
+				registerUniformBlock(frameBlock);
+				registerUniformBlock(materialBlock);
 			}
 
-			UniformsUtils::UniformMat4f model;
-			UniformsUtils::UniformMat4f vp;
-			UniformsUtils::UniformMat3f normalMatrix;
-			UniformsUtils::Uniform4f color;
-			UniformsUtils::Uniform3f clearColor;
-			UniformsUtils::Uniform1i numOfLights;
-			UniformsUtils::Uniform3fv<128> lightsPos;
-			UniformsUtils::Uniform3fv<128> lightsCol;
-			UniformsUtils::Uniform1fv<128> lightsAttenuation;
-			UniformsUtils::Uniform1fv<128> lightsDarkColorFactor;
-			UniformsUtils::Uniform1f ambient;
-			UniformsUtils::Uniform1f diffuse;
-			UniformsUtils::Uniform3f viewPos;
-			UniformsUtils::Uniform1f specular;
-			UniformsUtils::Uniform1f specularFocus;
-			UniformsUtils::Uniform1f specularMaterialColorFactor;
-			UniformsUtils::Uniform4f illumination;
-			UniformsUtils::Uniform3f darkColor;
-			UniformsUtils::Uniform1b flatColor;
-			UniformsUtils::Uniform1b flatNormal;
-			UniformsUtils::Uniform1b lightModelColorNormalization;
-			UniformsUtils::Uniform1b lightModelEnabled;
-			UniformsUtils::Uniform1b gpuSideInstancedNormalTransforms;
-			UniformsUtils::Uniform1f fogAmplification;
-			UniformsUtils::Uniform1f forcedAlpha;
+			Phong3DMaterialBlock materialBlock;
+
+			UniformsUtils::BlockUniform<glm::mat4> model;
+			UniformsUtils::BlockUniform<glm::mat4> vp;
+			UniformsUtils::BlockUniform<glm::mat3, glm::mat3x4> normalMatrix;
+			UniformsUtils::BlockUniform<glm::vec4> color;
+			UniformsUtils::BlockUniform<glm::vec3> clearColor;
+			UniformsUtils::BlockUniform<int> numOfLights;
+			UniformsUtils::BlockUniformArray<glm::vec3, phong3DMaxNumOfLights> lightsPos;
+			UniformsUtils::BlockUniformArray<glm::vec3, phong3DMaxNumOfLights> lightsCol;
+			UniformsUtils::BlockUniformArray<float, phong3DMaxNumOfLights> lightsAttenuation;
+			UniformsUtils::BlockUniformArray<float, phong3DMaxNumOfLights> lightsDarkColorFactor;
+			UniformsUtils::BlockUniform<float> ambient;
+			UniformsUtils::BlockUniform<float> diffuse;
+			UniformsUtils::BlockUniform<glm::vec3> viewPos;
+			UniformsUtils::BlockUniform<float> specular;
+			UniformsUtils::BlockUniform<float> specularFocus;
+			UniformsUtils::BlockUniform<float> specularMaterialColorFactor;
+			UniformsUtils::BlockUniform<glm::vec4> illumination;
+			UniformsUtils::BlockUniform<glm::vec3> darkColor;
+			UniformsUtils::BlockUniform<bool, int> flatColor;
+			UniformsUtils::BlockUniform<bool, int> flatNormal;
+			UniformsUtils::BlockUniform<bool, int> lightModelColorNormalization;
+			UniformsUtils::BlockUniform<bool, int> lightModelEnabled;
+			UniformsUtils::BlockUniform<bool, int> gpuSideInstancedNormalTransforms;
+			UniformsUtils::BlockUniform<float> fogAmplification;
+			UniformsUtils::BlockUniform<float> forcedAlpha;
 		};
 
 		struct BasicPhong : ProgramBase<BasicPhongAccessor>
 		{
-			BasicPhong():
+			BasicPhong(Phong3DFrameBlock& frameBlock):
 				ProgramBase(LinkProgram(CompileShaders("ogl/shaders/basicPhong.vs",
-					"ogl/shaders/basicPhong.fs"), { {0, "bPos"}, {1, "bColor"}, {3, "bNormal"}, {4, "bInstancedTransform"}, {8, "bInstancedNormalTransform"} }))
+					"ogl/shaders/basicPhong.fs"), { {0, "bPos"}, {1, "bColor"}, {3, "bNormal"}, {4, "bInstancedTransform"}, {8, "bInstancedNormalTransform"} }), frameBlock)
 			{
 				model(glm::mat4(1.0f));
 				vp(glm::mat4(1.0f));
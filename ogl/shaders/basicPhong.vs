@@ -12,10 +12,44 @@ flat out vec4 vFlatColor;
 out vec3 vSmoothNormal;
 flat out vec3 vFlatNormal;
 
-uniform mat4 model;
-uniform mat4 vp;
-uniform mat3 normalMatrix;
-uniform bool gpuSideInstancedNormalTransforms;
+struct Phong3DLight
+{
+	vec3 pos;
+	float attenuation;
+	vec3 col;
+	float darkColorFactor;
+};
+
+layout(std140, binding = 0) uniform Phong3DFrame
+{
+	mat4 vp;
+	vec3 viewPos;
+	int numOfLights;
+	vec3 clearColor;
+	Phong3DLight lights[128];
+};
+
+layout(std140, binding = 1) uniform Phong3DMaterial
+{
+	mat4 model;
+	mat3 normalMatrix;
+	vec4 color;
+	vec4 illumination;
+	vec3 darkColor;
+	float ambient;
+	float diffuse;
+	float specular;
+	float specularFocus;
+	float specularMaterialColorFactor;
+	float fogAmplification;
+	float forcedAlpha;
+	float alphaDiscardTreshold;
+	bool flatColor;
+	bool flatNormal;
+	bool lightModelColorNormalization;
+	bool lightModelEnabled;
+	bool gpuSideInstancedNormalTransforms;
+};
 
 void main()
 {
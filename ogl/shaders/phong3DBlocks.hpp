@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ogl/uniformBlocks.hpp>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace ShadersUtils
+{
+	namespace Programs
+	{
+		constexpr unsigned phong3DMaxNumOfLights = 128;
+
+		// Layouts have to match std140 blocks declared in Phong shaders.
+		struct Phong3DFrameData
+		{
+			struct Light
+			{
+				glm::vec3 pos;
+				float attenuation;
+				glm::vec3 col;
+				float darkColorFactor;
+			};
+
+			glm::mat4 vp;
+			glm::vec3 viewPos;
+			int numOfLights;
+			glm::vec3 clearColor;
+			float padding;
+			Light lights[phong3DMaxNumOfLights];
+		};
+		static_assert(sizeof(Phong3DFrameData) == 96 + 32 * phong3DMaxNumOfLights);
+
+		struct Phong3DMaterialData
+		{
+			glm::mat4 model;
+			glm::mat3x4 normalMatrix;
+			glm::vec4 color;
+			glm::vec4 illumination;
+			glm::vec3 darkColor;
+			float ambient;
+			float diffuse;
+			float specular;
+			float specularFocus;
+			float specularMaterialColorFactor;
+			float fogAmplification;
+			float forcedAlpha;
+			float alphaDiscardTreshold;
+			int flatColor;
+			int flatNormal;
+			int lightModelColorNormalization;
+			int lightModelEnabled;
+			int gpuSideInstancedNormalTransforms;
+		};
+		static_assert(sizeof(Phong3DMaterialData) == 208);
+
+		// Per frame data shared by all Phong programs.
+		struct Phong3DFrameBlock : UniformsUtils::UniformBlock<Phong3DFrameData>
+		{
+			static constexpr GLuint bindingPoint = 0;
+
+			Phong3DFrameBlock():
+				UniformBlock(bindingPoint)
+			{
+			}
+		};
+
+		// Per draw data, each Phong program has its own binding point.
+		using Phong3DMaterialBlock = UniformsUtils::UniformBlock<Phong3DMaterialData>;
+	}
+}
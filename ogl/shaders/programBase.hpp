@@ -2,10 +2,12 @@
 
 #include <ogl/shadersUtils.hpp>
 #include <ogl/uniformsUtils.hpp>
+#include <ogl/uniformBlocks.hpp>
 
 #include <memory>
 #include <functional>
 #include <vector>
+#include <cstddef>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -44,45 +46,89 @@ namespace ShadersUtils
 			return program != 0;
 		}
 
+		// Flat snapshot of values of checkpoint capturing uniforms and uniform blocks, in registration order.
+		using UniformsCheckpoint = std::vector<std::byte>;
+
 		void saveUniforms()
 		{
-			assert(uniformCheckpoints.empty());
-			uniformCheckpoints.reserve(uniforms.size());
-			for (auto [id, uniform] : uniforms)
-				uniformCheckpoints.push_back(uniform->getCheckpoint());
+			assert(!uniformsSaved);
+			writeUniformsCheckpoint(savedUniforms);
+			uniformsSaved = true;
 		}
 
 		void restoreUniforms()
 		{
-			assert(!uniformCheckpoints.empty());
-			for (auto& uniformCheckpoint : uniformCheckpoints)
-				uniformCheckpoint();
-			uniformCheckpoints.clear();
+			assert(uniformsSaved);
+			restoreUniformsCheckpoint(savedUniforms);
+			uniformsSaved = false;
 		}
 
-		std::vector<std::function<void()>> getUniformsCheckpoint() const
+		UniformsCheckpoint getUniformsCheckpoint()
 		{
-			std::vector<std::function<void()>> uniformCheckpoints;
-			uniformCheckpoints.reserve(uniforms.size());
-			for (auto [id, uniform] : uniforms)
-				uniformCheckpoints.push_back(uniform->getCheckpoint());
-			return uniformCheckpoints;
+			UniformsCheckpoint checkpoint;
+			writeUniformsCheckpoint(checkpoint);
+			return checkpoint;
 		}
 
-		void restoreUniformsCheckpoint(const std::vector<std::function<void()>>& uniformsCheckpoint)
+		// Only uniforms with values differing from the checkpoint are marked dirty.
+		void restoreUniformsCheckpoint(const UniformsCheckpoint& checkpoint)
 		{
-			assert(!uniformsCheckpoint.empty());
-			for (auto& uniformCheckpoint : uniformsCheckpoint)
-				uniformCheckpoint();
+			assert(checkpoint.size() == getUniformsCheckpointSize());
+			const std::byte* source = checkpoint.data();
+			for (auto* uniform : checkpointedUniforms)
+				uniform->readCheckpoint(source);
+			for (auto* uniformBlock : uniformBlocks)
+				uniformBlock->readCheckpoint(source);
+		}
+
+		// Uploads modified uniforms and uniform blocks, has to be called before drawing with the program.
+		void flushUniforms()
+		{
+			for (auto* uniform : pendingUniforms)
+				uniform->flush();
+			pendingUniforms.clear();
+
+			for (auto* uniformBlock : uniformBlocks)
+				uniformBlock->flush();
 		}
 
 	protected:
+		void registerUniformBlock(UniformsUtils::UniformBlockBase& uniformBlock)
+		{
+			uniformBlocks.push_back(&uniformBlock);
+		}
+
 		static inline std::unordered_map<ProgramId, AccessorBase*> programIdsToPrograms;
 
 	private:
+		size_t getUniformsCheckpointSize()
+		{
+			size_t size = 0;
+			for (auto* uniform : checkpointedUniforms)
+				size += uniform->getShadow().size();
+			for (auto* uniformBlock : uniformBlocks)
+				size += uniformBlock->getSize();
+			return size;
+		}
+
+		// Reuses the checkpoint's storage, so saving into the same checkpoint again doesn't allocate.
+		void writeUniformsCheckpoint(UniformsCheckpoint& checkpoint)
+		{
+			checkpoint.resize(getUniformsCheckpointSize());
+			std::byte* destination = checkpoint.data();
+			for (auto* uniform : checkpointedUniforms)
+				uniform->writeCheckpoint(destination);
+			for (auto* uniformBlock : uniformBlocks)
+				uniformBlock->writeCheckpoint(destination);
+		}
+
 		ProgramId program;
 		std::unordered_map<GLint, UniformsUtils::Uniform*> uniforms;
-		std::vector<std::function<void()>> uniformCheckpoints;
+		std::vector<UniformsUtils::Uniform*> checkpointedUniforms;
+		std::vector<UniformsUtils::Uniform*> pendingUniforms;
+		std::vector<UniformsUtils::UniformBlockBase*> uniformBlocks;
+		UniformsCheckpoint savedUniforms;
+		bool uniformsSaved = false;
 	};
 
 	class ProgramFrameSetup
@@ -103,8 +149,8 @@ namespace ShadersUtils
 	template <typename Accessor>
 	struct ProgramBase : ProgramFrameSetup, Accessor
 	{
-		ProgramBase(ProgramId program) :
-			Accessor(program)
+		ProgramBase(ProgramId program, auto&... accessorParams) :
+			Accessor(program, accessorParams...)
 		{
 			activePrograms.insert(this);
 		}
@@ -4,6 +4,7 @@ in vec3 bPos;
 in vec4 bColor;
 layout(location = 4) in vec2 bTexCoord;
 layout(location = 6) in mat4 bInstancedTransform;
+layout(location = 13) in vec4 bInstancedColor;
 
 out vec2 vPos;
 out vec4 vColor;
@@ -25,6 +26,6 @@ void main()
 		vTexCoord[i] = vec2(texturesBaseTransform[i] * texturesCustomTransform[i] * vec4(texCoord, 0.0, 1.0)) + vec2(0.5);
 
 	vPos = (bInstancedTransform * model * vec4(bPos, 1)).xy;
-	vColor = bColor;
+	vColor = bColor * bInstancedColor;
 	gl_Position = vp * bInstancedTransform * model * vec4(bPos, 1.0);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "programBase.hpp"
+#include "phong3DBlocks.hpp"
 
 namespace ShadersUtils
 {
@@ -8,14 +9,15 @@ namespace ShadersUtils
 	{
 		struct TexturedPhongAccessor : AccessorBase
 		{
-			using AccessorBase::AccessorBase;
+			static constexpr GLuint materialBindingPoint = 2;
 
-			TexturedPhongAccessor(ProgramId program) :
+			TexturedPhongAccessor(ProgramId program, Phong3DFrameBlock& frameBlock) :
 				AccessorBase(program),
-				model(program, "model"),
-				vp(program, "vp"),
-				normalMatrix(program, "normalMatrix"),
-				color(program, "color"),
+				materialBlock(materialBindingPoint),
+				model(materialBlock, materialBlock.data.model),
+				vp(frameBlock, frameBlock.data.vp),
+				normalMatrix(materialBlock, materialBlock.data.normalMatrix),
+				color(materialBlock, materialBlock.data.color),
 				mulBlendingColor(program, "mulBlendingColor"),
 				addBlendingColor(program, "addBlendingColor"),
 				numOfTextures(program, "numOfTextures"),
@@ -32,35 +34,39 @@ namespace ShadersUtils
 				fullVisibilityDistance(program, "fullVisibilityDistance"),
 				invisibilityDistance(program, "invisibilityDistance"),
 				sceneCoordTextures(program, "sceneCoordTextures"),
-				clearColor(program, "clearColor"),
-				numOfLights(program, "numOfLights"),
-				lightsPos(program, "lightsPos"),
-				lightsCol(program, "lightsCol"),
-				lightsAttenuation(program, "lightsAttenuation"),
-				lightsDarkColorFactor(program, "lightsDarkColorFactor"),
-				ambient(program, "ambient"),
-				diffuse(program, "diffuse"),
-				viewPos(program, "viewPos"),
-				specular(program, "specular"),
-				specularFocus(program, "specularFocus"),
-				specularMaterialColorFactor(program, "specularMaterialColorFactor"),
-				illumination(program, "illumination"),
-				darkColor(program, "darkColor"),
-				flatColor(program, "flatColor"),
-				flatNormal(program, "flatNormal"),
-				lightModelColorNormalization(program, "lightModelColorNormalization"),
-				lightModelEnabled(program, "lightModelEnabled"),
-				alphaDiscardTreshold(program, "alphaDiscardTreshold"),
-				gpuSideInstancedNormalTransforms(program, "gpuSideInstancedNormalTransforms"),
-				fogAmplification(program, "fogAmplification"),
-				forcedAlpha(program, "forcedAlpha")
+				clearColor(frameBlock, frameBlock.data.clearColor),
+				numOfLights(frameBlock, frameBlock.data.numOfLights),
+				lightsPos(frameBlock, frameBlock.data.lights[0].pos, sizeof(Phong3DFrameData::Light)),
+				lightsCol(frameBlock, frameBlock.data.lights[0].col, sizeof(Phong3DFrameData::Light)),
+				lightsAttenuation(frameBlock, frameBlock.data.lights[0].attenuation, sizeof(Phong3DFrameData::Light)),
+				lightsDarkColorFactor(frameBlock, frameBlock.data.lights[0].darkColorFactor, sizeof(Phong3DFrameData::Light)),
+				ambient(materialBlock, materialBlock.data.ambient),
+				diffuse(materialBlock, materialBlock.data.diffuse),
+				viewPos(frameBlock, frameBlock.data.viewPos),
+				specular(materialBlock, materialBlock.data.specular),
+				specularFocus(materialBlock, materialBlock.data.specularFocus),
+				specularMaterialColorFactor(materialBlock, materialBlock.data.specularMaterialColorFactor),
+				illumination(materialBlock, materialBlock.data.illumination),
+				darkColor(materialBlock, materialBlock.data.darkColor),
+				flatColor(materialBlock, materialBlock.data.flatColor),
+				flatNormal(materialBlock, materialBlock.data.flatNormal),
+				lightModelColorNormalization(materialBlock, materialBlock.data.lightModelColorNormalization),
+				lightModelEnabled(materialBlock, materialBlock.data.lightModelEnabled),
+				alphaDiscardTreshold(materialBlock, materialBlock.data.alphaDiscardTreshold),
+				gpuSideInstancedNormalTransforms(materialBlock, materialBlock.data.gpuSideInstancedNormalTransforms),
+				fogAmplification(materialBlock, materialBlock.data.fogAmplification),
+				forcedAlpha(materialBlock, materialBlock.data.forcedAlpha)
 			{
+				registerUniformBlock(frameBlock);
+				registerUniformBlock(materialBlock);
 			}
 
-			UniformsUtils::UniformMat4f model;
-			UniformsUtils::UniformMat4f vp;
-			UniformsUtils::UniformMat3f normalMatrix;
-			UniformsUtils::Uniform4f color;
+			Phong3DMaterialBlock materialBlock;
+
+			UniformsUtils::BlockUniform<glm::mat4> model;
+			UniformsUtils::BlockUniform<glm::mat4> vp;
+			UniformsUtils::BlockUniform<glm::mat3, glm::mat3x4> normalMatrix;
+			UniformsUtils::BlockUniform<glm::vec4> color;
 			UniformsUtils::Uniform4f mulBlendingColor;
 			UniformsUtils::Uniform4f addBlendingColor;
 			UniformsUtils::Uniform1i numOfTextures;
@@ -77,35 +83,35 @@ namespace ShadersUtils
 			UniformsUtils::Uniform1f fullVisibilityDistance;
 			UniformsUtils::Uniform1f invisibilityDistance;
 			UniformsUtils::Uniform1b sceneCoordTextures;
-			UniformsUtils::Uniform3f clearColor;
-			UniformsUtils::Uniform1i numOfLights;
-			UniformsUtils::Uniform3fv<128> lightsPos;
-			UniformsUtils::Uniform3fv<128> lightsCol;
-			UniformsUtils::Uniform1fv<128> lightsAttenuation;
-			UniformsUtils::Uniform1fv<128> lightsDarkColorFactor;
-			UniformsUtils::Uniform1f ambient;
-			UniformsUtils::Uniform1f diffuse;
-			UniformsUtils::Uniform3f viewPos;
-			UniformsUtils::Uniform1f specular;
-			UniformsUtils::Uniform1f specularFocus;
-			UniformsUtils::Uniform1f specularMaterialColorFactor;
-			UniformsUtils::Uniform4f illumination;
-			UniformsUtils::Uniform3f darkColor;
-			UniformsUtils::Uniform1b flatColor;
-			UniformsUtils::Uniform1b flatNormal;
-			UniformsUtils::Uniform1b lightModelColorNormalization;
-			UniformsUtils::Uniform1b lightModelEnabled;
-			UniformsUtils::Uniform1f alphaDiscardTreshold;
-			UniformsUtils::Uniform1b gpuSideInstancedNormalTransforms;
-			UniformsUtils::Uniform1f fogAmplification;
-			UniformsUtils::Uniform1f forcedAlpha;
+			UniformsUtils::BlockUniform<glm::vec3> clearColor;
+			UniformsUtils::BlockUniform<int> numOfLights;
+			UniformsUtils::BlockUniformArray<glm::vec3, phong3DMaxNumOfLights> lightsPos;
+			UniformsUtils::BlockUniformArray<glm::vec3, phong3DMaxNumOfLights> lightsCol;
+			UniformsUtils::BlockUniformArray<float, phong3DMaxNumOfLights> lightsAttenuation;
+			UniformsUtils::BlockUniformArray<float, phong3DMaxNumOfLights> lightsDarkColorFactor;
+			UniformsUtils::BlockUniform<float> ambient;
+			UniformsUtils::BlockUniform<float> diffuse;
+			UniformsUtils::BlockUniform<glm::vec3> viewPos;
+			UniformsUtils::BlockUniform<float> specular;
+			UniformsUtils::BlockUniform<float> specularFocus;
+			UniformsUtils::BlockUniform<float> specularMaterialColorFactor;
+			UniformsUtils::BlockUniform<glm::vec4> illumination;
+			UniformsUtils::BlockUniform<glm::vec3> darkColor;
+			UniformsUtils::BlockUniform<bool, int> flatColor;
+			UniformsUtils::BlockUniform<bool, int> flatNormal;
+			UniformsUtils::BlockUniform<bool, int> lightModelColorNormalization;
+			UniformsUtils::BlockUniform<bool, int> lightModelEnabled;
+			UniformsUtils::BlockUniform<float> alphaDiscardTreshold;
+			UniformsUtils::BlockUniform<bool, int> gpuSideInstancedNormalTransforms;
+			UniformsUtils::BlockUniform<float> fogAmplification;
+			UniformsUtils::BlockUniform<float> forcedAlpha;
 		};
 
 		struct TexturedPhong : ProgramBase<TexturedPhongAccessor>
 		{
-			TexturedPhong() :
+			TexturedPhong(Phong3DFrameBlock& frameBlock) :
 				ProgramBase(LinkProgram(CompileShaders("ogl/shaders/texturedPhong.vs",
-					"ogl/shaders/texturedPhong.fs"), { {0, "bPos"}, {1, "bColor"}, {2, "bTexCoord"}, {3, "bNormal"}, {4, "bInstancedTransform"}, {8, "bInstancedNormalTransform"} }))
+					"ogl/shaders/texturedPhong.fs"), { {0, "bPos"}, {1, "bColor"}, {2, "bTexCoord"}, {3, "bNormal"}, {4, "bInstancedTransform"}, {8, "bInstancedNormalTransform"} }), frameBlock)
 			{
 				model(glm::mat4(1.0f));
 				vp(glm::mat4(1.0f));
@@ -14,14 +14,49 @@ out vec2 vTexCoord[5];
 out vec3 vSmoothNormal;
 flat out vec3 vFlatNormal;
 
-uniform mat4 model;
-uniform mat4 vp;
-uniform mat3 normalMatrix;
+struct Phong3DLight
+{
+	vec3 pos;
+	float attenuation;
+	vec3 col;
+	float darkColorFactor;
+};
+
+layout(std140, binding = 0) uniform Phong3DFrame
+{
+	mat4 vp;
+	vec3 viewPos;
+	int numOfLights;
+	vec3 clearColor;
+	Phong3DLight lights[128];
+};
+
+layout(std140, binding = 2) uniform Phong3DMaterial
+{
+	mat4 model;
+	mat3 normalMatrix;
+	vec4 color;
+	vec4 illumination;
+	vec3 darkColor;
+	float ambient;
+	float diffuse;
+	float specular;
+	float specularFocus;
+	float specularMaterialColorFactor;
+	float fogAmplification;
+	float forcedAlpha;
+	float alphaDiscardTreshold;
+	bool flatColor;
+	bool flatNormal;
+	bool lightModelColorNormalization;
+	bool lightModelEnabled;
+	bool gpuSideInstancedNormalTransforms;
+};
+
 uniform int numOfTextures;
 uniform mat4 texturesBaseTransform[5];
 uniform mat4 texturesCustomTransform[5];
 uniform bool sceneCoordTextures;
-uniform bool gpuSideInstancedNormalTransforms;
 
 void main()
 {
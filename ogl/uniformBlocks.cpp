@@ -0,0 +1,63 @@
+#include "uniformBlocks.hpp"
+
+#include <cstring>
+
+namespace UniformsUtils
+{
+	UniformBlockBase::UniformBlockBase(GLuint bindingPoint, void* data, size_t size):
+		bindingPoint(bindingPoint),
+		data(static_cast<std::byte*>(data)),
+		size(size)
+	{
+		glGenBuffers(1, &buffer);
+		glProxyBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		glProxyBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer);
+	}
+
+	UniformBlockBase::~UniformBlockBase()
+	{
+		glProxyDeleteBuffers(1, &buffer);
+	}
+
+	GLuint UniformBlockBase::getBindingPoint() const
+	{
+		return bindingPoint;
+	}
+
+	void UniformBlockBase::markDirty()
+	{
+		dirty = true;
+	}
+
+	void UniformBlockBase::flush()
+	{
+		if (!dirty)
+			return;
+
+		glProxyBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+		dirty = false;
+	}
+
+	size_t UniformBlockBase::getSize() const
+	{
+		return size;
+	}
+
+	void UniformBlockBase::writeCheckpoint(std::byte*& destination) const
+	{
+		std::memcpy(destination, data, size);
+		destination += size;
+	}
+
+	void UniformBlockBase::readCheckpoint(const std::byte*& source)
+	{
+		if (std::memcmp(data, source, size) != 0)
+		{
+			std::memcpy(data, source, size);
+			markDirty();
+		}
+		source += size;
+	}
+}
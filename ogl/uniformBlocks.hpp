@@ -0,0 +1,128 @@
+#pragma once
+
+#include "uniformsUtils.hpp"
+
+#include "oglProxy.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+namespace UniformsUtils
+{
+	// Uniforms kept in a std140 uniform buffer bound to a fixed binding point, so the block can be shared by all programs declaring it.
+	// Setters only update the CPU side copy, which is uploaded with a single buffer write on flush. Unchanged values don't mark the block dirty.
+	class UniformBlockBase
+	{
+	public:
+		UniformBlockBase(GLuint bindingPoint, void* data, size_t size);
+		UniformBlockBase(const UniformBlockBase&) = delete;
+		~UniformBlockBase();
+
+		GLuint getBindingPoint() const;
+
+		void markDirty();
+		void flush();
+
+		template <typename Stored>
+		void set(Stored& target, const Stored& value)
+		{
+			const bool changed = target != value;
+			CountUpdate(changed);
+			if (!changed)
+				return;
+
+			target = value;
+			markDirty();
+		}
+
+		size_t getSize() const;
+		void writeCheckpoint(std::byte*& destination) const;
+		void readCheckpoint(const std::byte*& source);
+
+	private:
+		const GLuint bindingPoint;
+		std::byte* const data;
+		const size_t size;
+
+		GLuint buffer = 0;
+		bool dirty = true;
+	};
+
+	template <typename Data>
+	class UniformBlock : public UniformBlockBase
+	{
+	public:
+		UniformBlock(GLuint bindingPoint):
+			UniformBlockBase(bindingPoint, &data, sizeof(Data))
+		{
+		}
+
+		Data data{};
+	};
+
+	// Same interface as the standalone uniforms. Stored type differs if std140 layout of a value differs from the C++ one, e.g. bool or mat3.
+	template <typename Value, typename Stored = Value>
+	class BlockUniform
+	{
+	public:
+		BlockUniform(UniformBlockBase& block, Stored& stored):
+			block(block),
+			stored(stored)
+		{
+		}
+
+		void operator ()(const Value& value)
+		{
+			block.set(stored, Stored(value));
+		}
+
+		Value getValue() const
+		{
+			return Value(stored);
+		}
+
+	private:
+		UniformBlockBase& block;
+		Stored& stored;
+	};
+
+	template <typename Value, unsigned Size, typename Stored = Value>
+	class BlockUniformArray
+	{
+	public:
+		BlockUniformArray(UniformBlockBase& block, Stored& first, size_t stride):
+			block(block),
+			first(reinterpret_cast<std::byte*>(&first)),
+			stride(stride)
+		{
+		}
+
+		void operator ()(const Value& value)
+		{
+			for (unsigned i = 0; i < Size; ++i)
+				block.set(element(i), Stored(value));
+		}
+
+		void operator ()(unsigned index, const Value& value)
+		{
+			assert(index < Size);
+			block.set(element(index), Stored(value));
+		}
+
+		Value getValue(unsigned index) const
+		{
+			assert(index < Size);
+			return Value(const_cast<BlockUniformArray*>(this)->element(index));
+		}
+
+	private:
+		Stored& element(unsigned index)
+		{
+			return *reinterpret_cast<Stored*>(first + index * stride);
+		}
+
+		UniformBlockBase& block;
+		std::byte* const first;
+		const size_t stride;
+	};
+}
@@ -2,14 +2,36 @@
 
 #include "shaders/programBase.hpp"
 
+#include <cstring>
+
 namespace
 {
 	constexpr bool invalidUniformsAllowed = false;
 	constexpr bool redundantInitAllowed = false;
+
+	UniformsUtils::UpdatesCounters updatesCounters;
 }
 
 namespace UniformsUtils
 {
+	const UpdatesCounters& GetUpdatesCounters()
+	{
+		return updatesCounters;
+	}
+
+	void ResetUpdatesCounters()
+	{
+		updatesCounters = {};
+	}
+
+	void CountUpdate(bool issued)
+	{
+		if (issued)
+			++updatesCounters.issued;
+		else
+			++updatesCounters.skipped;
+	}
+
 	Uniform::Uniform() = default;
 
 	Uniform::Uniform(ShadersUtils::ProgramId programId, const std::string& uniformName, bool checkpointCapturing) :
@@ -18,14 +40,40 @@ namespace UniformsUtils
 		checkpointCapturing(checkpointCapturing)
 	{
 		assert(isValidInternal());
-		const bool firstInit = ShadersUtils::AccessorBase::programIdsToPrograms.at(programId)->uniforms.insert({ uniformId, this }).second;
+		auto* accessor = ShadersUtils::AccessorBase::programIdsToPrograms.at(programId);
+		const bool firstInit = accessor->uniforms.insert({ uniformId, this }).second;
 		assert(firstInit || redundantInitAllowed);
+		if (firstInit)
+		{
+			owner = accessor;
+			if (checkpointCapturing)
+				accessor->checkpointedUniforms.push_back(this);
+		}
+	}
+
+	Uniform::Uniform(const Uniform& other) :
+		programId(other.programId),
+		uniformId(other.uniformId),
+		checkpointCapturing(other.checkpointCapturing)
+	{
+	}
+
+	Uniform& Uniform::operator =(const Uniform& other)
+	{
+		programId = other.programId;
+		uniformId = other.uniformId;
+		checkpointCapturing = other.checkpointCapturing;
+		owner = nullptr;
+		dirty = false;
+		return *this;
 	}
 
 	void Uniform::reset(ShadersUtils::ProgramId programId, const std::string& uniformName)
 	{
 		this->programId = programId;
 		uniformId = glGetUniformLocation(programId, uniformName.c_str());
+		owner = nullptr;
+		dirty = false;
 		assert(isValidInternal());
 	}
 
@@ -41,12 +89,71 @@ namespace UniformsUtils
 			: isValid();
 	}
 
+	void Uniform::markDirty()
+	{
+		if (dirty)
+		{
+			CountUpdate(false);
+			return;
+		}
+
+		dirty = true;
+		owner->pendingUniforms.push_back(this);
+	}
+
+	void Uniform::uploadDetached()
+	{
+		if (auto programIt = ShadersUtils::AccessorBase::programIdsToPrograms.find(programId); programIt != ShadersUtils::AccessorBase::programIdsToPrograms.end())
+		{
+			const auto& uniforms = programIt->second->uniforms;
+			if (auto uniformIt = uniforms.find(uniformId); uniformIt != uniforms.end())
+				uniformIt->second->invalidate();
+		}
+
+		upload();
+		CountUpdate(true);
+	}
+
+	void Uniform::invalidate()
+	{
+		shadowValid = false;
+		dirty = false;
+	}
+
+	void Uniform::flush()
+	{
+		if (!dirty)
+			return;
+
+		upload();
+		CountUpdate(true);
+		dirty = false;
+	}
+
+	void Uniform::writeCheckpoint(std::byte*& destination)
+	{
+		const auto shadow = getShadow();
+		std::memcpy(destination, shadow.data(), shadow.size());
+		destination += shadow.size();
+	}
+
+	void Uniform::readCheckpoint(const std::byte*& source)
+	{
+		const auto shadow = getShadow();
+		if (!shadowValid || std::memcmp(shadow.data(), source, shadow.size()) != 0)
+		{
+			std::memcpy(shadow.data(), source, shadow.size());
+			shadowValid = true;
+			markDirty();
+		}
+		else
+			CountUpdate(false);
+		source += shadow.size();
+	}
+
 	void Uniform1i::operator ()(int value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform1i(uniformId, this->value);
+		set(this->value, value);
 	}
 
 	int Uniform1i::getValue() const
@@ -55,17 +162,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform1i::getCheckpoint()
+	void Uniform1i::upload()
 	{
-		return createCheckpoint(this, value);
+		glProgramUniform1i(programId, uniformId, value);
+	}
+
+	std::span<std::byte> Uniform1i::getShadow()
+	{
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform2i::operator ()(glm::ivec2 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform2i(uniformId, this->value.x, this->value.y);
+		set(this->value, value);
 	}
 
 	const glm::ivec2& Uniform2i::getValue() const
@@ -74,17 +183,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform2i::getCheckpoint()
+	void Uniform2i::upload()
 	{
-		return createCheckpoint(this, value);
+		glProgramUniform2i(programId, uniformId, value.x, value.y);
+	}
+
+	std::span<std::byte> Uniform2i::getShadow()
+	{
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform1b::operator ()(bool value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform1i(uniformId, this->value);
+		set(this->value, value);
 	}
 
 	bool Uniform1b::getValue() const
@@ -93,17 +204,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform1b::getCheckpoint()
+	void Uniform1b::upload()
 	{
-		return createCheckpoint(this, value);
+		glProgramUniform1i(programId, uniformId, value);
+	}
+
+	std::span<std::byte> Uniform1b::getShadow()
+	{
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform1f::operator ()(float value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform1f(uniformId, this->value);
+		set(this->value, value);
 	}
 
 	float Uniform1f::getValue() const
@@ -112,17 +225,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform1f::getCheckpoint()
+	void Uniform1f::upload()
 	{
-		return createCheckpoint(this, value);
+		glProgramUniform1f(programId, uniformId, value);
+	}
+
+	std::span<std::byte> Uniform1f::getShadow()
+	{
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform2f::operator ()(glm::vec2 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform2f(uniformId, this->value.x, this->value.y);
+		set(this->value, value);
 	}
 
 	const glm::vec2& Uniform2f::getValue() const
@@ -131,17 +246,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform2f::getCheckpoint()
+	void Uniform2f::upload()
+	{
+		glProgramUniform2f(programId, uniformId, value.x, value.y);
+	}
+
+	std::span<std::byte> Uniform2f::getShadow()
 	{
-		return createCheckpoint(this, value);
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform3f::operator ()(glm::vec3 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform3f(uniformId, this->value.x, this->value.y, this->value.z);
+		set(this->value, value);
 	}
 
 	const glm::vec3& Uniform3f::getValue() const
@@ -150,17 +267,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform3f::getCheckpoint()
+	void Uniform3f::upload()
 	{
-		return createCheckpoint(this, value);
+		glProgramUniform3f(programId, uniformId, value.x, value.y, value.z);
+	}
+
+	std::span<std::byte> Uniform3f::getShadow()
+	{
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void Uniform4f::operator ()(glm::vec4 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniform4f(uniformId, this->value.x, this->value.y, this->value.z, this->value.w);
+		set(this->value, value);
 	}
 
 	const glm::vec4& Uniform4f::getValue() const
@@ -169,17 +288,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> Uniform4f::getCheckpoint()
+	void Uniform4f::upload()
+	{
+		glProgramUniform4f(programId, uniformId, value.x, value.y, value.z, value.w);
+	}
+
+	std::span<std::byte> Uniform4f::getShadow()
 	{
-		return createCheckpoint(this, value);
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void UniformMat3f::operator ()(glm::mat3 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniformMatrix3fv(uniformId, 1, GL_FALSE, glm::value_ptr(this->value));
+		set(this->value, value);
 	}
 
 	const glm::mat3& UniformMat3f::getValue() const
@@ -188,17 +309,19 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> UniformMat3f::getCheckpoint()
+	void UniformMat3f::upload()
+	{
+		glProgramUniformMatrix3fv(programId, uniformId, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	std::span<std::byte> UniformMat3f::getShadow()
 	{
-		return createCheckpoint(this, value);
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 
 	void UniformMat4f::operator ()(glm::mat4 value)
 	{
-		assert(isValidInternal());
-		glProxyUseProgram(programId);
-		this->value = value;
-		glUniformMatrix4fv(uniformId, 1, GL_FALSE, glm::value_ptr(this->value));
+		set(this->value, value);
 	}
 
 	const glm::mat4& UniformMat4f::getValue() const
@@ -207,8 +330,13 @@ namespace UniformsUtils
 		return value;
 	}
 
-	std::function<void()> UniformMat4f::getCheckpoint()
+	void UniformMat4f::upload()
+	{
+		glProgramUniformMatrix4fv(programId, uniformId, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	std::span<std::byte> UniformMat4f::getShadow()
 	{
-		return createCheckpoint(this, value);
+		return std::as_writable_bytes(std::span(&value, 1));
 	}
 }
@@ -12,7 +12,9 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <array>
-#include <functional>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
 namespace ShadersUtils
 {
@@ -21,23 +23,55 @@ namespace ShadersUtils
 
 namespace UniformsUtils
 {
+	struct UpdatesCounters
+	{
+		std::uint64_t issued = 0;
+		std::uint64_t skipped = 0;
+	};
+
+	// Uniform updates since the last reset, including uniform block members. Skipped ones didn't need any GL call, because of an unchanged value
+	// or merging with a not yet flushed update.
+	const UpdatesCounters& GetUpdatesCounters();
+	void ResetUpdatesCounters();
+	void CountUpdate(bool issued);
+
+	// Uniforms created by program accessors keep a shadow copy of the value and only mark themselves dirty on change. Dirty uniforms
+	// are uploaded by the accessor's flushUniforms() right before drawing. Other instances (default constructed and reset or copies)
+	// are uploaded immediately, invalidating the shadow copy of the accessor's uniform at the same location.
 	class Uniform
 	{
 	public:
 		Uniform();
 		Uniform(ShadersUtils::ProgramId programId, const std::string& uniformName, bool checkpointCapturing = true);
+		Uniform(const Uniform& other);
+
+		Uniform& operator =(const Uniform& other);
 
 		bool isValid() const;
 		void reset(ShadersUtils::ProgramId programId, const std::string& uniformName);
 
-		virtual std::function<void()> getCheckpoint() = 0;
-
 	protected:
-		std::function<void()> createCheckpoint(auto this_, auto value)
+		template <typename Value>
+		void set(Value& stored, const Value& value)
 		{
-			if (!checkpointCapturing)
-				return []() {};
-			return [=]() { this_->operator()(value); };
+			assert(isValidInternal());
+
+			if (!owner)
+			{
+				stored = value;
+				uploadDetached();
+				return;
+			}
+
+			if (shadowValid && stored == value)
+			{
+				CountUpdate(false);
+				return;
+			}
+
+			stored = value;
+			shadowValid = true;
+			markDirty();
 		}
 
 		bool isValidInternal() const;
@@ -45,6 +79,23 @@ namespace UniformsUtils
 		ShadersUtils::ProgramId programId = 0;
 		GLint uniformId = -1;
 		bool checkpointCapturing = true;
+
+	private:
+		friend struct ShadersUtils::AccessorBase;
+
+		virtual void upload() = 0;
+		virtual std::span<std::byte> getShadow() = 0;
+
+		void markDirty();
+		void uploadDetached();
+		void invalidate();
+		void flush();
+		void writeCheckpoint(std::byte*& destination);
+		void readCheckpoint(const std::byte*& source);
+
+		ShadersUtils::AccessorBase* owner = nullptr;
+		bool shadowValid = true;
+		bool dirty = false;
 	};
 
 	class Uniform1i : public Uniform
@@ -56,9 +107,10 @@ namespace UniformsUtils
 
 		int getValue() const;
 
-		std::function<void()> getCheckpoint() override;
-
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		int value{};
 	};
 
@@ -70,27 +122,20 @@ namespace UniformsUtils
 
 		void operator ()(int value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<int, Size> values;
 			values.fill(value);
-			glUniform1iv(uniformId, Size, values.data());
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, int value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform1i(uniformId + index, value);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<int, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform1iv(uniformId, Size, this->values.data());
+			set(this->values, values);
 		}
 
 		const std::array<int, Size>& getValues() const
@@ -99,12 +144,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
+		{
+			glProgramUniform1iv(programId, uniformId, Size, values.data());
+		}
+
+		std::span<std::byte> getShadow() override
 		{
-			return createCheckpoint(this, values);
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<int, Size> values{};
 	};
 
@@ -114,12 +164,13 @@ namespace UniformsUtils
 		using Uniform::Uniform;
 
 		void operator ()(glm::ivec2 value);
-		
-		const glm::ivec2& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
+		const glm::ivec2& getValue() const;
 
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::ivec2 value{};
 	};
 
@@ -131,27 +182,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::ivec2 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::ivec2, Size> values;
 			values.fill(value);
-			glUniform2iv(uniformId, Size, &values[0][0]);
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::ivec2 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform2i(uniformId + index, value.x, value.y);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::ivec2, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform2iv(uniformId, Size, &this->values[0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::ivec2, Size>& getValues() const
@@ -160,12 +204,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniform2iv(programId, uniformId, Size, &values[0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::ivec2, Size> values{};
 	};
 
@@ -175,12 +224,13 @@ namespace UniformsUtils
 		using Uniform::Uniform;
 
 		void operator ()(bool value);
-		
-		bool getValue() const;
 
-		std::function<void()> getCheckpoint() override;
+		bool getValue() const;
 
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		bool value{};
 	};
 
@@ -192,27 +242,20 @@ namespace UniformsUtils
 
 		void operator ()(bool value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<int, Size> values;
 			values.fill(value);
-			glUniform1iv(uniformId, Size, values.data());
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, bool value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform1i(uniformId + index, value);
+			set(values[index], (int)value);
 		}
 
 		void operator ()(const std::array<int, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform1iv(uniformId, Size, this->values.data());
+			set(this->values, values);
 		}
 
 		const std::array<int, Size>& getValues() const
@@ -221,12 +264,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniform1iv(programId, uniformId, Size, values.data());
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<int, Size> values{};
 	};
 
@@ -236,12 +284,13 @@ namespace UniformsUtils
 		using Uniform::Uniform;
 
 		void operator ()(float value);
-		
-		float getValue() const;
 
-		std::function<void()> getCheckpoint() override;
+		float getValue() const;
 
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		float value{};
 	};
 
@@ -253,27 +302,20 @@ namespace UniformsUtils
 
 		void operator ()(float value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<float, Size> values;
 			values.fill(value);
-			glUniform1fv(uniformId, Size, values.data());
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, float value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform1f(uniformId + index, value);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<float, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform1fv(uniformId, Size, this->values.data());
+			set(this->values, values);
 		}
 
 		const std::array<float, Size>& getValues() const
@@ -282,12 +324,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniform1fv(programId, uniformId, Size, values.data());
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<float, Size> values{};
 	};
 
@@ -297,12 +344,13 @@ namespace UniformsUtils
 		using Uniform::Uniform;
 
 		void operator ()(glm::vec2 value);
-		
-		const glm::vec2& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
+		const glm::vec2& getValue() const;
 
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::vec2 value{};
 	};
 
@@ -314,27 +362,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::vec2 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::vec2, Size> values;
 			values.fill(value);
-			glUniform2fv(uniformId, Size, &values[0][0]);
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::vec2 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform2f(uniformId + index, value.x, value.y);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::vec2, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform2fv(uniformId, Size, &this->values[0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::vec2, Size>& getValues() const
@@ -343,12 +384,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniform2fv(programId, uniformId, Size, &values[0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::vec2, Size> values{};
 	};
 
@@ -361,9 +407,10 @@ namespace UniformsUtils
 
 		const glm::vec3& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
-
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::vec3 value{};
 	};
 
@@ -375,27 +422,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::vec3 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::vec3, Size> values;
 			values.fill(value);
-			glUniform3fv(uniformId, Size, &values[0][0]);
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::vec3 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform3f(uniformId + index, value.x, value.y, value.z);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::vec3, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform3fv(uniformId, Size, &this->values[0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::vec3, Size>& getValues() const
@@ -404,12 +444,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniform3fv(programId, uniformId, Size, &values[0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::vec3, Size> values{};
 	};
 
@@ -422,9 +467,10 @@ namespace UniformsUtils
 
 		const glm::vec4& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
-
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::vec4 value{};
 	};
 
@@ -436,27 +482,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::vec4 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::vec4, Size> values;
 			values.fill(value);
-			glUniform4fv(uniformId, Size, &values[0][0]);
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::vec4 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniform4f(uniformId + index, value.x, value.y, value.z, value.t);
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::vec4, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniform4fv(uniformId, Size, &this->values[0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::vec4, Size>& getValues() const
@@ -465,12 +504,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override  
-		{  
-			return createCheckpoint(this, values);
+	private:
+		void upload() override
+		{
+			glProgramUniform4fv(programId, uniformId, Size, &values[0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::vec4, Size> values{};
 	};
 
@@ -483,9 +527,10 @@ namespace UniformsUtils
 
 		const glm::mat3& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
-
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::mat3 value{};
 	};
 
@@ -497,27 +542,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::mat3 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::mat3, Size> values;
 			values.fill(value);
-			glUniformMatrix3fv(uniformId, Size, GL_FALSE, glm::value_ptr(values[0]));
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::mat3 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniformMatrix3fv(uniformId + index, 1, GL_FALSE, glm::value_ptr(value));
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::mat3, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniformMatrix3fv(uniformId, Size, GL_FALSE, &this->values[0][0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::mat3, Size>& getValues() const
@@ -526,12 +564,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniformMatrix3fv(programId, uniformId, Size, GL_FALSE, &values[0][0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::mat3, Size> values{};
 	};
 
@@ -544,9 +587,10 @@ namespace UniformsUtils
 
 		const glm::mat4& getValue() const;
 
-		std::function<void()> getCheckpoint() override;
-
 	private:
+		void upload() override;
+		std::span<std::byte> getShadow() override;
+
 		glm::mat4 value{};
 	};
 
@@ -558,27 +602,20 @@ namespace UniformsUtils
 
 		void operator ()(glm::mat4 value)
 		{
-			assert(isValidInternal());
-			glProxyUseProgram(programId);
+			std::array<glm::mat4, Size> values;
 			values.fill(value);
-			glUniformMatrix4fv(uniformId, Size, GL_FALSE, glm::value_ptr(values[0]));
+			set(this->values, values);
 		}
 
 		void operator ()(unsigned index, glm::mat4 value)
 		{
-			assert(isValidInternal());
 			assert(index < Size);
-			glProxyUseProgram(programId);
-			glUniformMatrix4fv(uniformId + index, 1, GL_FALSE, glm::value_ptr(value));
+			set(values[index], value);
 		}
 
 		void operator ()(const std::array<glm::mat4, Size>& values)
 		{
-			assert(isValidInternal());
-			assert(values.size() == Size);
-			glProxyUseProgram(programId);
-			this->values = values;
-			glUniformMatrix4fv(uniformId, Size, GL_FALSE, &this->values[0][0][0]);
+			set(this->values, values);
 		}
 
 		const std::array<glm::mat4, Size>& getValues() const
@@ -587,12 +624,17 @@ namespace UniformsUtils
 			return values;
 		}
 
-		std::function<void()> getCheckpoint() override
+	private:
+		void upload() override
 		{
-			return createCheckpoint(this, values);
+			glProgramUniformMatrix4fv(programId, uniformId, Size, GL_FALSE, &values[0][0][0]);
+		}
+
+		std::span<std::byte> getShadow() override
+		{
+			return std::as_writable_bytes(std::span(values));
 		}
 
-	private:
 		std::array<glm::mat4, Size> values{};
 	};
 }
@@ -40,6 +40,7 @@ namespace Systems
 		camera.details.position = glm::vec2(targetPositionAndProjectionHSize);
 		camera.details.prevPosition = camera.details.prevPosition = camera.details.position;
 		camera.details.projectionHSize = camera.details.prevProjectionHSize = targetPositionAndProjectionHSize.z;
+		camera.details.physicsStepTargetPositionAndProjectionHSize = camera.details.prevPhysicsStepTargetPositionAndProjectionHSize = targetPositionAndProjectionHSize;
 
 		camera.details.completeProjectionHSize = glm::vec2(camera.details.projectionHSize * framebufferWidthRatio, camera.details.projectionHSize * framebufferHeightRatio);
 		camera.details.prevCompleteProjectionHSize = glm::vec2(camera.details.prevProjectionHSize * framebufferWidthRatio, camera.details.prevProjectionHSize * framebufferHeightRatio);
@@ -71,7 +72,19 @@ namespace Systems
 
 		if (!paused)
 		{
-			const glm::vec3 targetPositionAndProjectionHSize = camera.targetPositionAndProjectionHSizeF();
+			const glm::vec3 targetPositionAndProjectionHSize = [&]() {
+				const glm::vec3 targetPositionAndProjectionHSize = camera.targetPositionAndProjectionHSizeF();
+				if (!physics.fixedStep.enabled)
+					return targetPositionAndProjectionHSize;
+
+				// Target usually follows bodies, which move only on fixed physics steps, so it is interpolated the same way as rendered bodies.
+				// Its previous value is stored by physics before every substep, the current one is the value after the last substep.
+				if (physics.fixedStep.substepsInLastFrame > 0)
+					camera.details.physicsStepTargetPositionAndProjectionHSize = targetPositionAndProjectionHSize;
+
+				return glm::mix(camera.details.prevPhysicsStepTargetPositionAndProjectionHSize, camera.details.physicsStepTargetPositionAndProjectionHSize,
+					physics.fixedStep.interpolationAlpha);
+			}();
 
 			camera.details.projectionHSize = camera.details.prevProjectionHSize + (targetPositionAndProjectionHSize.z - camera.details.prevProjectionHSize)
 				* std::clamp(camera.projectionTransitionFactor * physics.frameDuration, 0.0f, 1.0f);
@@ -17,6 +17,12 @@ namespace Systems
 	}
 
 	void Decorations::step()
+	{
+		stepComponents();
+		updateDynamicBuffers();
+	}
+
+	void Decorations::stepComponents()
 	{
 		for (auto& decoration: Globals::Components().staticDecorations())
 			decoration.step();
@@ -29,8 +35,6 @@ namespace Systems
 
 		for (auto& particles : Globals::Components().particles())
 			particles.step();
-
-		updateDynamicBuffers();
 	}
 
 	void Decorations::updateStaticBuffers()
@@ -10,11 +10,11 @@ namespace Systems
 		void postInit();
 		void step();
 
+		void stepComponents();
 		void updateStaticBuffers();
-
-	private:
 		void updateDynamicBuffers();
 
+	private:
 		size_t loadedStaticDecorations = 0;
 		size_t loadedStaticParticles = 0;
 	};
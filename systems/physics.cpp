@@ -1,42 +1,152 @@
 #include "physics.hpp"
 
 #include <components/physics.hpp>
+#include <components/camera2D.hpp>
 #include <components/collisionHandler.hpp>
 #include <components/collisionFilter.hpp>
 #include <components/systemInfo.hpp>
 
 #include <globals/components.hpp>
 
+#include <tools/b2Helpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 #define FORCE_REFRESH_RATE_OR_TIME_BASED_STEP 0
 
 namespace
 {
+	std::uint32_t CategoryBitsKey(unsigned short categoryBitsA, unsigned short categoryBitsB)
+	{
+		return ((std::uint32_t)std::min(categoryBitsA, categoryBitsB) << 16) | std::max(categoryBitsA, categoryBitsB);
+	}
+
+	// Lists of handlers or filters which may match fixtures of given category bits pair, in the container order. Lists are compiled on first use
+	// and dropped when the container changes. Dropped ones are retired instead of freed, as they may be still iterated by a dispatch in progress.
+	template <typename Component>
+	class CategoryBitsDispatchTable
+	{
+	public:
+		CategoryBitsDispatchTable(DynamicComponents<Component>& (Globals::ComponentsHolder::*containerAccessor)()):
+			containerAccessor(containerAccessor)
+		{
+		}
+
+		const std::vector<Component*>& get(unsigned short categoryBitsA, unsigned short categoryBitsB)
+		{
+			auto& components = (Globals::Components().*containerAccessor)();
+
+			if (components.getModificationsCount() != modificationsCount)
+			{
+				if (!keysToComponents.empty())
+					retiredKeysToComponents.push_back(std::move(keysToComponents));
+				keysToComponents.clear();
+				modificationsCount = components.getModificationsCount();
+			}
+
+			auto [it, inserted] = keysToComponents.try_emplace(CategoryBitsKey(categoryBitsA, categoryBitsB));
+			if (inserted)
+				for (auto& component : components)
+					if (component.mayHandle(categoryBitsA, categoryBitsB))
+						it->second.push_back(&component);
+
+			return it->second;
+		}
+
+		void releaseRetired()
+		{
+			retiredKeysToComponents.clear();
+		}
+
+	private:
+		using KeysToComponents = std::unordered_map<std::uint32_t, std::vector<Component*>>;
+
+		DynamicComponents<Component>& (Globals::ComponentsHolder::*containerAccessor)();
+		std::uint64_t modificationsCount = 0;
+		KeysToComponents keysToComponents;
+		// Deque keeps retired maps in place when more are retired by a nested dispatch. Vector could copy and destroy them on reallocation, as
+		// the map's move constructor is not noexcept in every standard library.
+		std::deque<KeysToComponents> retiredKeysToComponents;
+	};
+
+	CategoryBitsDispatchTable<Components::CollisionHandler> beginCollisionHandlersTable(&Globals::ComponentsHolder::beginCollisionHandlers);
+	CategoryBitsDispatchTable<Components::CollisionHandler> endCollisionHandlersTable(&Globals::ComponentsHolder::endCollisionHandlers);
+	CategoryBitsDispatchTable<Components::CollisionFilter> collisionFiltersTable(&Globals::ComponentsHolder::collisionFilters);
+
 	class : public b2ContactListener
 	{
+	public:
 		void BeginContact(b2Contact* contact) override
 		{
-			Contact(contact, Globals::Components().beginCollisionHandlers());
+			Contact(contact, true);
 		}
 
 		void EndContact(b2Contact* contact) override
 		{
-			Contact(contact, Globals::Components().endCollisionHandlers());
+			Contact(contact, false);
+		}
+
+		void dispatchBufferedContacts()
+		{
+			// Stable, so e.g. begin and end of the same pair within one step keep their order.
+			std::stable_sort(bufferedContacts.begin(), bufferedContacts.end(), [](const auto& lhs, const auto& rhs) {
+				return lhs.categoryBitsKey < rhs.categoryBitsKey;
+			});
+
+			for (const auto& bufferedContact : bufferedContacts)
+				Dispatch(*bufferedContact.fixtureA, *bufferedContact.fixtureB, bufferedContact.begin);
+
+			bufferedContacts.clear();
 		}
 
-		void Contact(b2Contact* contact, DynamicComponents<Components::CollisionHandler>& collisionHandlers)
+	private:
+		struct BufferedContact
 		{
-			for (auto& collisionHandler : collisionHandlers)
-				collisionHandler.rawHandler(*contact->GetFixtureA(), *contact->GetFixtureB());
+			b2Fixture* fixtureA;
+			b2Fixture* fixtureB;
+			std::uint32_t categoryBitsKey;
+			bool begin;
+		};
+
+		void Contact(b2Contact* contact, bool begin)
+		{
+			auto& physics = Globals::Components().physics();
+
+			// World is locked only during the step, so fixtures can't be destroyed before dispatch. Contacts ending outside of it
+			// (e.g. because of disabling a body) are dispatched immediately.
+			if (physics.batchedContacts && physics.world->IsLocked())
+			{
+				bufferedContacts.push_back({ contact->GetFixtureA(), contact->GetFixtureB(),
+					CategoryBitsKey(contact->GetFixtureA()->GetFilterData().categoryBits, contact->GetFixtureB()->GetFilterData().categoryBits), begin });
+				return;
+			}
+
+			Dispatch(*contact->GetFixtureA(), *contact->GetFixtureB(), begin);
 		}
+
+		void Dispatch(b2Fixture& fixtureA, b2Fixture& fixtureB, bool begin)
+		{
+			auto& collisionHandlersTable = begin ? beginCollisionHandlersTable : endCollisionHandlersTable;
+
+			for (auto* collisionHandler : collisionHandlersTable.get(fixtureA.GetFilterData().categoryBits, fixtureB.GetFilterData().categoryBits))
+				collisionHandler->rawHandler(fixtureA, fixtureB);
+		}
+
+		std::vector<BufferedContact> bufferedContacts;
 	} contactListener;
 
 	class : public b2ContactFilter
 	{
 		bool ShouldCollide(b2Fixture* fixtureA, b2Fixture* fixtureB) override
 		{
-			for (const auto& collisionFilter: Globals::Components().collisionFilters())
+			for (const auto* collisionFilter: collisionFiltersTable.get(fixtureA->GetFilterData().categoryBits, fixtureB->GetFilterData().categoryBits))
 			{
-				const auto result = collisionFilter.rawFilter(*fixtureA, *fixtureB);
+				const auto result = collisionFilter->rawFilter(*fixtureA, *fixtureB);
 				if (result != Components::CollisionFilter::Result::Fallback)
 					return (bool)result;
 			}
@@ -116,8 +226,80 @@ namespace Systems
 		physics.prevFrameTime = currentTime;
 		physics.simulationDuration += physics.frameDuration;
 		++physics.frameCount;
-		physics.world->Step(physics.frameDuration, physics.velocityIterationsPerStep, physics.positionIterationsPerStep);
+
+		if (physics.fixedStep.enabled)
+			fixedStep();
+		else
+			worldStep(physics.frameDuration);
 
 		physics.step();
 	}
+
+	void Physics::fixedStep() const
+	{
+		auto& physics = Globals::Components().physics();
+		auto& fixedStep = physics.fixedStep;
+
+		assert(fixedStep.rate > 0.0f);
+		assert(fixedStep.maxSubsteps > 0);
+
+		const float stepDuration = 1.0f / fixedStep.rate;
+
+		fixedStep.accumulator += physics.frameDuration;
+		fixedStep.substepsInLastFrame = 0;
+
+		// Forces are applied by game logic once per frame, so they have to last for all substeps of that frame.
+		physics.world->SetAutoClearForces(false);
+
+		while (fixedStep.accumulator >= stepDuration && fixedStep.substepsInLastFrame < fixedStep.maxSubsteps)
+		{
+			storePrevTransforms();
+			storePrevCameraTarget();
+			worldStep(stepDuration);
+			fixedStep.accumulator -= stepDuration;
+			++fixedStep.substepsInLastFrame;
+		}
+
+		physics.world->ClearForces();
+		physics.world->SetAutoClearForces(true);
+
+		// Spiral of death guard: if we couldn't catch up within maxSubsteps, the backlog is dropped instead of carried over.
+		if (fixedStep.accumulator >= stepDuration)
+			fixedStep.accumulator = std::fmod(fixedStep.accumulator, stepDuration);
+
+		fixedStep.interpolationAlpha = fixedStep.accumulator / stepDuration;
+	}
+
+	void Physics::worldStep(float duration) const
+	{
+		auto& physics = Globals::Components().physics();
+
+		beginCollisionHandlersTable.releaseRetired();
+		endCollisionHandlersTable.releaseRetired();
+		collisionFiltersTable.releaseRetired();
+
+		physics.world->Step(duration, physics.velocityIterationsPerStep, physics.positionIterationsPerStep);
+		contactListener.dispatchBufferedContacts();
+	}
+
+	void Physics::storePrevTransforms() const
+	{
+		for (auto* body = Globals::Components().physics().world->GetBodyList(); body; body = body->GetNext())
+		{
+			if (body->GetType() == b2_staticBody || !body->IsEnabled() || !body->GetUserData().pointer)
+				continue;
+
+			Tools::AccessUserData(*body).prevTransform = body->GetTransform();
+		}
+	}
+
+	// Camera target usually follows bodies, so it is interpolated between the same substeps as rendered bodies.
+	void Physics::storePrevCameraTarget() const
+	{
+		auto& camera = Globals::Components().camera2D();
+		if (!camera.isEnabled())
+			return;
+
+		camera.details.prevPhysicsStepTargetPositionAndProjectionHSize = camera.targetPositionAndProjectionHSizeF();
+	}
 }
@@ -13,5 +13,11 @@ namespace Systems
 		void postInit();
 		void teardown();
 		void step();
+
+	private:
+		void fixedStep() const;
+		void worldStep(float duration) const;
+		void storePrevTransforms() const;
+		void storePrevCameraTarget() const;
 	};
 }
@@ -22,275 +22,618 @@
 #include <globals/shaders.hpp>
 #include <globals/systems.hpp>
 #include <globals/components.hpp>
+#include <globals/profiler.hpp>
+
+#include <tools/utility.hpp>
+
+#include <commonTypes/profiler.hpp>
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace
 {
-	void BasicPhongRender(size_t layer, auto& renderTextureClearer, const auto& staticBuffers, const auto& dynamicBuffers)
+	enum class ProgramFamily
 	{
-		if (staticBuffers[layer].empty() && dynamicBuffers[layer].empty())
-			return;
+		BasicPhong,
+		TexturedPhong,
+		Basic,
+		Textured,
+		CustomShaders,
+		COUNT
+	};
+
+	// Key bits from the most significant: layer (8), target render texture (12), program family (4), material (20), geometry (20).
+	// Material and geometry are set only for order independent renderables, others keep their submission order within a target.
+	// Every renderable has its own VAO, so the geometry hash is used instead when available, which also brings instancing candidates together.
+	struct DrawItem
+	{
+		std::uint64_t sortKey;
+		unsigned sequence;
+		unsigned targetIndex;
+		ProgramFamily programFamily;
+		const Buffers::GenericBuffers* buffers;
+	};
+
+	unsigned GetMaterialId(const Renderable& renderable, ProgramFamily programFamily)
+	{
+		if (programFamily == ProgramFamily::CustomShaders)
+			return renderable.customShadersProgram ? renderable.customShadersProgram->getProgramId() : 0;
 
-		const auto& graphicsSettings = Globals::Components().graphicsSettings();
+		if (const auto* texture = std::get_if<CM::Texture>(&renderable.texture))
+			return texture->component->loaded.textureObject;
+		if (const auto* renderTexture = std::get_if<CM::RenderTexture>(&renderable.texture))
+			return renderTexture->component->loaded.textureObject;
 
-		glProxyUseProgram(Globals::Shaders().basicPhong().getProgramId());
+		return 0;
+	}
 
-		const float prevForcedAlpha = Globals::Shaders().basicPhong().forcedAlpha.getValue();
+	unsigned renderedFrameId = 0;
 
-		auto render = [&](const auto& buffers) {
-			const auto& cmTargetTextures = buffers.renderable->targetTextures;
-			const auto& cmVPs = buffers.renderable->loaded.vps;
-			assert(cmTargetTextures.size() == cmVPs.size());
-			for (size_t i = 0; i < cmTargetTextures.size(); ++i)
-			{
-				const auto& cmTargetTexture = cmTargetTextures[i];
-				const auto& cmVP = cmVPs[i];
-				assert(cmTargetTexture.isValid());
-				assert(cmVP.isValid());
-				const auto& targetTexture = *cmTargetTexture.component;
-				const auto& vp = *cmVP.component;
-				const auto& standardRenderMode = targetTexture.loaded.standardRenderMode;
-				const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
-				Tools::ConditionalScopedFramebuffer csfb(!standardRenderMode || !standardRenderMode->isMainMode(), targetTexture.loaded.fbo,
-					targetTexture.loaded.size, mainRenderTexture.loaded.fbo, mainRenderTexture.loaded.size);
-
-				renderTextureClearer.clearIfFirstOfRenderTexture(cmTargetTexture);
-
-				Globals::Shaders().basicPhong().vp(vp.getVP());
-
-				buffers.draw(Globals::Shaders().basicPhong(), [&](const auto& buffers) {
-					const auto modelMatrix = (buffers.renderable->modelMatrixF)();
-					Globals::Shaders().basicPhong().model(modelMatrix);
-					Globals::Shaders().basicPhong().normalMatrix(Globals::Components().vpDefault3D().getNormalMatrix(modelMatrix));
-					Globals::Shaders().basicPhong().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
-					Globals::Shaders().basicPhong().ambient(buffers.renderable->params3D->ambient_);
-					Globals::Shaders().basicPhong().diffuse(buffers.renderable->params3D->diffuse_);
-					Globals::Shaders().basicPhong().specular(buffers.renderable->params3D->specular_);
-					Globals::Shaders().basicPhong().specularFocus(buffers.renderable->params3D->specularFocus_);
-					Globals::Shaders().basicPhong().specularMaterialColorFactor(buffers.renderable->params3D->specularMaterialColorFactor_);
-					Globals::Shaders().basicPhong().illumination(buffers.renderable->params3D->illuminationF_.isLoaded() ? buffers.renderable->params3D->illuminationF_() : glm::vec4(0.0f));
-					Globals::Shaders().basicPhong().darkColor(buffers.renderable->params3D->darkColor_.isLoaded() ? buffers.renderable->params3D->darkColor_() : graphicsSettings.backgroundColorF());
-					Globals::Shaders().basicPhong().lightModelEnabled(buffers.renderable->params3D->lightModelEnabled_);
-					Globals::Shaders().basicPhong().gpuSideInstancedNormalTransforms(buffers.renderable->params3D->gpuSideInstancedNormalTransforms_);
-					Globals::Shaders().basicPhong().fogAmplification(buffers.renderable->params3D->fogAmplification_);
-					Globals::Shaders().basicPhong().lightModelColorNormalization(buffers.renderable->params3D->lightModelColorNormalization_);
-				}, [](auto&) {
-					Globals::Shaders().basicPhong().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
-				}, [](auto&) {}, [](auto&) {});
-			}
-		};
+	const glm::mat4& GetModelMatrix(RenderableDef& renderableDef)
+	{
+		auto& modelMatrix = renderableDef.loaded.modelMatrix;
+		if (modelMatrix.renderedFrameId != renderedFrameId)
+		{
+			modelMatrix.value = (renderableDef.modelMatrixF)();
+			modelMatrix.renderedFrameId = renderedFrameId;
+		}
 
-		for (const auto& buffers : staticBuffers[layer])
-			render(buffers);
+		return modelMatrix.value;
+	}
 
-		for (const auto& [id, buffers] : dynamicBuffers[layer])
-			render(buffers);
+	using Bounds = std::pair<glm::vec3, glm::vec3>;
 
-		Globals::Shaders().basicPhong().forcedAlpha(prevForcedAlpha);
+	glm::vec3 GetCorner(const Bounds& bounds, unsigned cornerId)
+	{
+		return { cornerId & 1 ? bounds.second.x : bounds.first.x, cornerId & 2 ? bounds.second.y : bounds.first.y,
+			cornerId & 4 ? bounds.second.z : bounds.first.z };
 	}
 
-	void TexturedPhongRender(size_t layer, auto& renderTextureClearer, const auto& staticBuffers, const auto& dynamicBuffers)
+	const Bounds& GetWorldBounds(RenderableDef& renderableDef, const Bounds& localBounds)
 	{
-		if (staticBuffers[layer].empty() && dynamicBuffers[layer].empty())
+		auto& worldBounds = renderableDef.loaded.worldBounds;
+		const auto& modelMatrix = GetModelMatrix(renderableDef);
+		if (worldBounds.valid && worldBounds.modelMatrix == modelMatrix && worldBounds.localBounds == localBounds)
+			return worldBounds.bounds;
+
+		const glm::vec3 firstCorner = modelMatrix * glm::vec4(localBounds.first, 1.0f);
+		Bounds bounds{ firstCorner, firstCorner };
+		for (unsigned cornerId = 1; cornerId < 8; ++cornerId)
+		{
+			const glm::vec3 corner = modelMatrix * glm::vec4(GetCorner(localBounds, cornerId), 1.0f);
+			bounds.first = glm::min(bounds.first, corner);
+			bounds.second = glm::max(bounds.second, corner);
+		}
+
+		worldBounds.modelMatrix = modelMatrix;
+		worldBounds.localBounds = localBounds;
+		worldBounds.bounds = bounds;
+		worldBounds.valid = true;
+
+		return worldBounds.bounds;
+	}
+
+	// Box is outside of the clip volume if all its corners are beyond the same clip plane.
+	bool IsOutsideOfClipVolume(const Bounds& bounds, const glm::mat4& vp)
+	{
+		unsigned commonOutsidePlanes = 0b111111;
+		for (unsigned cornerId = 0; cornerId < 8 && commonOutsidePlanes; ++cornerId)
+		{
+			const glm::vec4 clipCorner = vp * glm::vec4(GetCorner(bounds, cornerId), 1.0f);
+			commonOutsidePlanes &= (unsigned)(clipCorner.x < -clipCorner.w) | (unsigned)(clipCorner.x > clipCorner.w) << 1
+				| (unsigned)(clipCorner.y < -clipCorner.w) << 2 | (unsigned)(clipCorner.y > clipCorner.w) << 3
+				| (unsigned)(clipCorner.z < -clipCorner.w) << 4 | (unsigned)(clipCorner.z > clipCorner.w) << 5;
+		}
+
+		return commonOutsidePlanes;
+	}
+
+	// Positions can be moved in shaders by instancing, transform feedback, custom programs and rendering setups (e.g. VP override), so such renderables are always drawn.
+	bool IsCullable(const Renderable& renderable, ProgramFamily programFamily)
+	{
+		return Globals::Components().graphicsSettings().frustumCulling && programFamily != ProgramFamily::CustomShaders
+			&& !renderable.instancing && !renderable.tfShaderProgram;
+	}
+
+	bool IsPartVisible(const Buffers::GenericSubBuffers& buffers, const glm::mat4& vp)
+	{
+		auto& renderableDef = *buffers.renderable;
+		if (!(renderableDef.renderF)())
+			return false;
+
+		if (!buffers.positionsBounds || renderableDef.renderingSetupF || renderableDef.drawMode == GL_POINTS)
+			return true;
+
+		return !IsOutsideOfClipVolume(GetWorldBounds(renderableDef, *buffers.positionsBounds), vp);
+	}
+
+	bool IsVisible(const Buffers::GenericBuffers& buffers, ProgramFamily programFamily, const glm::mat4& vp)
+	{
+		if (!IsCullable(*buffers.renderable, programFamily) || IsPartVisible(buffers, vp))
+			return true;
+
+		return std::any_of(buffers.subsequence.begin(), buffers.subsequence.end(), [&](const auto& subBuffers) {
+			return IsPartVisible(subBuffers, vp);
+		});
+	}
+
+	// Parts of subsequence are culled individually, only for the duration of the item draw, as buffers may be drawn for multiple targets.
+	void CullSubsequenceParts(const Buffers::GenericBuffers& buffers, ProgramFamily programFamily, const glm::mat4& vp)
+	{
+		if (buffers.subsequence.empty() || !IsCullable(*buffers.renderable, programFamily))
 			return;
 
-		const auto& graphicsSettings = Globals::Components().graphicsSettings();
+		buffers.culled = !IsPartVisible(buffers, vp);
+		for (const auto& subBuffers : buffers.subsequence)
+			subBuffers.culled = !IsPartVisible(subBuffers, vp);
+	}
 
-		glProxyUseProgram(Globals::Shaders().texturedPhong().getProgramId());
+	void UncullSubsequenceParts(const Buffers::GenericBuffers& buffers)
+	{
+		buffers.culled = false;
+		for (const auto& subBuffers : buffers.subsequence)
+			subBuffers.culled = false;
+	}
+
+	// Kept across frames, so the storage is reused instead of being allocated every rendered frame, including the paused ones.
+	class RenderQueue
+	{
+	public:
+		void clear()
+		{
+			items.clear();
+			targetTextures.clear();
+			geometrySlots.clear();
+		}
+
+		void add(size_t layer, ProgramFamily programFamily, const auto& staticBuffers, const auto& dynamicBuffers)
+		{
+			for (const auto& buffers : staticBuffers[layer])
+				add(layer, programFamily, buffers);
+
+			for (const auto& [id, buffers] : dynamicBuffers[layer])
+				add(layer, programFamily, buffers);
+		}
+
+		void add(size_t layer, ProgramFamily programFamily, const Buffers::GenericBuffers& buffers)
+		{
+			const auto& renderable = *buffers.renderable;
+			if (renderable.state == ComponentState::Outdated || !renderable.isEnabled())
+				return;
 
-		const float prevForcedAlpha = Globals::Shaders().texturedPhong().forcedAlpha.getValue();
+			if (programFamily != ProgramFamily::CustomShaders)
+				assert(renderable.targetTextures.size() == renderable.loaded.vps.size());
 
-		auto render = [&](const auto& buffers) {
-			const auto& cmTargetTextures = buffers.renderable->targetTextures;
-			const auto& cmVPs = buffers.renderable->loaded.vps;
-			assert(cmTargetTextures.size() == cmVPs.size());
-			for (size_t i = 0; i < cmTargetTextures.size(); ++i)
+			const std::uint64_t stateBits = renderable.orderIndependent
+				? ((std::uint64_t)(GetMaterialId(renderable, programFamily) & 0xfffff) << 20) | getGeometrySlot(buffers)
+				: 0;
+
+			for (unsigned i = 0; i < (unsigned)renderable.targetTextures.size(); ++i)
 			{
-				const auto& cmTargetTexture = cmTargetTextures[i];
-				const auto& cmVP = cmVPs[i];
-				assert(cmTargetTexture.isValid());
-				assert(cmVP.isValid());
-				const auto& targetTexture = *cmTargetTexture.component;
-				const auto& vp = *cmVP.component;
-				const auto& standardRenderMode = targetTexture.loaded.standardRenderMode;
-				const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
-				Tools::ConditionalScopedFramebuffer csfb(!standardRenderMode || !standardRenderMode->isMainMode(), targetTexture.loaded.fbo,
-					targetTexture.loaded.size, mainRenderTexture.loaded.fbo, mainRenderTexture.loaded.size);
-
-				renderTextureClearer.clearIfFirstOfRenderTexture(cmTargetTexture);
-
-				Globals::Shaders().texturedPhong().vp(vp.getVP());
-
-				buffers.draw(Globals::Shaders().texturedPhong(), [&](const auto& buffers) {
-					const auto modelMatrix = (buffers.renderable->modelMatrixF)();
-					Globals::Shaders().texturedPhong().model(modelMatrix);
-					Globals::Shaders().texturedPhong().normalMatrix(Globals::Components().vpDefault3D().getNormalMatrix(modelMatrix));
-					Globals::Shaders().texturedPhong().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
-					Globals::Shaders().texturedPhong().ambient(buffers.renderable->params3D->ambient_);
-					Globals::Shaders().texturedPhong().diffuse(buffers.renderable->params3D->diffuse_);
-					Globals::Shaders().texturedPhong().specular(buffers.renderable->params3D->specular_);
-					Globals::Shaders().texturedPhong().specularFocus(buffers.renderable->params3D->specularFocus_);
-					Globals::Shaders().texturedPhong().specularMaterialColorFactor(buffers.renderable->params3D->specularMaterialColorFactor_);
-					Globals::Shaders().texturedPhong().illumination(buffers.renderable->params3D->illuminationF_.isLoaded() ? buffers.renderable->params3D->illuminationF_() : glm::vec4(0.0f));
-					Globals::Shaders().texturedPhong().darkColor(buffers.renderable->params3D->darkColor_.isLoaded() ? buffers.renderable->params3D->darkColor_() : graphicsSettings.backgroundColorF());
-					Globals::Shaders().texturedPhong().lightModelEnabled(buffers.renderable->params3D->lightModelEnabled_);
-					Globals::Shaders().texturedPhong().alphaDiscardTreshold(buffers.renderable->params3D->alphaDiscardTreshold_);
-					Globals::Shaders().texturedPhong().gpuSideInstancedNormalTransforms(buffers.renderable->params3D->gpuSideInstancedNormalTransforms_);
-					Globals::Shaders().texturedPhong().fogAmplification(buffers.renderable->params3D->fogAmplification_);
-					Globals::Shaders().texturedPhong().lightModelColorNormalization(buffers.renderable->params3D->lightModelColorNormalization_);
-					Tools::PrepareTexturedRender(Globals::Shaders().texturedPhong(), buffers.renderable->texture);
-				}, [](auto&) {
-					Globals::Shaders().texturedPhong().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
-				}, [](auto&) {}, [](auto&) {});
+				assert(renderable.targetTextures[i].isValid());
+				if (programFamily != ProgramFamily::CustomShaders && !IsVisible(buffers, programFamily, renderable.loaded.vps[i].component->getVP()))
+					continue;
+
+				const std::uint64_t sortKey = ((std::uint64_t)layer << 56) | ((std::uint64_t)getTargetSlot(renderable.targetTextures[i].component) << 44)
+					| ((std::uint64_t)programFamily << 40) | stateBits;
+				items.push_back({ sortKey, (unsigned)items.size(), i, programFamily, &buffers });
 			}
-		};
+		}
+
+		void sort()
+		{
+			std::sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) {
+				return std::tie(lhs.sortKey, lhs.sequence) < std::tie(rhs.sortKey, rhs.sequence);
+			});
+		}
+
+		const std::vector<DrawItem>& getItems() const
+		{
+			return items;
+		}
+
+	private:
+		unsigned getTargetSlot(const Components::RenderTexture* targetTexture)
+		{
+			// Only a handful of render textures is used as targets, so linear search is enough.
+			const auto it = std::find(targetTextures.begin(), targetTextures.end(), targetTexture);
+			if (it != targetTextures.end())
+				return (unsigned)std::distance(targetTextures.begin(), it);
+
+			assert(targetTextures.size() < 0xfff);
+			targetTextures.push_back(targetTexture);
+			return (unsigned)targetTextures.size() - 1;
+		}
+
+		// Full geometry hashes don't fit into the sort key, and truncated ones could interleave different geometries. Slots are dense ids of
+		// geometries in the order of appearance. Geometry without hash can't be instanced automatically, so it shares the last slot.
+		unsigned getGeometrySlot(const Buffers::GenericBuffers& buffers)
+		{
+			constexpr unsigned noHashSlot = 0xfffff;
+
+			const auto geometryHash = buffers.getGeometryHash();
+			if (!geometryHash)
+				return noHashSlot;
+
+			const auto [it, inserted] = geometrySlots.try_emplace(*geometryHash, (unsigned)geometrySlots.size());
+			assert(it->second < noHashSlot);
+			return it->second;
+		}
 
-		for (const auto& buffers : staticBuffers[layer])
-			render(buffers);
+		std::vector<DrawItem> items;
+		std::vector<const Components::RenderTexture*> targetTextures;
+		std::unordered_map<size_t, unsigned> geometrySlots;
+	};
 
-		for (const auto& [id, buffers] : dynamicBuffers[layer])
-			render(buffers);
+	void BasicPhongDraw(const Buffers::GenericBuffers& buffers)
+	{
+		const auto& graphicsSettings = Globals::Components().graphicsSettings();
 
-		Globals::Shaders().texturedPhong().forcedAlpha(prevForcedAlpha);
+		buffers.draw(Globals::Shaders().basicPhong(), [&](const auto& buffers) {
+			const auto& modelMatrix = GetModelMatrix(*buffers.renderable);
+			Globals::Shaders().basicPhong().model(modelMatrix);
+			Globals::Shaders().basicPhong().normalMatrix(Globals::Components().vpDefault3D().getNormalMatrix(modelMatrix));
+			Globals::Shaders().basicPhong().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
+			Globals::Shaders().basicPhong().ambient(buffers.renderable->params3D->ambient_);
+			Globals::Shaders().basicPhong().diffuse(buffers.renderable->params3D->diffuse_);
+			Globals::Shaders().basicPhong().specular(buffers.renderable->params3D->specular_);
+			Globals::Shaders().basicPhong().specularFocus(buffers.renderable->params3D->specularFocus_);
+			Globals::Shaders().basicPhong().specularMaterialColorFactor(buffers.renderable->params3D->specularMaterialColorFactor_);
+			Globals::Shaders().basicPhong().illumination(buffers.renderable->params3D->illuminationF_.isLoaded() ? buffers.renderable->params3D->illuminationF_() : glm::vec4(0.0f));
+			Globals::Shaders().basicPhong().darkColor(buffers.renderable->params3D->darkColor_.isLoaded() ? buffers.renderable->params3D->darkColor_() : graphicsSettings.backgroundColorF());
+			Globals::Shaders().basicPhong().lightModelEnabled(buffers.renderable->params3D->lightModelEnabled_);
+			Globals::Shaders().basicPhong().gpuSideInstancedNormalTransforms(buffers.renderable->params3D->gpuSideInstancedNormalTransforms_);
+			Globals::Shaders().basicPhong().fogAmplification(buffers.renderable->params3D->fogAmplification_);
+			Globals::Shaders().basicPhong().lightModelColorNormalization(buffers.renderable->params3D->lightModelColorNormalization_);
+		}, [](auto&) {
+			Globals::Shaders().basicPhong().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+		}, [](auto&) {}, [](auto&) {});
 	}
 
-	void BasicRender(size_t layer, auto& renderTextureClearer, const auto& staticBuffers, const auto& dynamicBuffers)
+	void TexturedPhongDraw(const Buffers::GenericBuffers& buffers)
 	{
-		if (staticBuffers[layer].empty() && dynamicBuffers[layer].empty())
-			return;
+		const auto& graphicsSettings = Globals::Components().graphicsSettings();
+
+		buffers.draw(Globals::Shaders().texturedPhong(), [&](const auto& buffers) {
+			const auto& modelMatrix = GetModelMatrix(*buffers.renderable);
+			Globals::Shaders().texturedPhong().model(modelMatrix);
+			Globals::Shaders().texturedPhong().normalMatrix(Globals::Components().vpDefault3D().getNormalMatrix(modelMatrix));
+			Globals::Shaders().texturedPhong().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
+			Globals::Shaders().texturedPhong().ambient(buffers.renderable->params3D->ambient_);
+			Globals::Shaders().texturedPhong().diffuse(buffers.renderable->params3D->diffuse_);
+			Globals::Shaders().texturedPhong().specular(buffers.renderable->params3D->specular_);
+			Globals::Shaders().texturedPhong().specularFocus(buffers.renderable->params3D->specularFocus_);
+			Globals::Shaders().texturedPhong().specularMaterialColorFactor(buffers.renderable->params3D->specularMaterialColorFactor_);
+			Globals::Shaders().texturedPhong().illumination(buffers.renderable->params3D->illuminationF_.isLoaded() ? buffers.renderable->params3D->illuminationF_() : glm::vec4(0.0f));
+			Globals::Shaders().texturedPhong().darkColor(buffers.renderable->params3D->darkColor_.isLoaded() ? buffers.renderable->params3D->darkColor_() : graphicsSettings.backgroundColorF());
+			Globals::Shaders().texturedPhong().lightModelEnabled(buffers.renderable->params3D->lightModelEnabled_);
+			Globals::Shaders().texturedPhong().alphaDiscardTreshold(buffers.renderable->params3D->alphaDiscardTreshold_);
+			Globals::Shaders().texturedPhong().gpuSideInstancedNormalTransforms(buffers.renderable->params3D->gpuSideInstancedNormalTransforms_);
+			Globals::Shaders().texturedPhong().fogAmplification(buffers.renderable->params3D->fogAmplification_);
+			Globals::Shaders().texturedPhong().lightModelColorNormalization(buffers.renderable->params3D->lightModelColorNormalization_);
+			Tools::PrepareTexturedRender(Globals::Shaders().texturedPhong(), buffers.renderable->texture);
+		}, [](auto&) {
+			Globals::Shaders().texturedPhong().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+		}, [](auto&) {}, [](auto&) {});
+	}
 
+	void BasicDraw(const Buffers::GenericBuffers& buffers)
+	{
 		const auto& graphicsSettings = Globals::Components().graphicsSettings();
 
-		glProxyUseProgram(Globals::Shaders().basic().getProgramId());
+		buffers.draw(Globals::Shaders().basic(), [&](const auto& buffers) {
+			Globals::Shaders().basic().model(GetModelMatrix(*buffers.renderable));
+			Globals::Shaders().basic().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
+		}, [](auto&) {
+			Globals::Shaders().basic().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+		}, [](auto&) {}, [](auto&) {});
+	}
 
-		const float prevForcedAlpha = Globals::Shaders().basic().forcedAlpha.getValue();
+	void TexturedDraw(const Buffers::GenericBuffers& buffers)
+	{
+		const auto& graphicsSettings = Globals::Components().graphicsSettings();
 
-		auto render = [&](const auto& buffers) {
-			const auto& cmTargetTextures = buffers.renderable->targetTextures;
-			const auto& cmVPs = buffers.renderable->loaded.vps;
-			assert(cmTargetTextures.size() == cmVPs.size());
-			for (size_t i = 0; i < cmTargetTextures.size(); ++i)
-			{
-				const auto& cmTargetTexture = cmTargetTextures[i];
-				const auto& cmVP = cmVPs[i];
-				assert(cmTargetTexture.isValid());
-				assert(cmVP.isValid());
-				const auto& targetTexture = *cmTargetTexture.component;
-				const auto& vp = *cmVP.component;
-				const auto& standardRenderMode = targetTexture.loaded.standardRenderMode;
-				const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
-				Tools::ConditionalScopedFramebuffer csfb(!standardRenderMode || !standardRenderMode->isMainMode(), targetTexture.loaded.fbo,
-					targetTexture.loaded.size, mainRenderTexture.loaded.fbo, mainRenderTexture.loaded.size);
+		buffers.draw(Globals::Shaders().textured(), [&](const auto& buffers) {
+			Globals::Shaders().textured().model(GetModelMatrix(*buffers.renderable));
+			Globals::Shaders().textured().visibilityCenter((buffers.renderable->originF)());
+			Globals::Shaders().textured().color(buffers.renderable->colorF.isLoaded() ? buffers.renderable->colorF() : graphicsSettings.defaultColorF());
+			Tools::PrepareTexturedRender(Globals::Shaders().textured(), buffers.renderable->texture);
+		}, [](auto&) {
+			Globals::Shaders().textured().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+		}, [](auto&) {}, [](auto&) {});
+	}
 
-				renderTextureClearer.clearIfFirstOfRenderTexture(cmTargetTexture);
+	void CustomShadersDraw(const Buffers::GenericBuffers& buffers)
+	{
+		assert(buffers.renderable->customShadersProgram);
+		glProxyUseProgram(*buffers.renderable->customShadersProgram);
 
-				Globals::Shaders().basic().vp(vp.getVP());
+		buffers.draw(*buffers.renderable->customShadersProgram, [](auto&) {}, [](auto&) {}, [](auto&) {}, [](auto&) {});
+	}
 
-				buffers.draw(Globals::Shaders().basic(), [&](const auto& buffers) {
-					Globals::Shaders().basic().model((buffers.renderable->modelMatrixF)());
-					Globals::Shaders().basic().color(buffers.renderable->colorF.isLoaded() ? (buffers.renderable->colorF)() : graphicsSettings.defaultColorF());
-				}, [](auto&) {
-					Globals::Shaders().basic().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
-				}, [](auto&) {}, [](auto&) {});
-			}
-		};
+	// Phong programs share VP through the frame uniform block.
+	size_t VPSlot(ProgramFamily programFamily)
+	{
+		return (size_t)(programFamily == ProgramFamily::TexturedPhong ? ProgramFamily::BasicPhong : programFamily);
+	}
+
+	// Returns hash of geometry and draw mode if the item may be drawn as an instance together with others of the same hash.
+	std::optional<size_t> GetAutoInstancingKey(const DrawItem& item)
+	{
+		if (item.programFamily != ProgramFamily::Basic && item.programFamily != ProgramFamily::Textured)
+			return std::nullopt;
+
+		const auto& buffers = *item.buffers;
+		const auto& renderable = *buffers.renderable;
+		if (renderable.renderingSetupF || renderable.instancing || !buffers.subsequence.empty() || buffers.isInstancingActive())
+			return std::nullopt;
 
-		for (const auto& buffers : staticBuffers[layer])
-			render(buffers);
+		// Visibility reduction depends on per renderable origin.
+		if (item.programFamily == ProgramFamily::Textured && (Globals::Shaders().textured().visibilityReduction.getValue()
+			|| std::holds_alternative<CM::AnimatedTexture>(renderable.texture) || std::holds_alternative<CM::BlendingTexture>(renderable.texture)))
+			return std::nullopt;
 
-		for (const auto& [id, buffers] : dynamicBuffers[layer])
-			render(buffers);
+		auto key = buffers.getGeometryHash();
+		if (key)
+			Tools::HashCombine(*key, renderable.drawMode);
 
-		Globals::Shaders().basic().forcedAlpha(prevForcedAlpha);
+		return key;
 	}
 
-	void TexturedRender(size_t layer, auto& renderTextureClearer, const auto& staticBuffers, const auto& dynamicBuffers)
+	bool SameTexture(const AbstractTextureComponentVariant& lhs, const AbstractTextureComponentVariant& rhs)
 	{
-		if (staticBuffers[layer].empty() && dynamicBuffers[layer].empty())
-			return;
+		if (lhs.index() != rhs.index())
+			return false;
 
+		auto sameMapping = [](const auto& lhs, const auto& rhs) {
+			return lhs.component == rhs.component && lhs.translate == rhs.translate && lhs.rotate == rhs.rotate && lhs.scale == rhs.scale;
+		};
+
+		if (const auto* texture = std::get_if<CM::Texture>(&lhs))
+			return sameMapping(*texture, std::get<CM::Texture>(rhs));
+		if (const auto* renderTexture = std::get_if<CM::RenderTexture>(&lhs))
+			return sameMapping(*renderTexture, std::get<CM::RenderTexture>(rhs));
+
+		return std::holds_alternative<std::monostate>(lhs) || std::holds_alternative<CM::DummyTexture>(lhs);
+	}
+
+	bool CanBeInstancedTogether(const DrawItem& first, size_t firstAutoInstancingKey, const DrawItem& other)
+	{
+		if (other.sortKey != first.sortKey || other.buffers->drawCount != first.buffers->drawCount)
+			return false;
+
+		const auto& firstRenderable = *first.buffers->renderable;
+		const auto& otherRenderable = *other.buffers->renderable;
+		if (firstRenderable.loaded.vps[first.targetIndex] != otherRenderable.loaded.vps[other.targetIndex])
+			return false;
+
+		if (first.programFamily == ProgramFamily::Textured && !SameTexture(firstRenderable.texture, otherRenderable.texture))
+			return false;
+
+		return GetAutoInstancingKey(other) == firstAutoInstancingKey && other.buffers->hasSameGeometry(*first.buffers);
+	}
+
+	// Model matrices and colors go to instance attributes, so the uniforms are set to identity for the whole batch.
+	void AutoInstancedDraw(const DrawItem* batchBegin, const DrawItem* batchEnd)
+	{
 		const auto& graphicsSettings = Globals::Components().graphicsSettings();
+		auto& autoInstancingBuffers = Globals::Components().renderingBuffers().autoInstancingBuffers;
 
-		glProxyUseProgram(Globals::Shaders().textured().getProgramId());
+		autoInstancingBuffers.clear();
+		for (const auto* item = batchBegin; item != batchEnd; ++item)
+		{
+			const auto& renderable = *item->buffers->renderable;
+			if (!renderable.renderF())
+				continue;
+
+			autoInstancingBuffers.addInstance(GetModelMatrix(*item->buffers->renderable), renderable.colorF.isLoaded() ? renderable.colorF() : graphicsSettings.defaultColorF());
+		}
+
+		const auto& representativeBuffers = *batchBegin->buffers;
+		if (batchBegin->programFamily == ProgramFamily::Basic)
+		{
+			auto& basic = Globals::Shaders().basic();
+			basic.model(glm::mat4(1.0f));
+			basic.color(glm::vec4(1.0f));
+			basic.forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+			autoInstancingBuffers.draw(basic, representativeBuffers);
+		}
+		else
+		{
+			auto& textured = Globals::Shaders().textured();
+			textured.model(glm::mat4(1.0f));
+			textured.color(glm::vec4(1.0f));
+			Tools::PrepareTexturedRender(textured, representativeBuffers.renderable->texture);
+			textured.forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
+			autoInstancingBuffers.draw(textured, representativeBuffers);
+		}
+	}
 
-		const float prevForcedAlpha = Globals::Shaders().textured().forcedAlpha.getValue();
+	template <typename RenderTexturesRenderer>
+	void RenderPass(const auto& staticBuffers, const auto& dynamicBuffers, auto&... renderTexturesRendererParams)
+	{
+		const auto& graphicsSettings = Globals::Components().graphicsSettings();
+		const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
+		auto& shaders = Globals::Shaders();
 
-		auto render = [&](const auto& buffers) {
-			const auto& cmTargetTextures = buffers.renderable->targetTextures;
-			const auto& cmVPs = buffers.renderable->loaded.vps;
-			assert(cmTargetTextures.size() == cmVPs.size());
-			for (size_t i = 0; i < cmTargetTextures.size(); ++i)
+		static RenderQueue renderQueue;
+		renderQueue.clear();
+		{
+			const auto profilerZone = Globals::Profiler().zone("renderQueueBuild");
+
+			for (size_t layer = 0; layer < (size_t)RenderLayer::COUNT; ++layer)
 			{
-				const auto& cmTargetTexture = cmTargetTextures[i];
-				const auto& cmVP = cmVPs[i];
-				assert(cmTargetTexture.isValid());
-				assert(cmVP.isValid());
-				const auto& targetTexture = *cmTargetTexture.component;
-				const auto& vp = *cmVP.component;
-				const auto& standardRenderMode = targetTexture.loaded.standardRenderMode;
-				const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
-				Tools::ConditionalScopedFramebuffer csfb(!standardRenderMode || !standardRenderMode->isMainMode(), targetTexture.loaded.fbo,
-					targetTexture.loaded.size, mainRenderTexture.loaded.fbo, mainRenderTexture.loaded.size);
-
-				renderTextureClearer.clearIfFirstOfRenderTexture(cmTargetTexture);
-
-				Globals::Shaders().textured().vp(vp.getVP());
-
-				buffers.draw(Globals::Shaders().textured(), [&](const auto& buffers) {
-					Globals::Shaders().textured().model((buffers.renderable->modelMatrixF)());
-					Globals::Shaders().textured().visibilityCenter((buffers.renderable->originF)());
-					Globals::Shaders().textured().color(buffers.renderable->colorF.isLoaded() ? buffers.renderable->colorF() : graphicsSettings.defaultColorF());
-					Tools::PrepareTexturedRender(Globals::Shaders().textured(), buffers.renderable->texture);
-				}, [](auto&) {
-					Globals::Shaders().textured().forcedAlpha(!glProxyIsBlendEnabled() * 2 - 1.0f);
-				}, [](auto&) {}, [](auto&) {});
+				renderQueue.add(layer, ProgramFamily::BasicPhong, staticBuffers.basicPhong, dynamicBuffers.basicPhong);
+				renderQueue.add(layer, ProgramFamily::TexturedPhong, staticBuffers.texturedPhong, dynamicBuffers.texturedPhong);
+				renderQueue.add(layer, ProgramFamily::Basic, staticBuffers.basic, dynamicBuffers.basic);
+				renderQueue.add(layer, ProgramFamily::Textured, staticBuffers.textured, dynamicBuffers.textured);
+				renderQueue.add(layer, ProgramFamily::CustomShaders, staticBuffers.customShaders, dynamicBuffers.customShaders);
 			}
+
+			renderQueue.sort();
+		}
+
+		auto restoreDepthTest = [&]() {
+			if (!graphicsSettings.forcedDepthTest)
+				glProxySetDepthTest(graphicsSettings.force3D);
 		};
 
-		for (const auto& buffers : staticBuffers[layer])
-			render(buffers);
+		if (renderQueue.getItems().empty())
+		{
+			restoreDepthTest();
+			return;
+		}
 
-		for (const auto& [id, buffers] : dynamicBuffers[layer])
-			render(buffers);
+		const auto profilerZone = Globals::Profiler().zone("renderQueueDraw");
 
-		Globals::Shaders().textured().forcedAlpha(prevForcedAlpha);
-	}
+		const float prevForcedAlphas[] = { shaders.basicPhong().forcedAlpha.getValue(), shaders.texturedPhong().forcedAlpha.getValue(),
+			shaders.basic().forcedAlpha.getValue(), shaders.textured().forcedAlpha.getValue() };
 
-	void CustomShadersRender(size_t layer, auto& renderTextureClearer, const auto& staticBuffers, const auto& dynamicBuffers)
-	{
-		if (staticBuffers[layer].empty() && dynamicBuffers[layer].empty())
-			return;
+		std::optional<RenderTexturesRenderer> renderTexturesRenderer;
+		std::optional<size_t> currentLayer;
+		const Components::RenderTexture* currentTargetTexture = nullptr;
+		bool targetFramebufferBound = false;
+		std::optional<ProgramFamily> currentProgramFamily;
+		std::array<const Components::VP*, (size_t)ProgramFamily::COUNT> currentVPs{};
+
+		auto restoreMainFramebuffer = [&]() {
+			if (!targetFramebufferBound)
+				return;
 
-		auto render = [&](const auto& buffers) {
-			const auto& cmTargetTextures = buffers.renderable->targetTextures;
-			//const auto& cmVPs = buffers.renderable->loaded.vps;
-			//assert(cmTargetTextures.size() == cmVPs.size());
-			for (size_t i = 0; i < cmTargetTextures.size(); ++i)
+			glProxyBindFramebuffer(mainRenderTexture.loaded.fbo);
+			glProxyViewport(0, 0, mainRenderTexture.loaded.size.x, mainRenderTexture.loaded.size.y);
+			targetFramebufferBound = false;
+		};
+
+		const auto& items = renderQueue.getItems();
+		for (size_t itemId = 0; itemId < items.size(); ++itemId)
+		{
+			const auto& item = items[itemId];
+			const auto& renderable = *item.buffers->renderable;
+			const auto& cmTargetTexture = renderable.targetTextures[item.targetIndex];
+			const size_t layer = item.sortKey >> 56;
+
+			// Render textures of a layer are composed when its renderer is destroyed, as it was done before sorting.
+			if (layer != currentLayer)
+			{
+				restoreMainFramebuffer();
+				renderTexturesRenderer.reset();
+				renderTexturesRenderer.emplace(renderTexturesRendererParams...);
+				currentLayer = layer;
+				currentTargetTexture = nullptr;
+				currentProgramFamily = std::nullopt;
+				// Composing render textures resets VP of the textured program.
+				currentVPs = {};
+			}
+
+			if (cmTargetTexture.component != currentTargetTexture)
 			{
-				const auto& cmTargetTexture = cmTargetTextures[i];
-				//const auto& cmVP = cmVPs[i];
-				assert(cmTargetTexture.isValid());
-				//assert(cmVP.isValid());
 				const auto& targetTexture = *cmTargetTexture.component;
-				//const auto& vp = *cmVP.component;
 				const auto& standardRenderMode = targetTexture.loaded.standardRenderMode;
-				const auto& mainRenderTexture = Globals::Components().standardRenderTexture();
-				Tools::ConditionalScopedFramebuffer csfb(!standardRenderMode || !standardRenderMode->isMainMode(), targetTexture.loaded.fbo,
-					targetTexture.loaded.size, mainRenderTexture.loaded.fbo, mainRenderTexture.loaded.size);
+				if (!standardRenderMode || !standardRenderMode->isMainMode())
+				{
+					glProxyBindFramebuffer(targetTexture.loaded.fbo);
+					glProxyViewport(0, 0, targetTexture.loaded.size.x, targetTexture.loaded.size.y);
+					targetFramebufferBound = true;
+				}
+				else
+					restoreMainFramebuffer();
+
+				renderTexturesRenderer->clearIfFirstOfRenderTexture(cmTargetTexture);
+				currentTargetTexture = cmTargetTexture.component;
+			}
 
-				renderTextureClearer.clearIfFirstOfRenderTexture(cmTargetTexture);
+			if (item.programFamily != currentProgramFamily)
+			{
+				if (!graphicsSettings.forcedDepthTest)
+					glProxySetDepthTest(item.programFamily == ProgramFamily::BasicPhong || item.programFamily == ProgramFamily::TexturedPhong
+						? true : graphicsSettings.force3D);
+				currentProgramFamily = item.programFamily;
+			}
 
-				assert(buffers.renderable->customShadersProgram);
-				glProxyUseProgram(*buffers.renderable->customShadersProgram);
+			auto setVP = [&](auto& shadersProgram) {
+				glProxyUseProgram(shadersProgram.getProgramId());
 
-				buffers.draw(*buffers.renderable->customShadersProgram, [](auto&) {}, [](auto&) {}, [](auto&) {}, [](auto&) {});
+				const auto& cmVP = renderable.loaded.vps[item.targetIndex];
+				assert(cmVP.isValid());
+				if (auto& currentVP = currentVPs[VPSlot(item.programFamily)]; currentVP != cmVP.component)
+				{
+					shadersProgram.vp(cmVP.component->getVP());
+					currentVP = cmVP.component;
+				}
+			};
+
+			// Consecutive items of the same geometry and material are drawn as instances, so the order within a target is preserved.
+			size_t batchEnd = itemId + 1;
+			if (const auto autoInstancingKey = GetAutoInstancingKey(item))
+				while (batchEnd < items.size() && CanBeInstancedTogether(item, *autoInstancingKey, items[batchEnd]))
+					++batchEnd;
+
+			if (batchEnd - itemId > 1)
+			{
+				if (item.programFamily == ProgramFamily::Basic)
+					setVP(shaders.basic());
+				else
+					setVP(shaders.textured());
+
+				AutoInstancedDraw(&items[itemId], items.data() + batchEnd);
+				itemId = batchEnd - 1;
+				continue;
+			}
+
+			if (item.programFamily != ProgramFamily::CustomShaders)
+				CullSubsequenceParts(*item.buffers, item.programFamily, renderable.loaded.vps[item.targetIndex].component->getVP());
+
+			switch (item.programFamily)
+			{
+			case ProgramFamily::BasicPhong:
+				setVP(shaders.basicPhong());
+				BasicPhongDraw(*item.buffers);
+				break;
+			case ProgramFamily::TexturedPhong:
+				setVP(shaders.texturedPhong());
+				TexturedPhongDraw(*item.buffers);
+				break;
+			case ProgramFamily::Basic:
+				setVP(shaders.basic());
+				BasicDraw(*item.buffers);
+				break;
+			case ProgramFamily::Textured:
+				setVP(shaders.textured());
+				TexturedDraw(*item.buffers);
+				break;
+			case ProgramFamily::CustomShaders:
+				CustomShadersDraw(*item.buffers);
+				break;
+			default:
+				assert(!"unsupported program family");
 			}
-		};
 
-		for (const auto& buffers : staticBuffers[layer])
-			render(buffers);
+			UncullSubsequenceParts(*item.buffers);
 
-		for (const auto& [id, buffers] : dynamicBuffers[layer])
-			render(buffers);
+			// Rendering setup may set any uniform, including VP.
+			if (renderable.renderingSetupF)
+				currentVPs[VPSlot(item.programFamily)] = nullptr;
+		}
+
+		restoreMainFramebuffer();
+		renderTexturesRenderer.reset();
+		restoreDepthTest();
+
+		shaders.basicPhong().forcedAlpha(prevForcedAlphas[0]);
+		shaders.texturedPhong().forcedAlpha(prevForcedAlphas[1]);
+		shaders.basic().forcedAlpha(prevForcedAlphas[2]);
+		shaders.textured().forcedAlpha(prevForcedAlphas[3]);
 	}
 
 	void TransformFeedbackRender()
@@ -301,6 +644,8 @@ namespace
 		if (staticTFBuffers.empty() && dynamicTFBuffers.empty())
 			return;
 
+		const auto profilerZone = Globals::Profiler().zone("TransformFeedbackRender", true);
+
 		auto render = [&](const auto& sourceBuffers, const auto& tfBuffers) {
 			assert(sourceBuffers.renderable == tfBuffers.renderable);
 			const auto& renderable = *sourceBuffers.renderable;
@@ -349,6 +694,10 @@ namespace Systems
 
 	void RenderingController::render() const
 	{
+		const auto profilerZone = Globals::Profiler().zone("render");
+
+		++renderedFrameId;
+
 		const auto& graphicsSettings = Globals::Components().graphicsSettings();
 		const auto clearColor = graphicsSettings.backgroundColorF();
 		const auto& screenInfo = Globals::Components().systemInfo().screen;
@@ -372,63 +721,48 @@ namespace Systems
 		glProxyPointSize(graphicsSettings.pointSize);
 		glProxyLineWidth(graphicsSettings.lineWidth);
 
+		// Lights and view position are in the frame uniform block shared by Phong programs.
 		Tools::Lights3DSetup(Globals::Shaders().basicPhong());
-		Tools::Lights3DSetup(Globals::Shaders().texturedPhong());
-
-		const auto viewPos = Globals::Components().vpDefault3D().getViewPos();
-		Globals::Shaders().basicPhong().viewPos(viewPos);
-		Globals::Shaders().texturedPhong().viewPos(viewPos);
+		Globals::Shaders().basicPhong().viewPos(Globals::Components().vpDefault3D().getViewPos());
 
 		Globals::Shaders().frameSetup();
 
-		for (size_t layer = 0; layer < (size_t)RenderLayer::COUNT; ++layer)
 		{
-			CustomRenderTexturesRenderer customRenderTexturesRenderer;
+			const auto profilerZone = Globals::Profiler().zone("offscreenPass", true);
 
-			if (!graphicsSettings.forcedDepthTest)
-				glProxySetDepthTest(true);
+			RenderPass<CustomRenderTexturesRenderer>(staticOfflineBuffers, dynamicOfflineBuffers);
+		}
 
-			BasicPhongRender(layer, customRenderTexturesRenderer, staticOfflineBuffers.basicPhong, dynamicOfflineBuffers.basicPhong);
-			TexturedPhongRender(layer, customRenderTexturesRenderer, staticOfflineBuffers.texturedPhong, dynamicOfflineBuffers.texturedPhong);
+		{
+			const auto profilerZone = Globals::Profiler().zone("mainPass", true);
 
-			if (!graphicsSettings.forcedDepthTest)
-				glProxySetDepthTest(graphicsSettings.force3D);
+			glProxyBindFramebuffer(mainRenderTexture.loaded.fbo);
+			glProxyViewport(0, 0, mainRenderTexture.loaded.size.x, mainRenderTexture.loaded.size.y);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			BasicRender(layer, customRenderTexturesRenderer, staticOfflineBuffers.basic, dynamicOfflineBuffers.basic);
-			TexturedRender(layer, customRenderTexturesRenderer, staticOfflineBuffers.textured, dynamicOfflineBuffers.textured);
-			CustomShadersRender(layer, customRenderTexturesRenderer, staticOfflineBuffers.customShaders, dynamicOfflineBuffers.customShaders);
+			RenderPass<StandardRenderTexturesRenderer>(staticBuffers, dynamicBuffers, Globals::Shaders().textured());
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, mainRenderTexture.loaded.fbo);
-		glViewport(0, 0, mainRenderTexture.loaded.size.x, mainRenderTexture.loaded.size.y);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		TransformFeedbackRender();
 
-		for (size_t layer = 0; layer < (size_t)RenderLayer::COUNT; ++layer)
 		{
-			StandardRenderTexturesRenderer standardRenderTexturesRenderer(Globals::Shaders().textured());
-
-			if (!graphicsSettings.forcedDepthTest)
-				glProxySetDepthTest(true);
+			const auto profilerZone = Globals::Profiler().zone("mainFramebufferPass", true);
 
-			BasicPhongRender(layer, standardRenderTexturesRenderer, staticBuffers.basicPhong, dynamicBuffers.basicPhong);
-			TexturedPhongRender(layer, standardRenderTexturesRenderer, staticBuffers.texturedPhong, dynamicBuffers.texturedPhong);
-
-			if (!graphicsSettings.forcedDepthTest)
-				glProxySetDepthTest(graphicsSettings.force3D);
+			glProxyBindFramebuffer(0);
+			glProxyViewport(0, 0, screenInfo.windowSize.x, screenInfo.windowSize.y);
+			glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			BasicRender(layer, standardRenderTexturesRenderer, staticBuffers.basic, dynamicBuffers.basic);
-			TexturedRender(layer, standardRenderTexturesRenderer, staticBuffers.textured, dynamicBuffers.textured);
-			CustomShadersRender(layer, standardRenderTexturesRenderer, staticBuffers.customShaders, dynamicBuffers.customShaders);
+			assert(Globals::Components().mainFramebufferRenderer().renderer);
+			Globals::Components().mainFramebufferRenderer().renderer(mainRenderTexture.loaded.textureObject);
 		}
 
-		TransformFeedbackRender();
-
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glViewport(0, 0, screenInfo.windowSize.x, screenInfo.windowSize.y);
-		glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		Globals::Components().renderingBuffers().streamingBuffer.frameRendered();
 
-		assert(Globals::Components().mainFramebufferRenderer().renderer);
-		Globals::Components().mainFramebufferRenderer().renderer(mainRenderTexture.loaded.textureObject);
+		if (graphicsSettings.glStateValidation)
+		{
+			[[maybe_unused]] const bool stateValid = glProxyValidateState();
+			assert(stateValid);
+		}
 	}
 }
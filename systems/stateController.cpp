@@ -18,14 +18,22 @@
 #include <ogl/shaders/trails.hpp>
 #include <ogl/shaders/effects.hpp>
 #include <ogl/shaders/tfParticles.hpp>
+#include <ogl/uniformsUtils.hpp>
+#include <ogl/buffers/genericBuffers.hpp>
 
 #include <globals/components.hpp>
 #include <globals/shaders.hpp>
+#include <globals/frameArena.hpp>
+#include <globals/profiler.hpp>
+
+#include <commonTypes/frameArena.hpp>
+#include <commonTypes/profiler.hpp>
 
 #include <SDL_events.h>
 #include <SDL_gamecontroller.h>
 
 #include <algorithm>
+#include <iostream>
 
 namespace
 {
@@ -50,6 +58,7 @@ namespace Systems
 		auto& gamepads = Globals::Components().gamepads();
 
 		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &systemInfo.limits.maxTextureUnits);
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &systemInfo.limits.maxTextureSize);
 
 		for (unsigned i = 0; i < gamepads.size(); ++i)
 		{
@@ -83,6 +92,7 @@ namespace Systems
 	void StateController::stepTeardown() const
 	{
 		ProcessFunctors(Globals::Components().stepTeardowns());
+		Globals::FrameArena().reset();
 	}
 
 	void StateController::renderSetup()
@@ -125,9 +135,9 @@ namespace Systems
 		screenInfo.framebufferRes = size;
 
 		auto setTextureFramebufferSize = [&](Components::RenderTexture& renderTexture, glm::ivec2 size) {
-			glBindFramebuffer(GL_FRAMEBUFFER, renderTexture.loaded.fbo);
+			glProxyBindFramebuffer(renderTexture.loaded.fbo);
 
-			glBindTexture(GL_TEXTURE_2D, renderTexture.loaded.textureObject);
+			glProxyBindTexture(GL_TEXTURE_2D, renderTexture.loaded.textureObject);
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_FLOAT, nullptr);
 
 			glBindRenderbuffer(GL_RENDERBUFFER, renderTexture.loaded.depthBuffer);
@@ -253,6 +263,31 @@ namespace Systems
 
 		if (keyboard.pressed['P'])
 			physics.paused = appStateHandler.pauseF(physics.paused);
+
+		auto& profiler = Globals::Profiler();
+		if (keyboard.pressed[0x75/*VK_F6*/])
+			profiler.setEnabled(!profiler.isEnabled());
+		if (keyboard.pressed[0x76/*VK_F7*/])
+		{
+			const auto& uniformsCounters = UniformsUtils::GetUpdatesCounters();
+			const auto& uploadsCounters = Buffers::GetUploadsCounters();
+			std::cout << profiler.getSummary();
+			std::cout << "Uniform updates issued: " << uniformsCounters.issued << ", skipped: " << uniformsCounters.skipped << "\n";
+			std::cout << "Geometry uploads issued: " << uploadsCounters.issued << ", skipped: " << uploadsCounters.skipped << "\n";
+			UniformsUtils::ResetUpdatesCounters();
+			Buffers::ResetUploadsCounters();
+		}
+		if (keyboard.pressed[0x77/*VK_F8*/])
+		{
+			profiler.saveChromeTrace("profile_trace.json");
+			std::cout << "Profiler trace saved to profile_trace.json\n";
+		}
+		if (keyboard.pressed[0x78/*VK_F9*/])
+		{
+			auto& graphicsSettings = Globals::Components().graphicsSettings();
+			graphicsSettings.glStateValidation = !graphicsSettings.glStateValidation;
+			std::cout << "GL state validation " << (graphicsSettings.glStateValidation ? "enabled" : "disabled") << "\n";
+		}
 	}
 
 	void StateController::handleSDL()
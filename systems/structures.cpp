@@ -18,6 +18,12 @@ namespace Systems
 	}
 
 	void Structures::step()
+	{
+		stepComponents();
+		updateDynamicBuffers();
+	}
+
+	void Structures::stepComponents()
 	{
 		for (auto& wall : Globals::Components().staticWalls())
 			wall.step();
@@ -36,8 +42,6 @@ namespace Systems
 
 		for (auto& polyline : Globals::Components().polylines())
 			polyline.step();
-
-		updateDynamicBuffers();
 	}
 
 	void Structures::updateStaticBuffers()
@@ -10,11 +10,11 @@ namespace Systems
 		void postInit();
 		void step();
 
+		void stepComponents();
 		void updateStaticBuffers();
-
-	private:
 		void updateDynamicBuffers();
 
+	private:
 		size_t loadedStaticWalls = 0;
 		size_t loadedStaticGrapples = 0;
 		size_t loadedStaticPolylines = 0;
@@ -12,13 +12,17 @@ namespace Systems
 	Temporaries::Temporaries() = default;
 
 	void Temporaries::step()
+	{
+		stepComponents();
+		updateDynamicBuffers();
+	}
+
+	void Temporaries::stepComponents()
 	{
 		for (auto& missile: Globals::Components().missiles())
 			missile.step();
 		for (auto& shockwave : Globals::Components().shockwaves())
 			shockwave.step();
-
-		updateDynamicBuffers();
 	}
 
 	void Temporaries::updateDynamicBuffers()
@@ -9,7 +9,7 @@ namespace Systems
 
 		void step();
 
-	private:
+		void stepComponents();
 		void updateDynamicBuffers();
 	};
 }
@@ -6,9 +6,15 @@
 #include <components/systemInfo.hpp>
 
 #include <globals/components.hpp>
+#include <globals/threadPool.hpp>
+
+#include <commonTypes/threadPool.hpp>
 
 #include <tools/utility.hpp>
 #include <tools/buffersHelpers.hpp>
+#include <tools/atlasPacker.hpp>
+#include <tools/parallelFor.hpp>
+#include <tools/texelKernels.hpp>
 
 #include <ogl/oglProxy.hpp>
 #include <ogl/oglHelpers.hpp>
@@ -18,44 +24,109 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <thread>
+#include <type_traits>
 #include <stdexcept>
-#include <execution>
-#include <ranges>
 
 namespace
 {
 	constexpr bool parallelProcessing = true;
+	constexpr size_t uploadBudgetPerFrame = 16 * 1024 * 1024;
+	constexpr bool diskCaching = true;
+	constexpr const char* diskCacheDirectory = "textureCache";
+	constexpr int atlasMaxPageSize = 4096;
+	// Padding halves with every mipmap level, so pages' levels are limited to keep at least one texel of it. Regions are aligned to the size
+	// of the last level's texel, so none of them averages texels of neighboring regions.
+	constexpr int atlasPadding = 8;
+	constexpr int atlasMaxMipmapLevel = 3;
+	constexpr int atlasAlignment = 1 << atlasMaxMipmapLevel;
+
+	// Blob layout: header, cache key, padding to the payload offset, texels ready to upload.
+	struct DiskCacheHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t keySize;
+		std::int32_t width;
+		std::int32_t height;
+		std::int32_t numOfChannels;
+		std::uint32_t texelFormat;
+		std::uint32_t padding;
+		std::uint64_t payloadOffset;
+		std::uint64_t payloadSize;
+	};
+
+	constexpr char diskCacheMagic[4] = { 'M', 'S', 'T', 'C' };
+	constexpr std::uint32_t diskCacheVersion = 1;
+	constexpr size_t diskCachePayloadAlignment = 64;
+
+	using TexelFormat = TextureFile::TexelFormat;
+
+	std::string getCacheKey(const TextureFile& file)
+	{
+		return file.path + std::to_string(file.desiredChannels) + std::to_string((int)file.convertToPremultipliedAlpha) + std::to_string((int)file.additionalConversion)
+			+ std::to_string((int)file.texelFormat);
+	}
+
+	std::optional<TextureFile> getFileSource(const Components::Texture& texture)
+	{
+		if (const auto* file = std::get_if<TextureFile>(&texture.source))
+			return *file;
+		if (const auto* path = std::get_if<std::string>(&texture.source))
+			return TextureFile(*path);
+		return std::nullopt;
+	}
+
+	// Waiting thread helps the workers, as decodings may still be queued.
+	void waitForDecoding(const std::shared_future<void>& decoding)
+	{
+		while (decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			if (!Globals::ThreadPool().tryRunPendingJob())
+				decoding.wait();
+	}
+
+	// Conversions are done on 8 bit components for 8 bit storage, otherwise on floats, before packing into the final format.
+	void VisitComponents(Systems::Textures::TextureCache& textureCache, auto visitor)
+	{
+		switch (textureCache.texelFormat)
+		{
+		case TexelFormat::UNorm8:
+		case TexelFormat::SRGB8:
+			visitor(reinterpret_cast<std::uint8_t*>(textureCache.data.get()));
+			break;
+		case TexelFormat::Float32:
+			visitor(reinterpret_cast<float*>(textureCache.data.get()));
+			break;
+		default:
+			assert(!"unsupported texel format for conversions");
+		}
+	}
 
-	void optionalAlphaProcessing(float* data, glm::ivec2 size, int numOfChannels, bool convertToPremultipliedAlpha, TextureFile::AdditionalConversion additionalConversion)
+	template <typename Component>
+	void optionalAlphaProcessing(Component* data, glm::ivec2 size, int numOfChannels, bool convertToPremultipliedAlpha, TextureFile::AdditionalConversion additionalConversion)
 	{
 		if (numOfChannels < 4 || (!convertToPremultipliedAlpha && !(bool)additionalConversion))
 			return;
 
-		const bool convertDarkToTransparent = additionalConversion == TextureFile::AdditionalConversion::DarkToTransparent;
-		const bool convertTransparentToDark = additionalConversion == TextureFile::AdditionalConversion::TransparentToDark;
+		const Tools::TexelKernels::AlphaProcessing alphaProcessing{ convertToPremultipliedAlpha,
+			additionalConversion == TextureFile::AdditionalConversion::DarkToTransparent,
+			additionalConversion == TextureFile::AdditionalConversion::TransparentToDark };
 
-		auto processRow = [&](const auto y_) {
-			const int y = (int)y_;
-			for (int x = 0; x < size.x; ++x)
-			{
-				const int i = (y * size.x + x) * 4;
-				float& alpha = data[i + 3];
-				alpha = (1 - convertDarkToTransparent) * alpha + convertDarkToTransparent * std::min(1.0f, data[i] + data[i + 1] + data[i + 2]);
-				const float premultipliedAlphaFactor = (1 - convertToPremultipliedAlpha) + convertToPremultipliedAlpha * alpha;
-				for (int j = 0; j < 3; ++j)
-				{
-					float& color = data[i + j];
-					color *= premultipliedAlphaFactor * (1 - convertTransparentToDark * (1 - alpha));
-				}
-			}
+		auto processRow = [&](const auto y) {
+			Tools::TexelKernels::ProcessAlpha(data + y * size.x * 4, size.x, alphaProcessing);
 		};
 
 		if constexpr (parallelProcessing && 1)
-		{
-			Tools::ItToId itToId(size.y);
-			std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-		}
+			Tools::ParallelFor(0, size.y, 0, processRow);
 		else
 			for (int y = 0; y < size.y; ++y)
 				processRow(y);
@@ -66,56 +137,219 @@ namespace
 		if (textureCache.numOfChannels == newNumOfChannels)
 			return;
 
-		const glm::vec4 defaultColor = { 0.0f, 0.0f, 0.0f, 1.0f };
 		const int width = textureCache.size.x;
 		const int height = textureCache.size.y;
-		const int minChannels = std::min(textureCache.numOfChannels, newNumOfChannels);
-		auto newData = std::make_unique<float[]>(width * height * newNumOfChannels);
+		auto newData = std::make_unique_for_overwrite<std::byte[]>((size_t)width * height * newNumOfChannels * textureCache.getComponentSize());
 
-		auto processRow = [&](const auto y_) {
-			const int y = (int)y_;
-			for (int x = 0; x < width; ++x)
-			{
-				const int oldIndex = (y * width + x) * textureCache.numOfChannels;
-				const int newIndex = (y * width + x) * newNumOfChannels;
-				for (int c = 0; c < minChannels; ++c)
-					newData[newIndex + c] = textureCache.data[oldIndex + c];
-			}
-		};
+		VisitComponents(textureCache, [&](const auto* data) {
+			using Component = std::remove_cv_t<std::remove_pointer_t<decltype(data)>>;
+			auto* newComponents = reinterpret_cast<Component*>(newData.get());
 
-		if constexpr (parallelProcessing && 1)
+			auto processRow = [&](const auto y) {
+				Tools::TexelKernels::ChangeNumOfChannels(data + y * width * textureCache.numOfChannels, textureCache.numOfChannels,
+					newComponents + y * width * newNumOfChannels, newNumOfChannels, width);
+			};
+
+			if constexpr (parallelProcessing && 1)
+				Tools::ParallelFor(0, height, 0, processRow);
+			else
+				for (int y = 0; y < height; ++y)
+					processRow(y);
+		});
+
+		textureCache.data = std::move(newData);
+		textureCache.numOfChannels = newNumOfChannels;
+	}
+
+	void changeTexelFormat(Systems::Textures::TextureCache& textureCache, TexelFormat newTexelFormat)
+	{
+		if (newTexelFormat == TexelFormat::SRGB8 && textureCache.numOfChannels < 3)
+			newTexelFormat = TexelFormat::UNorm8;
+
+		if (textureCache.texelFormat == newTexelFormat)
+			return;
+
+		// sRGB differs only in sampling.
+		if (textureCache.texelFormat == TexelFormat::UNorm8 && newTexelFormat == TexelFormat::SRGB8)
 		{
-			Tools::ItToId itToId(height);
-			std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
+			textureCache.texelFormat = newTexelFormat;
+			return;
 		}
-		else
-			for (int y = 0; y < height; ++y)
-				processRow(y);
 
-		if (newNumOfChannels > textureCache.numOfChannels)
-		{
-			auto processRow = [&](const auto y_) {
-				const int y = (int)y_;
-				for (int x = 0; x < width; ++x)
-				{
-					const int newIndex = (y * width + x) * newNumOfChannels;
-					for (int c = minChannels; c < newNumOfChannels; ++c)
-						newData[newIndex + c] = defaultColor[c];
-				}
+		assert(textureCache.texelFormat == TexelFormat::Float32);
+
+		const size_t rowSize = (size_t)textureCache.size.x * textureCache.numOfChannels;
+		const float* data = reinterpret_cast<const float*>(textureCache.data.get());
+
+		auto pack = [&](auto componentTag) {
+			using Component = decltype(componentTag);
+			auto newData = std::make_unique_for_overwrite<std::byte[]>(rowSize * textureCache.size.y * sizeof(Component));
+			auto* newComponents = reinterpret_cast<Component*>(newData.get());
+
+			auto processRow = [&](const auto y) {
+				if constexpr (std::is_same_v<Component, std::uint8_t>)
+					Tools::TexelKernels::PackUNorm8(data + y * rowSize, newComponents + y * rowSize, rowSize);
+				else
+					Tools::TexelKernels::PackHalf(data + y * rowSize, newComponents + y * rowSize, rowSize);
 			};
 
 			if constexpr (parallelProcessing && 1)
-			{
-				Tools::ItToId itToId(height);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-			}
+				Tools::ParallelFor(0, textureCache.size.y, 0, processRow);
 			else
-				for (int y = 0; y < height; ++y)
+				for (size_t y = 0; y < (size_t)textureCache.size.y; ++y)
 					processRow(y);
+
+			textureCache.data = std::move(newData);
+		};
+
+		switch (newTexelFormat)
+		{
+		case TexelFormat::UNorm8:
+		case TexelFormat::SRGB8:
+			pack(std::uint8_t{});
+			break;
+		case TexelFormat::Float16:
+			pack(std::uint16_t{});
+			break;
+		default:
+			assert(!"unsupported texel format");
 		}
 
-		textureCache.data = std::move(newData);
-		textureCache.numOfChannels = newNumOfChannels;
+		textureCache.texelFormat = newTexelFormat;
+	}
+
+	// Source file modification time is a part of the key, so edited files are decoded again. Custom conversions can't be keyed, so such files aren't cached.
+	std::optional<std::string> getDiskCacheKey(const TextureFile& file)
+	{
+		if (!diskCaching || file.customConversionF)
+			return std::nullopt;
+
+		std::error_code error;
+		const auto writeTime = std::filesystem::last_write_time(file.path, error);
+		if (error)
+			return std::nullopt;
+
+		return getCacheKey(file) + "@" + std::to_string(writeTime.time_since_epoch().count());
+	}
+
+	std::filesystem::path getDiskCacheBlobPath(const std::string& diskCacheKey)
+	{
+		return std::filesystem::path(diskCacheDirectory) / (std::to_string(std::hash<std::string>{}(diskCacheKey)) + ".tex");
+	}
+
+	bool loadFromDiskCache(const std::string& diskCacheKey, Systems::Textures::TextureCache& textureCache)
+	{
+		Tools::MappedFile mappedFile(getDiskCacheBlobPath(diskCacheKey).string());
+		if (!mappedFile.isOpen() || mappedFile.getSize() < sizeof(DiskCacheHeader))
+			return false;
+
+		DiskCacheHeader header;
+		std::memcpy(&header, mappedFile.getData(), sizeof(header));
+
+		if (std::memcmp(header.magic, diskCacheMagic, sizeof(diskCacheMagic)) != 0 || header.version != diskCacheVersion || header.keySize != diskCacheKey.size()
+			|| sizeof(header) + header.keySize > mappedFile.getSize() || std::memcmp(mappedFile.getData() + sizeof(header), diskCacheKey.data(), diskCacheKey.size()) != 0
+			|| header.numOfChannels < 1 || header.numOfChannels > 4 || header.texelFormat > (std::uint32_t)TexelFormat::Float32
+			|| header.payloadOffset % diskCachePayloadAlignment != 0 || header.payloadOffset + header.payloadSize > mappedFile.getSize())
+			return false;
+
+		textureCache.size = { header.width, header.height };
+		textureCache.numOfChannels = header.numOfChannels;
+		textureCache.texelFormat = (TexelFormat)header.texelFormat;
+		if (header.payloadSize != (std::uint64_t)textureCache.size.x * textureCache.size.y * textureCache.getTexelSize())
+			return false;
+
+		textureCache.mappedFile = std::move(mappedFile);
+		textureCache.mappedPayloadOffset = (size_t)header.payloadOffset;
+
+		return true;
+	}
+
+	// Failures are ignored, the file is decoded again next time. Blob is written under a temporary name, so partial blobs are never loaded.
+	void saveToDiskCache(const std::string& diskCacheKey, const Systems::Textures::TextureCache& textureCache)
+	{
+		const auto blobPath = getDiskCacheBlobPath(diskCacheKey);
+		const auto tmpBlobPath = std::filesystem::path(blobPath).concat(".tmp");
+
+		std::error_code error;
+		std::filesystem::create_directories(blobPath.parent_path(), error);
+		if (error)
+			return;
+
+		DiskCacheHeader header{};
+		std::memcpy(header.magic, diskCacheMagic, sizeof(diskCacheMagic));
+		header.version = diskCacheVersion;
+		header.keySize = (std::uint32_t)diskCacheKey.size();
+		header.width = textureCache.size.x;
+		header.height = textureCache.size.y;
+		header.numOfChannels = textureCache.numOfChannels;
+		header.texelFormat = (std::uint32_t)textureCache.texelFormat;
+		header.payloadOffset = (sizeof(header) + diskCacheKey.size() + diskCachePayloadAlignment - 1) / diskCachePayloadAlignment * diskCachePayloadAlignment;
+		header.payloadSize = (std::uint64_t)textureCache.size.x * textureCache.size.y * textureCache.getTexelSize();
+
+		{
+			std::ofstream stream(tmpBlobPath, std::ios::binary);
+			const char padding[diskCachePayloadAlignment]{};
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(diskCacheKey.data(), diskCacheKey.size());
+			stream.write(padding, header.payloadOffset - sizeof(header) - diskCacheKey.size());
+			stream.write(reinterpret_cast<const char*>(textureCache.getData()), header.payloadSize);
+			if (!stream)
+			{
+				stream.close();
+				std::filesystem::remove(tmpBlobPath, error);
+				return;
+			}
+		}
+
+		std::filesystem::rename(tmpBlobPath, blobPath, error);
+		if (error)
+			std::filesystem::remove(tmpBlobPath, error);
+	}
+
+	bool isMipmapped(GLint minFilter)
+	{
+		return minFilter == GL_LINEAR_MIPMAP_LINEAR ||
+			minFilter == GL_LINEAR_MIPMAP_NEAREST ||
+			minFilter == GL_NEAREST_MIPMAP_LINEAR ||
+			minFilter == GL_NEAREST_MIPMAP_NEAREST;
+	}
+
+	// Sampling outside of the region has to be reproducible by the padding: replicated edge or transparent border.
+	bool isAtlasPackable(const Components::Texture& texture, const Systems::Textures::TextureCache& textureCache, int maxPageSize)
+	{
+		const bool clampedSampling = texture.wrapMode == GL_CLAMP_TO_EDGE || (texture.wrapMode == GL_CLAMP_TO_BORDER && texture.borderColor == glm::vec4(0.0f));
+		return clampedSampling && texture.state == ComponentState::Changed && !texture.subImagesF && !texture.sourceFragmentCornerAndSizeF
+			&& textureCache.texelFormat == TexelFormat::UNorm8
+			&& glm::all(glm::lessThanEqual(Tools::AtlasPaddedSize(textureCache.size, atlasPadding, atlasAlignment), glm::ivec2(maxPageSize)));
+	}
+
+	// Page texels are RGBA8. Missing components are filled the way GL fills them for textures with less channels. Edge padding also fills the
+	// alignment space after the content.
+	void copyIntoAtlasPage(std::uint8_t* pageData, glm::ivec2 pageSize, glm::ivec2 position, const Systems::Textures::TextureCache& textureCache, bool edgePadding)
+	{
+		const auto* data = reinterpret_cast<const std::uint8_t*>(textureCache.getData());
+		const glm::ivec2 size = textureCache.size;
+		const int numOfChannels = textureCache.numOfChannels;
+		const int paddingToFill = edgePadding ? atlasPadding : 0;
+		const glm::ivec2 endPaddingToFill = edgePadding ? Tools::AtlasPaddedSize(size, atlasPadding, atlasAlignment) - size - atlasPadding : glm::ivec2(0);
+
+		auto copyRow = [&](const auto paddedY) {
+			const int y = (int)paddedY - paddingToFill;
+			const std::uint8_t* sourceRow = data + (size_t)std::clamp(y, 0, size.y - 1) * size.x * numOfChannels;
+			std::uint8_t* destRow = pageData + ((size_t)(position.y + y) * pageSize.x + position.x - paddingToFill) * 4;
+			for (int x = -paddingToFill; x < size.x + endPaddingToFill.x; ++x)
+			{
+				const std::uint8_t* sourceTexel = sourceRow + std::clamp(x, 0, size.x - 1) * numOfChannels;
+				for (int c = 0; c < 4; ++c)
+					*destRow++ = c < numOfChannels ? sourceTexel[c] : c == 3 ? 255 : 0;
+			}
+			};
+
+		if constexpr (parallelProcessing && 1)
+			Tools::ParallelFor(0, paddingToFill + size.y + endPaddingToFill.y, 0, copyRow);
+		else
+			for (int y = 0; y < paddingToFill + size.y + endPaddingToFill.y; ++y)
+				copyRow(y);
 	}
 }
 
@@ -129,15 +363,48 @@ namespace Systems
 		createAndConfigureStandardRenderTextures();
 	}
 
+	Textures::~Textures()
+	{
+		// Decoding jobs write to the cache.
+		while (numOfDecodingsInFlight > 0)
+			if (!Globals::ThreadPool().tryRunPendingJob())
+				std::this_thread::yield();
+
+		glProxyDeleteTextures((GLsizei)atlasPagesObjects.size(), atlasPagesObjects.data());
+	}
+
 	void Textures::postInit()
 	{
+		// Files of textures created during setup are decoded in parallel, but uploaded before returning, as levels may use their sizes in postSetup.
+		std::vector<std::shared_future<void>> decodings;
+		auto decodeFiles = [&](auto&& textures) {
+			for (auto& texture : textures)
+				if (auto file = getFileSource(texture); file && texture.state != ComponentState::Outdated)
+					decodings.push_back(decodeFileAsync(std::move(*file)));
+		};
+		decodeFiles(Globals::Components().staticTextures().from(staticTexturesOffset));
+		decodeFiles(Globals::Components().textures());
+
+		for (const auto& decoding : decodings)
+			waitForDecoding(decoding);
+
+		packStaticTexturesIntoAtlases();
 		updateStaticTextures();
 		updateStaticRenderTextures();
 		updateDynamicTextures();
 		updateDynamicRenderTextures();
+
+		asyncLoading = true;
 	}
 
 	void Textures::step()
+	{
+		stepComponents();
+		updateDynamicTextures();
+		updateDynamicRenderTextures();
+	}
+
+	void Textures::stepComponents()
 	{
 		for (auto& texture : Globals::Components().staticTextures())
 			texture.step();
@@ -150,58 +417,171 @@ namespace Systems
 
 		for (auto& renderTexture : Globals::Components().renderTextures())
 			renderTexture.step();
-
-		updateDynamicTextures();
-		updateDynamicRenderTextures();
 	}
 
 	void Textures::updateStaticTextures()
 	{
-		for (auto& texture : Globals::Components().staticTextures().underlyingContainer() | std::views::drop(staticTexturesOffset))
+		for (auto& texture : Globals::Components().staticTextures().from(staticTexturesOffset))
 			updateTexture(texture);
 		staticTexturesOffset = Globals::Components().staticTextures().size();
 	}
 
 	void Textures::updateStaticRenderTextures()
 	{
-		for (auto& renderTexture : Globals::Components().staticRenderTextures().underlyingContainer() | std::views::drop(staticRenderTexturesOffset))
+		for (auto& renderTexture : Globals::Components().staticRenderTextures().from(staticRenderTexturesOffset))
 			updateRenderTexture(renderTexture);
 		staticRenderTexturesOffset = Globals::Components().staticRenderTextures().size();
 	}
 
-	const Textures::TextureCache& Textures::loadFile(const TextureFile& file)
+	std::byte* Textures::TextureCache::getData() const
+	{
+		return mappedFile.isOpen()
+			? mappedFile.getData() + mappedPayloadOffset
+			: data.get();
+	}
+
+	size_t Textures::TextureCache::getComponentSize() const
+	{
+		switch (texelFormat)
+		{
+		case TexelFormat::UNorm8:
+		case TexelFormat::SRGB8: return sizeof(std::uint8_t);
+		case TexelFormat::Float16: return sizeof(std::uint16_t);
+		case TexelFormat::Float32: return sizeof(float);
+		default: assert(!"unsupported texel format"); return 0;
+		}
+	}
+
+	size_t Textures::TextureCache::getTexelSize() const
+	{
+		return getComponentSize() * numOfChannels;
+	}
+
+	GLenum Textures::TextureCache::getType() const
 	{
-		auto& textureCache = keysToTexturesCache[file.path + std::to_string(file.desiredChannels) + std::to_string((int)file.convertToPremultipliedAlpha) + std::to_string((int)file.additionalConversion)];
+		switch (texelFormat)
+		{
+		case TexelFormat::UNorm8:
+		case TexelFormat::SRGB8: return GL_UNSIGNED_BYTE;
+		case TexelFormat::Float16: return GL_HALF_FLOAT;
+		case TexelFormat::Float32: return GL_FLOAT;
+		default: assert(!"unsupported texel format"); return 0;
+		}
+	}
 
-		if (!textureCache.data)
+	GLint Textures::TextureCache::getInternalFormat() const
+	{
+		constexpr GLint unorm8Formats[] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+		constexpr GLint float16Formats[] = { GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F };
+		constexpr GLint float32Formats[] = { GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F };
+
+		assert(numOfChannels >= 1 && numOfChannels <= 4);
+		switch (texelFormat)
 		{
-			textureCache.data.reset(stbi_loadf(file.path.c_str(), &textureCache.size.x, &textureCache.size.y, &textureCache.numOfChannels, 0));
-			if (!textureCache.data)
+		case TexelFormat::UNorm8: return unorm8Formats[numOfChannels - 1];
+		case TexelFormat::SRGB8: assert(numOfChannels >= 3); return numOfChannels == 3 ? GL_SRGB8 : GL_SRGB8_ALPHA8;
+		case TexelFormat::Float16: return float16Formats[numOfChannels - 1];
+		case TexelFormat::Float32: return float32Formats[numOfChannels - 1];
+		default: assert(!"unsupported texel format"); return 0;
+		}
+	}
+
+	const Textures::TextureCache& Textures::loadFile(const TextureFile& file)
+	{
+		TextureCache* textureCachePtr;
+		{
+			std::lock_guard lock(texturesCacheMutex);
+			textureCachePtr = &keysToTexturesCache[getCacheKey(file)];
+		}
+		auto& textureCache = *textureCachePtr;
+
+		std::call_once(textureCache.decodingFlag, [&]() {
+			const auto diskCacheKey = getDiskCacheKey(file);
+			if (diskCacheKey && loadFromDiskCache(*diskCacheKey, textureCache))
+			{
+				textureCache.decoded = true;
+				return;
+			}
+
+			// Floats take 4 times more memory, so they are decoded only if needed by the requested format or the custom conversion.
+			const bool floatDecoding = file.customConversionF || file.texelFormat == TexelFormat::Float16 || file.texelFormat == TexelFormat::Float32;
+			void* decodedData = floatDecoding
+				? (void*)stbi_loadf(file.path.c_str(), &textureCache.size.x, &textureCache.size.y, &textureCache.numOfChannels, 0)
+				: (void*)stbi_load(file.path.c_str(), &textureCache.size.x, &textureCache.size.y, &textureCache.numOfChannels, 0);
+			if (!decodedData)
 			{
 				assert(!"unable to load image");
 				throw std::runtime_error("Unable to load image \"" + file.path + "\".");
 			}
 
+			textureCache.texelFormat = floatDecoding ? TexelFormat::Float32 : TexelFormat::UNorm8;
+			const size_t dataSize = (size_t)textureCache.size.x * textureCache.size.y * textureCache.getTexelSize();
+			textureCache.data = std::make_unique_for_overwrite<std::byte[]>(dataSize);
+			std::memcpy(textureCache.data.get(), decodedData, dataSize);
+			stbi_image_free(decodedData);
+
 			if (file.desiredChannels)
 				changeNumOfChannels(textureCache, file.desiredChannels);
 
 			if (file.customConversionF)
-				file.customConversionF(textureCache.data.get(), textureCache.size, textureCache.numOfChannels);
+				file.customConversionF(reinterpret_cast<float*>(textureCache.data.get()), textureCache.size, textureCache.numOfChannels);
 
-			optionalAlphaProcessing(textureCache.data.get(), textureCache.size, textureCache.numOfChannels,
-				file.convertToPremultipliedAlpha, file.additionalConversion);
-		}
+			VisitComponents(textureCache, [&](auto* data) {
+				optionalAlphaProcessing(data, textureCache.size, textureCache.numOfChannels, file.convertToPremultipliedAlpha, file.additionalConversion);
+			});
+
+			changeTexelFormat(textureCache, file.texelFormat);
+
+			if (diskCacheKey)
+				saveToDiskCache(*diskCacheKey, textureCache);
+
+			textureCache.decoded = true;
+		});
 
 		return textureCache;
 	}
 
+	bool Textures::isFileDecoded(const TextureFile& file)
+	{
+		std::lock_guard lock(texturesCacheMutex);
+		const auto it = keysToTexturesCache.find(getCacheKey(file));
+		return it != keysToTexturesCache.end() && it->second.decoded;
+	}
+
+	std::shared_future<void> Textures::decodeFileAsync(TextureFile file)
+	{
+		auto promise = std::make_shared<std::promise<void>>();
+		auto decoding = promise->get_future().share();
+
+		++numOfDecodingsInFlight;
+		Globals::ThreadPool().submit([this, file = std::move(file), promise]() {
+			try
+			{
+				loadFile(file);
+				promise->set_value();
+			}
+			catch (...)
+			{
+				promise->set_exception(std::current_exception());
+			}
+			--numOfDecodingsInFlight;
+		});
+
+		return decoding;
+	}
+
 	const Textures::TextureCache& Textures::textureDataFromFile(TextureData& textureData)
 	{
-		const auto& textureCache = loadFile(textureData.file);
+		// Texture data is processed on the CPU side as floats.
+		TextureFile file = textureData.file;
+		file.texelFormat = TexelFormat::Float32;
+
+		const auto& textureCache = loadFile(file);
+		float* cacheData = reinterpret_cast<float*>(textureCache.getData());
 		textureData.loaded.size = textureCache.size;
 
 		if (std::holds_alternative<std::pair<float*, int>>(textureData.loaded.data))
-			textureData.loaded.data = std::make_pair(textureCache.data.get(), textureCache.numOfChannels);
+			textureData.loaded.data = std::make_pair(cacheData, textureCache.numOfChannels);
 		else
 		{
 			switch (textureCache.numOfChannels)
@@ -223,8 +603,7 @@ namespace Systems
 				throw std::runtime_error("Unsupported number of channels in texture \"" + textureData.file.path + "\".");
 			}
 
-			std::copy(textureCache.data.get(), textureCache.data.get() + textureCache.numOfChannels * textureCache.size.x * textureCache.size.y,
-				textureData.getRawData());
+			std::copy(cacheData, cacheData + textureCache.numOfChannels * textureCache.size.x * textureCache.size.y, textureData.getRawData());
 		}
 		textureData.file = {};
 
@@ -234,14 +613,107 @@ namespace Systems
 
 	void Textures::updateDynamicTextures()
 	{
+		remainingUploadBudget = uploadBudgetPerFrame;
+
 		for (auto& texture : Globals::Components().textures())
 			updateTexture(texture);
 	}
 
+	void Textures::uploadDecodedTexture(Components::Texture& texture)
+	{
+		// Texture exceeding the budget is still uploaded if it's the first one in the frame.
+		if (remainingUploadBudget == 0 || texture.loaded.decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		// Rethrows decoding errors.
+		texture.loaded.decoding.get();
+
+		loadAndConfigureTexture(texture);
+
+		const auto& textureCache = loadFile(*getFileSource(texture));
+		const size_t uploadSize = (size_t)textureCache.size.x * textureCache.size.y * textureCache.getTexelSize();
+		remainingUploadBudget -= std::min(remainingUploadBudget, uploadSize);
+	}
+
+	void Textures::packStaticTexturesIntoAtlases()
+	{
+		// Packed textures get regions of shared pages instead of own texture objects. Textures sampled with the same filters share pages.
+		const int maxPageSize = std::min(atlasMaxPageSize, Globals::Components().systemInfo().limits.maxTextureSize);
+		std::map<std::pair<GLint, GLint>, std::vector<Components::Texture*>> filtersToTextures;
+
+		for (auto& texture : Globals::Components().staticTextures().from(staticTexturesOffset))
+			if (auto file = getFileSource(texture); file && texture.atlasPacking && isAtlasPackable(texture, loadFile(*file), maxPageSize))
+				filtersToTextures[{ texture.minFilter, texture.magFilter }].push_back(&texture);
+
+		std::vector<std::uint8_t> pageData;
+		for (const auto& [filters, textures] : filtersToTextures)
+		{
+			const auto [minFilter, magFilter] = filters;
+
+			std::vector<glm::ivec2> sizes;
+			sizes.reserve(textures.size());
+			for (const auto* texture : textures)
+				sizes.push_back(loadFile(*getFileSource(*texture)).size);
+
+			const auto atlasPacking = Tools::PackIntoAtlasPages(sizes, glm::ivec2(maxPageSize), atlasPadding, atlasAlignment);
+
+			for (unsigned page = 0; page < (unsigned)atlasPacking.pagesSizes.size(); ++page)
+			{
+				const glm::ivec2 pageSize = atlasPacking.pagesSizes[page];
+				pageData.assign((size_t)pageSize.x * pageSize.y * 4, 0);
+
+				unsigned pageObject = 0;
+				glGenTextures(1, &pageObject);
+				assert(pageObject);
+				if (!pageObject)
+					throw std::runtime_error("Unable to create texture unit.");
+				atlasPagesObjects.push_back(pageObject);
+
+				for (size_t i = 0; i < textures.size(); ++i)
+				{
+					const auto& placement = atlasPacking.placements[i];
+					if (placement.page != page)
+						continue;
+
+					auto& texture = *textures[i];
+					const auto& textureCache = loadFile(*getFileSource(texture));
+					copyIntoAtlasPage(pageData.data(), pageSize, placement.position, textureCache, texture.wrapMode == GL_CLAMP_TO_EDGE);
+
+					texture.loaded.textureObject = pageObject;
+					texture.loaded.size = textureCache.size;
+					texture.loaded.numOfChannels = textureCache.numOfChannels;
+					texture.loaded.internalFormat = GL_RGBA8;
+					texture.loaded.decoding = {};
+					texture.loaded.atlasRegion = { glm::vec2(placement.position) / glm::vec2(pageSize), glm::vec2(textureCache.size) / glm::vec2(pageSize) };
+					texture.state = ComponentState::Ongoing;
+				}
+
+				glProxyBindTexture(GL_TEXTURE_2D, pageObject);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pageSize.x, pageSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, pageData.data());
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+
+				if (isMipmapped(minFilter))
+				{
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, atlasMaxMipmapLevel);
+					glGenerateMipmap(GL_TEXTURE_2D);
+				}
+			}
+		}
+	}
+
 	void Textures::updateTexture(Components::Texture& texture)
 	{
 		if (texture.state == ComponentState::Ongoing)
+		{
+			if (texture.loaded.decoding.valid())
+				uploadDecodedTexture(texture);
 			return;
+		}
 		if (texture.state == ComponentState::Changed)
 		{
 			loadAndConfigureTexture(texture);
@@ -268,8 +740,11 @@ namespace Systems
 
 	void Textures::deleteTexture(Components::Texture& texture)
 	{
-		glDeleteTextures(1, &texture.loaded.textureObject);
+		// Atlas pages are shared, so they live as long as the system.
+		if (!texture.loaded.atlasRegion)
+			glProxyDeleteTextures(1, &texture.loaded.textureObject);
 		texture.loaded.textureObject = 0;
+		texture.loaded.atlasRegion = std::nullopt;
 	}
 
 	void Textures::loadAndConfigureTexture(Components::Texture& texture)
@@ -287,18 +762,21 @@ namespace Systems
 			{
 				const glm::ivec2 prevSize = texture.loaded.size;
 				const int prevNumOfChannels = texture.loaded.numOfChannels;
+				const GLint prevInternalFormat = texture.loaded.internalFormat;
 				auto& textureCache = textures.loadFile(file);
 
 				texture.loaded.size = textureCache.size;
 				texture.loaded.numOfChannels = textureCache.numOfChannels;
+				texture.loaded.internalFormat = textureCache.getInternalFormat();
 
-				applyTexture(textureCache.data.get(), prevSize, prevNumOfChannels);
+				applyTexture(textureCache.getData(), textureCache.getComponentSize(), textureCache.getType(), prevSize, prevNumOfChannels, prevInternalFormat);
 			}
 
 			void operator()(TextureData& textureData)
 			{
 				const glm::ivec2 prevSize = texture.loaded.size;
 				const int prevNumOfChannels = texture.loaded.numOfChannels;
+				const GLint prevInternalFormat = texture.loaded.internalFormat;
 
 				if (textureData.file.path.empty())
 					texture.loaded.numOfChannels = textureData.getNumOfChannels();
@@ -306,8 +784,9 @@ namespace Systems
 					texture.loaded.numOfChannels = textures.textureDataFromFile(textureData).numOfChannels;
 
 				texture.loaded.size = textureData.loaded.size;
+				texture.loaded.internalFormat = texture.loaded.getFormat();
 
-				applyTexture(textureData.getRawData(), prevSize, prevNumOfChannels);
+				applyTexture(reinterpret_cast<const std::byte*>(textureData.getRawData()), sizeof(float), GL_FLOAT, prevSize, prevNumOfChannels, prevInternalFormat);
 			}
 
 			void operator ()(std::monostate) const
@@ -317,7 +796,7 @@ namespace Systems
 			}
 
 		private:
-			void applyTexture(const float* data, glm::ivec2 prevSize, int prevNumOfChannels) const
+			void applyTexture(const std::byte* data, size_t componentSize, GLenum type, glm::ivec2 prevSize, int prevNumOfChannels, GLint prevInternalFormat) const
 			{
 				std::optional<TextureSubData> subData = texture.subImagesF
 					? std::optional<TextureSubData>(texture.subImagesF())
@@ -329,34 +808,32 @@ namespace Systems
 						? data
 						: [&]() {
 							const auto [fragmentCorner, fragmentSize] = texture.sourceFragmentCornerAndSizeF(texture.loaded.size);
-							const size_t rowSize = fragmentSize.x * texture.loaded.numOfChannels * sizeof(float);
-							const size_t totalSize = fragmentSize.y * fragmentSize.x * texture.loaded.numOfChannels;
+							const size_t texelSize = texture.loaded.numOfChannels * componentSize;
+							const size_t rowSize = fragmentSize.x * texelSize;
+							const size_t totalSize = fragmentSize.y * rowSize;
 
-							textures.operationalBuffer.resize(totalSize);
+							textures.fragmentBuffer.resize(totalSize);
 
 							auto copyRow = [&](const auto y) {
-								const float* rowStart = data + ((fragmentCorner.y + y) * texture.loaded.size.x + fragmentCorner.x) * texture.loaded.numOfChannels;
-								float* destStart = textures.operationalBuffer.data() + y * fragmentSize.x * texture.loaded.numOfChannels;
+								const std::byte* rowStart = data + ((fragmentCorner.y + y) * texture.loaded.size.x + fragmentCorner.x) * texelSize;
+								std::byte* destStart = textures.fragmentBuffer.data() + y * rowSize;
 								std::memcpy(destStart, rowStart, rowSize);
 								};
 
 							if constexpr (parallelProcessing && 1)
-							{
-								Tools::ItToId itToId(fragmentSize.y);
-								std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), copyRow);
-							}
+								Tools::ParallelFor(0, fragmentSize.y, 0, copyRow);
 							else
 								for (int y = 0; y < fragmentSize.y; ++y)
 									copyRow(y);
 
 							texture.loaded.size = fragmentSize;
 
-							return textures.operationalBuffer.data();
+							return (const std::byte*)textures.fragmentBuffer.data();
 						}();
-					if (prevSize != texture.loaded.size || prevNumOfChannels != texture.loaded.numOfChannels)
-						glTexImage2D(GL_TEXTURE_2D, 0, texture.loaded.getFormat(), texture.loaded.size.x, texture.loaded.size.y, 0, texture.loaded.getFormat(), GL_FLOAT, finalData);
+					if (prevSize != texture.loaded.size || prevNumOfChannels != texture.loaded.numOfChannels || prevInternalFormat != texture.loaded.internalFormat)
+						glTexImage2D(GL_TEXTURE_2D, 0, texture.loaded.internalFormat, texture.loaded.size.x, texture.loaded.size.y, 0, texture.loaded.getFormat(), type, finalData);
 					else
-						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture.loaded.size.x, texture.loaded.size.y, texture.loaded.getFormat(), GL_FLOAT, finalData);
+						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture.loaded.size.x, texture.loaded.size.y, texture.loaded.getFormat(), type, finalData);
 				}
 
 				if (subData)
@@ -407,9 +884,30 @@ namespace Systems
 				throw std::runtime_error("Unable to create texture unit.");
 		}
 
-		glBindTexture(GL_TEXTURE_2D, texture.loaded.textureObject);
+		glProxyBindTexture(GL_TEXTURE_2D, texture.loaded.textureObject);
 
-		std::visit(DataSourceVisitor{ *this, texture }, texture.source);
+		// Rows of 8 bit texels don't have to be 4 bytes aligned.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		// After initialization files are decoded by workers and uploaded later, within the per frame budget.
+		auto file = asyncLoading ? getFileSource(texture) : std::nullopt;
+		if (file && !isFileDecoded(*file))
+		{
+			texture.loaded.decoding = decodeFileAsync(std::move(*file));
+			if (texture.loaded.size == glm::ivec2(0, 0))
+			{
+				const std::uint8_t placeholderTexel[4]{};
+				texture.loaded.size = { 1, 1 };
+				texture.loaded.numOfChannels = 4;
+				texture.loaded.internalFormat = GL_RGBA8;
+				glTexImage2D(GL_TEXTURE_2D, 0, texture.loaded.internalFormat, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderTexel);
+			}
+		}
+		else
+		{
+			texture.loaded.decoding = {};
+			std::visit(DataSourceVisitor{ *this, texture }, texture.source);
+		}
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture.wrapMode);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture.wrapMode);
@@ -417,15 +915,8 @@ namespace Systems
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.magFilter);
 		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &texture.borderColor[0]);
 
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-		if (texture.minFilter == GL_LINEAR_MIPMAP_LINEAR ||
-			texture.minFilter == GL_LINEAR_MIPMAP_NEAREST ||
-			texture.minFilter == GL_NEAREST_MIPMAP_LINEAR ||
-			texture.minFilter == GL_NEAREST_MIPMAP_NEAREST)
-		{
+		if (isMipmapped(texture.minFilter))
 			glGenerateMipmap(GL_TEXTURE_2D);
-		}
 	}
 
 	void Textures::createAndConfigureStandardRenderTextures()
@@ -440,7 +931,7 @@ namespace Systems
 
 			unsigned textureObject;
 			glGenTextures(1, &textureObject);
-			glBindTexture(GL_TEXTURE_2D, textureObject);
+			glProxyBindTexture(GL_TEXTURE_2D, textureObject);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, renderTexture.wrapMode);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, renderTexture.wrapMode);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, renderTexture.minFilter);
@@ -448,7 +939,7 @@ namespace Systems
 			renderTexture.loaded.textureObject = textureObject;
 
 			glGenFramebuffers(1, &renderTexture.loaded.fbo);
-			glBindFramebuffer(GL_FRAMEBUFFER, renderTexture.loaded.fbo);
+			glProxyBindFramebuffer(renderTexture.loaded.fbo);
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTexture.loaded.textureObject, 0);
 
 			glGenRenderbuffers(1, &renderTexture.loaded.depthBuffer);
@@ -500,11 +991,11 @@ namespace Systems
 
 	void Textures::deleteRenderTexture(Components::RenderTexture& renderTexture)
 	{
-		glDeleteFramebuffers(1, &renderTexture.loaded.fbo);
+		glProxyDeleteFramebuffers(1, &renderTexture.loaded.fbo);
 		renderTexture.loaded.fbo = 0;
 		glDeleteRenderbuffers(1, &renderTexture.loaded.depthBuffer);
 		renderTexture.loaded.depthBuffer = 0;
-		glDeleteTextures(1, &renderTexture.loaded.textureObject);
+		glProxyDeleteTextures(1, &renderTexture.loaded.textureObject);
 		renderTexture.loaded.textureObject = 0;
 	}
 
@@ -516,7 +1007,7 @@ namespace Systems
 
 		unsigned textureObject;
 		glGenTextures(1, &textureObject);
-		glBindTexture(GL_TEXTURE_2D, textureObject);
+		glProxyBindTexture(GL_TEXTURE_2D, textureObject);
 		renderTexture.loaded.textureObject = textureObject;
 
 		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &renderTexture.borderColor[0]);
@@ -526,7 +1017,7 @@ namespace Systems
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, renderTexture.magFilter);
 
 		glGenFramebuffers(1, &renderTexture.loaded.fbo);
-		glBindFramebuffer(GL_FRAMEBUFFER, renderTexture.loaded.fbo);
+		glProxyBindFramebuffer(renderTexture.loaded.fbo);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderTexture.loaded.textureObject, 0);
 
 		glGenRenderbuffers(1, &renderTexture.loaded.depthBuffer);
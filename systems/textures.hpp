@@ -2,13 +2,22 @@
 
 #include <glm/vec2.hpp>
 
+#include <components/details/textureData.hpp>
+
 #include <commonTypes/idGenerator.hpp>
 
 #include <ogl/oglProxy.hpp>
 
+#include <tools/mappedFile.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Components
 {
@@ -16,9 +25,6 @@ namespace Components
 	struct RenderTexture;
 }
 
-struct TextureFile;
-struct TextureData;
-
 namespace Systems
 {
 	class Textures
@@ -26,29 +32,49 @@ namespace Systems
 	public:
 		struct TextureCache
 		{
-			std::unique_ptr<float[]> data;
+			std::unique_ptr<std::byte[]> data;
+			// Blob of the on-disk cache, used instead of decoded data.
+			Tools::MappedFile mappedFile;
+			size_t mappedPayloadOffset = 0;
 			glm::ivec2 size = { 0, 0 };
 			int numOfChannels = 0;
+			TextureFile::TexelFormat texelFormat = TextureFile::TexelFormat::Float32;
+
+			std::byte* getData() const;
+			size_t getComponentSize() const;
+			size_t getTexelSize() const;
+			GLenum getType() const;
+			GLint getInternalFormat() const;
+
+			std::once_flag decodingFlag;
+			std::atomic<bool> decoded = false;
 		};
 
 		Textures();
+		~Textures();
 
 		void postInit();
 		void step();
 
+		void stepComponents();
 		void updateStaticTextures();
 		void updateStaticRenderTextures();
+		void updateDynamicTextures();
+		void updateDynamicRenderTextures();
 
+		// Thread safe, files may be decoded by workers. Decoding thread runs the custom conversion.
 		const TextureCache& loadFile(const TextureFile& file);
 		const TextureCache& textureDataFromFile(TextureData& textureData);
 
 	private:
-		void updateDynamicTextures();
+		bool isFileDecoded(const TextureFile& file);
+		std::shared_future<void> decodeFileAsync(TextureFile file);
+		void uploadDecodedTexture(Components::Texture& texture);
+		void packStaticTexturesIntoAtlases();
 		void updateTexture(Components::Texture& texture);
 		void deleteTexture(Components::Texture& texture);
 		void loadAndConfigureTexture(Components::Texture& texture);
 		void createAndConfigureStandardRenderTextures();
-		void updateDynamicRenderTextures();
 		void updateRenderTexture(Components::RenderTexture& renderTexture);
 		void deleteRenderTexture(Components::RenderTexture& renderTexture);
 		void configureRenderTexture(Components::RenderTexture& renderTexture);
@@ -56,6 +82,12 @@ namespace Systems
 		unsigned staticTexturesOffset = 0;
 		unsigned staticRenderTexturesOffset = 0;
 		std::unordered_map<std::string, TextureCache> keysToTexturesCache;
+		std::mutex texturesCacheMutex;
+		std::atomic<unsigned> numOfDecodingsInFlight = 0;
+		size_t remainingUploadBudget = 0;
+		bool asyncLoading = false;
+		std::vector<unsigned> atlasPagesObjects;
 		std::vector<float> operationalBuffer;
+		std::vector<std::byte> fragmentBuffer;
 	};
 }
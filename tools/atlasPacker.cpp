@@ -0,0 +1,64 @@
+#include "atlasPacker.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace Tools
+{
+	glm::ivec2 AtlasPaddedSize(glm::ivec2 size, int padding, int alignment)
+	{
+		return (size + 2 * padding + alignment - 1) / alignment * alignment;
+	}
+
+	AtlasPacking PackIntoAtlasPages(const std::vector<glm::ivec2>& sizes, glm::ivec2 maxPageSize, int padding, int alignment)
+	{
+		assert(alignment > 0 && padding % alignment == 0);
+
+		AtlasPacking atlasPacking;
+		atlasPacking.placements.resize(sizes.size());
+
+		if (sizes.empty())
+			return atlasPacking;
+
+		std::vector<size_t> order(sizes.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](const auto lhs, const auto rhs) {
+			return sizes[lhs].y != sizes[rhs].y ? sizes[lhs].y > sizes[rhs].y : sizes[lhs].x > sizes[rhs].x;
+			});
+
+		glm::ivec2 shelfCorner{ 0 };
+		int shelfHeight = 0;
+		atlasPacking.pagesSizes.emplace_back(0);
+
+		for (const auto id : order)
+		{
+			const glm::ivec2 paddedSize = AtlasPaddedSize(sizes[id], padding, alignment);
+			assert(paddedSize.x <= maxPageSize.x && paddedSize.y <= maxPageSize.y);
+
+			if (shelfCorner.x + paddedSize.x > maxPageSize.x)
+			{
+				shelfCorner = { 0, shelfCorner.y + shelfHeight };
+				shelfHeight = 0;
+			}
+
+			if (shelfCorner.y + paddedSize.y > maxPageSize.y)
+			{
+				shelfCorner = { 0, 0 };
+				shelfHeight = 0;
+				atlasPacking.pagesSizes.emplace_back(0);
+			}
+
+			auto& pageSize = atlasPacking.pagesSizes.back();
+			atlasPacking.placements[id] = { (unsigned)atlasPacking.pagesSizes.size() - 1, shelfCorner + padding };
+			pageSize = glm::max(pageSize, shelfCorner + paddedSize);
+
+			shelfCorner.x += paddedSize.x;
+			shelfHeight = std::max(shelfHeight, paddedSize.y);
+		}
+
+		return atlasPacking;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <vector>
+
+namespace Tools
+{
+	struct AtlasPacking
+	{
+		struct Placement
+		{
+			unsigned page = 0;
+			glm::ivec2 position{ 0 };
+		};
+
+		// Placements are in the order of packed sizes and point at the content, excluding padding.
+		std::vector<Placement> placements;
+		// Pages are trimmed to their used extents.
+		std::vector<glm::ivec2> pagesSizes;
+	};
+
+	// Size taken by the content with padding on every side, rounded up to the alignment. The extra space is after the content.
+	glm::ivec2 AtlasPaddedSize(glm::ivec2 size, int padding, int alignment);
+
+	// Shelf packing: rectangles sorted by height are placed left to right in shelves, which are stacked bottom to top until the page is full.
+	// Every padded size has to fit into the max page size. Contents start at multiples of the alignment (e.g. 2^max mipmap level, so blocks
+	// averaged into mipmaps' texels don't mix neighbors), which requires the padding to be a multiple of it too.
+	AtlasPacking PackIntoAtlasPages(const std::vector<glm::ivec2>& sizes, glm::ivec2 maxPageSize, int padding, int alignment = 1);
+}
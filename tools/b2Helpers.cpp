@@ -12,6 +12,7 @@
 #include <glm/gtx/transform.hpp>
 
 #include <set>
+#include <cmath>
 
 namespace
 {
@@ -237,6 +238,25 @@ namespace Tools
 			bodyTransform.q.GetAngle(), { 0.0f, 0.0f, 1.0f });
 	}
 
+	glm::mat4 GetInterpolatedModelMatrix(const b2Body& body, glm::mat4 init)
+	{
+		const auto& fixedStep = Globals::Components().physics().fixedStep;
+		const auto* bodyUserData = reinterpret_cast<const BodyUserData*>(body.GetUserData().pointer);
+
+		if (!fixedStep.enabled || !bodyUserData || !bodyUserData->prevTransform)
+			return GetModelMatrix(body, init);
+
+		const auto& prevTransform = *bodyUserData->prevTransform;
+		const auto& bodyTransform = body.GetTransform();
+
+		const glm::vec2 position = glm::mix(ToVec2<glm::vec2>(prevTransform.p), ToVec2<glm::vec2>(bodyTransform.p), fixedStep.interpolationAlpha);
+		const float prevAngle = prevTransform.q.GetAngle();
+		const float angleDelta = std::remainder(bodyTransform.q.GetAngle() - prevAngle, glm::two_pi<float>());
+		const float angle = prevAngle + angleDelta * fixedStep.interpolationAlpha;
+
+		return glm::rotate(glm::translate(init, { position.x, position.y, 0.0f }), angle, { 0.0f, 0.0f, 1.0f });
+	}
+
 	std::vector<glm::vec3> GetVertices(const b2Body& body, int circleGraphicsComplexity)
 	{
 		std::vector<glm::vec3> vertices;
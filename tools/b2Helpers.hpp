@@ -178,6 +178,7 @@ namespace Tools
 	b2Joint* CreateDistanceJoint(b2Body& body1, b2Body& body2, glm::vec2 body1Anchor, glm::vec2 body2Anchor, bool collideConnected = false, float length = 0.0f);
 
 	glm::mat4 GetModelMatrix(const b2Body& body, glm::mat4 init = glm::mat4(1.0f));
+	glm::mat4 GetInterpolatedModelMatrix(const b2Body& body, glm::mat4 init = glm::mat4(1.0f));
 	std::vector<glm::vec3> GetVertices(const b2Body& body, int circleGraphicsComplexity = 60);
 
 	void SetCollisionFilteringBits(b2Body& body, unsigned short categoryBits, unsigned short maskBits);
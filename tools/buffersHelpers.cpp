@@ -1,9 +1,9 @@
 ﻿#include "buffersHelpers.hpp"
 
 #include <tools/utility.hpp>
+#include <tools/parallelFor.hpp>
 
 #include <algorithm>
-#include <execution>
 
 namespace
 {
@@ -46,10 +46,7 @@ namespace Tools
 		};
 
 		if constexpr (parallelProcessing && 1)
-		{
-			Tools::ItToId itToId(0, adjustedSubImageSize.y);
-			std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-		}
+			Tools::ParallelFor(0, adjustedSubImageSize.y, 0, processRow);
 		else
 			for (int y = 0; y < adjustedSubImageSize.y; ++y)
 				processRow(y);
@@ -89,10 +86,7 @@ namespace Tools
 		};
 
 		if constexpr (parallelProcessing && 1)
-		{
-			Tools::ItToId itToId(clippedSize.y);
-			std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-		}
+			Tools::ParallelFor(0, clippedSize.y, 0, processRow);
 		else
 			for (int y = 0; y < clippedSize.y; ++y)
 				processRow(y);
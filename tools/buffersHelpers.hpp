@@ -7,8 +7,6 @@
 
 #include <commonTypes/componentsContainers.hpp>
 
-#include <ranges>
-
 namespace Tools
 {
 	template <typename Component>
@@ -16,7 +14,7 @@ namespace Tools
 	{
 		auto& staticTFBuffers = Globals::Components().renderingBuffers().staticTFBuffers;
 
-		for (auto& component : components.underlyingContainer() | std::views::drop(offset))
+		for (auto& component : components.from((ComponentId)offset))
 		{
 			if (component.state == ComponentState::Ongoing || component.state == ComponentState::Outdated)
 				continue;
@@ -80,7 +78,9 @@ namespace Tools
 
 		for (auto& component : components)
 		{
-			if (component.state == ComponentState::Ongoing || component.state == ComponentState::Outdated)
+			// Streamed vertex data lives only for a few frames, so it is reapplied every frame. Data which fell back to own buffers stays valid.
+			if (component.state == ComponentState::Outdated
+				|| (component.state == ComponentState::Ongoing && (!component.loaded.buffers || !component.loaded.buffers->isAnyPartStreamActive())))
 				continue;
 
 			assert(!component.targetTextures.empty());
@@ -2,12 +2,12 @@
 
 #include "utility.hpp"
 #include "buffersHelpers.hpp"
+#include "parallelFor.hpp"
 
 #include <glm/glm.hpp>
 
 #include <vector>
 #include <algorithm>
-#include <execution>
 #include <optional>
 
 namespace Tools
@@ -71,10 +71,7 @@ namespace Tools
 			};
 
 			if constexpr (parallelProcessing && 1)
-			{
-				ItToId itToId(min.y, max.y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), drawRow);
-			}
+				ParallelFor(min.y, max.y, 0, drawRow);
 			else
 				for (int y = min.y; y < max.y; ++y)
 					drawRow(y);
@@ -111,10 +108,7 @@ namespace Tools
 
 
 			if constexpr (parallelProcessing && 1)
-			{
-				ItToId itToId(min.y, max.y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), drawRow);
-			}
+				ParallelFor(min.y, max.y, 0, drawRow);
 			else
 				for (int y = min.y; y <= max.y; ++y)
 					drawRow(y);
@@ -154,10 +148,7 @@ namespace Tools
 			};
 
 			if constexpr (parallelProcessing && 1)
-			{
-				ItToId itToId(min.y, max.y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), drawRow);
-			}
+				ParallelFor(min.y, max.y, 0, drawRow);
 			else
 				for (int y = min.y; y <= max.y; ++y)
 					drawRow(y);
@@ -216,10 +207,7 @@ namespace Tools
 				};
 
 				if constexpr (parallelProcessing && 1)
-				{
-					ItToId itToId(res.y);
-					std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-				}
+					ParallelFor(0, res.y, 0, processRow);
 				else
 					for (int y = 0; y < res.y; ++y)
 						processRow(y);
@@ -312,10 +300,7 @@ namespace Tools
 			};
 
 			if constexpr (parallelProcessing && 1)
-			{
-				Tools::ItToId itToId(clippedTextureSubData.size.y);
-				std::for_each(std::execution::par_unseq, itToId.begin(), itToId.end(), processRow);
-			}
+				ParallelFor(0, clippedTextureSubData.size.y, 0, processRow);
 			else
 				for (int y = 0; y < clippedTextureSubData.size.y; ++y)
 					processRow(y);
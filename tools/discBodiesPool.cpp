@@ -0,0 +1,130 @@
+#include "discBodiesPool.hpp"
+
+#include <cassert>
+
+namespace Tools
+{
+	DiscBodiesPool::DiscBodiesPool(unsigned capacity):
+		capacity(capacity)
+	{
+	}
+
+	DiscBodiesPool::~DiscBodiesPool()
+	{
+		clear();
+	}
+
+	Body DiscBodiesPool::acquire(float radius, const BodyParams& bodyParams)
+	{
+		if (freeBodies.empty())
+		{
+			if (numOfPooledBodies >= capacity)
+				return CreateDiscBody(radius, bodyParams);
+
+			Body body = CreateDiscBody(radius, bodyParams);
+			AccessUserData(*body).pooled = true;
+			++numOfPooledBodies;
+
+			return body;
+		}
+
+		Body body(freeBodies.back());
+		freeBodies.pop_back();
+		rearm(*body, radius, bodyParams);
+
+		return body;
+	}
+
+	void DiscBodiesPool::release(Body body)
+	{
+		if (!body || !AccessUserData(*body).pooled)
+			return;
+
+		if (numOfPooledBodies > capacity)
+		{
+			--numOfPooledBodies;
+			return;
+		}
+
+		body->SetEnabled(false);
+		AccessUserData(*body) = BodyUserData{ .pooled = true };
+		freeBodies.push_back(body.release());
+	}
+
+	void DiscBodiesPool::preallocate(unsigned count)
+	{
+		while (freeBodies.size() < count && numOfPooledBodies < capacity)
+		{
+			Body body = CreateDiscBody(1.0f, BodyParams{}.bodyType(b2_dynamicBody));
+			AccessUserData(*body).pooled = true;
+			++numOfPooledBodies;
+			release(std::move(body));
+		}
+	}
+
+	void DiscBodiesPool::clear()
+	{
+		for (auto* body : freeBodies)
+			b2BodyDeleter{}(body);
+
+		numOfPooledBodies -= (unsigned)freeBodies.size();
+		freeBodies.clear();
+	}
+
+	void DiscBodiesPool::setCapacity(unsigned value)
+	{
+		capacity = value;
+
+		while (numOfPooledBodies > capacity && !freeBodies.empty())
+		{
+			b2BodyDeleter{}(freeBodies.back());
+			freeBodies.pop_back();
+			--numOfPooledBodies;
+		}
+	}
+
+	unsigned DiscBodiesPool::getCapacity() const
+	{
+		return capacity;
+	}
+
+	unsigned DiscBodiesPool::getNumOfPooledBodies() const
+	{
+		return numOfPooledBodies;
+	}
+
+	unsigned DiscBodiesPool::getNumOfFreeBodies() const
+	{
+		return (unsigned)freeBodies.size();
+	}
+
+	void DiscBodiesPool::rearm(b2Body& body, float radius, const BodyParams& bodyParams) const
+	{
+		auto& fixture = *body.GetFixtureList();
+		assert(fixture.GetType() == b2Shape::e_circle && !fixture.GetNext());
+
+		// Body is disabled, so there are no broad-phase proxies to update until it is enabled again.
+		static_cast<b2CircleShape&>(*fixture.GetShape()).m_radius = radius;
+		fixture.SetDensity(bodyParams.density_);
+		fixture.SetRestitution(bodyParams.restitution_);
+		fixture.SetFriction(bodyParams.friction_);
+		fixture.SetSensor(bodyParams.sensor_);
+		b2Filter filter;
+		filter.categoryBits = bodyParams.categoryBits_;
+		fixture.SetFilterData(filter);
+
+		body.SetType(bodyParams.bodyType_);
+		body.SetTransform({ bodyParams.position_.x, bodyParams.position_.y }, bodyParams.angle_);
+		body.SetLinearVelocity({ bodyParams.velocity_.x, bodyParams.velocity_.y });
+		body.SetAngularVelocity(bodyParams.angularVelocity_);
+		body.SetLinearDamping(bodyParams.linearDamping_);
+		body.SetAngularDamping(bodyParams.angularDamping_);
+		body.SetSleepingAllowed(bodyParams.autoSleeping_);
+		body.SetBullet(bodyParams.bullet_);
+		body.SetFixedRotation(bodyParams.fixedRotation_);
+		body.ResetMassData();
+
+		body.SetEnabled(true);
+		body.SetAwake(!bodyParams.sleeping_);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "b2Helpers.hpp"
+
+#include <vector>
+
+namespace Tools
+{
+	// Disabled disc bodies kept in the world for reuse, so bursts of short living bodies (e.g. shockwave particles) don't churn Box2D allocations.
+	class DiscBodiesPool
+	{
+	public:
+		DiscBodiesPool(unsigned capacity = 4096);
+		~DiscBodiesPool();
+
+		DiscBodiesPool(const DiscBodiesPool&) = delete;
+		DiscBodiesPool& operator=(const DiscBodiesPool&) = delete;
+
+		// If the pool is exhausted and its capacity reached, a regular body is created instead.
+		Body acquire(float radius, const BodyParams& bodyParams);
+
+		// Bodies which don't come from the pool are just destroyed.
+		void release(Body body);
+
+		void preallocate(unsigned count);
+		void clear();
+
+		void setCapacity(unsigned value);
+		unsigned getCapacity() const;
+		unsigned getNumOfPooledBodies() const;
+		unsigned getNumOfFreeBodies() const;
+
+	private:
+		void rearm(b2Body& body, float radius, const BodyParams& bodyParams) const;
+
+		unsigned capacity;
+		unsigned numOfPooledBodies = 0;
+		std::vector<b2Body*> freeBodies;
+	};
+}
@@ -0,0 +1,152 @@
+#include "frameBenchmark.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cassert>
+
+namespace
+{
+	constexpr unsigned histogramBuckets = 16;
+	constexpr const char* frameTotalName = "frameTotal";
+
+	float Percentile(const std::vector<float>& sortedSamples, float percentile)
+	{
+		assert(!sortedSamples.empty());
+		const auto index = (size_t)std::ceil(percentile * sortedSamples.size()) - 1;
+		return sortedSamples[std::clamp(index, (size_t)0, sortedSamples.size() - 1)];
+	}
+}
+
+namespace Tools
+{
+	FrameBenchmark::FrameBenchmark(std::string scenarioName, unsigned framesToRun, float fixedFrameDuration):
+		scenarioName(std::move(scenarioName)),
+		framesToRun(framesToRun),
+		fixedFrameDuration(fixedFrameDuration)
+	{
+	}
+
+	void FrameBenchmark::frameBegin()
+	{
+		if (!frameStart)
+			frameStart = std::chrono::high_resolution_clock::now();
+	}
+
+	void FrameBenchmark::frameDone()
+	{
+		assert(frameStart);
+		const auto frameEnd = std::chrono::high_resolution_clock::now();
+		addSample(frameTotalName, std::chrono::duration<float, std::micro>(frameEnd - *frameStart).count());
+		frameStart = frameEnd;
+		++framesDone;
+	}
+
+	bool FrameBenchmark::finished() const
+	{
+		return framesDone >= framesToRun;
+	}
+
+	unsigned FrameBenchmark::getFramesToRun() const
+	{
+		return framesToRun;
+	}
+
+	unsigned FrameBenchmark::getFramesDone() const
+	{
+		return framesDone;
+	}
+
+	float FrameBenchmark::getFixedFrameDuration() const
+	{
+		return fixedFrameDuration;
+	}
+
+	FrameBenchmark::Stats FrameBenchmark::getStats(const std::string& systemName) const
+	{
+		Stats stats;
+		stats.histogram.resize(histogramBuckets);
+
+		auto it = systemsSamples.find(systemName);
+		if (it == systemsSamples.end() || it->second.empty())
+			return stats;
+
+		auto sortedSamples = it->second;
+		std::sort(sortedSamples.begin(), sortedSamples.end());
+
+		stats.p50 = Percentile(sortedSamples, 0.5f);
+		stats.p90 = Percentile(sortedSamples, 0.9f);
+		stats.p99 = Percentile(sortedSamples, 0.99f);
+		stats.mean = std::accumulate(sortedSamples.begin(), sortedSamples.end(), 0.0f) / sortedSamples.size();
+		stats.max = sortedSamples.back();
+
+		// Bucket i holds samples in [2^(i-1), 2^i) microseconds; the last bucket is open-ended.
+		for (float sample : sortedSamples)
+		{
+			const auto bucket = sample < 1.0f ? 0u : (unsigned)std::log2(sample) + 1;
+			++stats.histogram[std::min(bucket, histogramBuckets - 1)];
+		}
+
+		return stats;
+	}
+
+	std::string FrameBenchmark::toJson() const
+	{
+		std::ostringstream json;
+
+		json << "{\n";
+		json << "\t\"scenario\": \"" << scenarioName << "\",\n";
+		json << "\t\"frames\": " << framesDone << ",\n";
+		json << "\t\"fixedFrameDuration\": " << fixedFrameDuration << ",\n";
+		json << "\t\"unit\": \"us\",\n";
+		json << "\t\"histogramBuckets\": \"log2\",\n";
+		json << "\t\"systems\": {";
+
+		for (size_t i = 0; i < systemsOrder.size(); ++i)
+		{
+			const auto stats = getStats(systemsOrder[i]);
+
+			json << (i == 0 ? "\n" : ",\n");
+			json << "\t\t\"" << systemsOrder[i] << "\": { ";
+			json << "\"p50\": " << stats.p50 << ", ";
+			json << "\"p90\": " << stats.p90 << ", ";
+			json << "\"p99\": " << stats.p99 << ", ";
+			json << "\"mean\": " << stats.mean << ", ";
+			json << "\"max\": " << stats.max << ", ";
+			json << "\"histogram\": [";
+			for (size_t j = 0; j < stats.histogram.size(); ++j)
+				json << (j == 0 ? "" : ", ") << stats.histogram[j];
+			json << "] }";
+		}
+
+		json << "\n\t}\n}\n";
+
+		return json.str();
+	}
+
+	void FrameBenchmark::saveJson(const std::string& filePath) const
+	{
+		std::ofstream file(filePath);
+		if (!file)
+			throw std::runtime_error("Unable to save benchmark results to " + filePath + ".");
+
+		file << toJson();
+	}
+
+	void FrameBenchmark::addSample(const std::string& systemName, float durationUs)
+	{
+		std::lock_guard lock(samplesMutex);
+
+		auto [it, inserted] = systemsSamples.try_emplace(systemName);
+		if (inserted)
+		{
+			systemsOrder.push_back(systemName);
+			it->second.reserve(framesToRun);
+		}
+
+		it->second.push_back(durationUs);
+	}
+}
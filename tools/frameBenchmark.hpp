@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+namespace Tools
+{
+	class FrameBenchmark
+	{
+	public:
+		struct Stats
+		{
+			float p50 = 0.0f;
+			float p90 = 0.0f;
+			float p99 = 0.0f;
+			float mean = 0.0f;
+			float max = 0.0f;
+			std::vector<unsigned> histogram;
+		};
+
+		FrameBenchmark(std::string scenarioName, unsigned framesToRun, float fixedFrameDuration);
+
+		// Can be called concurrently by systems running on different threads.
+		template <typename Function>
+		void measure(const std::string& systemName, Function&& function)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			std::forward<Function>(function)();
+			const auto end = std::chrono::high_resolution_clock::now();
+
+			addSample(systemName, std::chrono::duration<float, std::micro>(end - start).count());
+		}
+
+		// Frame time is measured from the begin of the first frame, so setup is excluded, and then from the end of the previous one.
+		void frameBegin();
+		void frameDone();
+		bool finished() const;
+
+		unsigned getFramesToRun() const;
+		unsigned getFramesDone() const;
+		float getFixedFrameDuration() const;
+
+		Stats getStats(const std::string& systemName) const;
+		std::string toJson() const;
+		void saveJson(const std::string& filePath) const;
+
+	private:
+		void addSample(const std::string& systemName, float durationUs);
+
+		std::string scenarioName;
+		unsigned framesToRun;
+		float fixedFrameDuration;
+
+		unsigned framesDone = 0;
+		std::optional<std::chrono::high_resolution_clock::time_point> frameStart;
+
+		std::vector<std::string> systemsOrder;
+		std::unordered_map<std::string, std::vector<float>> systemsSamples;
+		std::mutex samplesMutex;
+	};
+}
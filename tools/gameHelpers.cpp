@@ -147,7 +147,7 @@ namespace Tools
 					glm::translate(
 						glm::scale(
 							glm::rotate(
-								glm::translate(Tools::GetModelMatrix(*plane.body), { params.thrustOffset_.x, (i == 0 ? -1 : 1) * params.thrustOffset_.y, 0.0f }),
+								glm::translate(Tools::GetInterpolatedModelMatrix(*plane.body), { params.thrustOffset_.x, (i == 0 ? -1 : 1) * params.thrustOffset_.y, 0.0f }),
 								-glm::half_pi<float>() + (i == 0 ? 1 : -1) * params.thrustAngle_, { 0.0f, 0.0f, 1.0f }),
 							{ 0.5f + thrust * 0.02f, thrust, 1.0f }),
 						{ 0.0f, -0.5f, 0.0f }));
@@ -162,9 +162,9 @@ namespace Tools
 
 				thrustAnimatedTexture.component->setSpeedScaling(1.0f + (thrust - 1) * 0.2f);
 
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-				return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+				return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 			};
 		}
 
@@ -188,7 +188,7 @@ namespace Tools
 		missile.renderingSetupF = [modelUniform = UniformsUtils::UniformMat4f(), &body](ShadersUtils::ProgramId program) mutable {
 			if (!modelUniform.isValid())
 				modelUniform.reset(program, "model");
-			modelUniform(Tools::GetModelMatrix(body));
+			modelUniform(Tools::GetInterpolatedModelMatrix(body));
 			return nullptr;
 		};
 
@@ -200,7 +200,7 @@ namespace Tools
 		decoration.renderingSetupF = [&, modelUniform = UniformsUtils::UniformMat4f(), thrustScale = 0.1f](ShadersUtils::ProgramId program) mutable {
 			if (!modelUniform.isValid())
 				modelUniform.reset(program, "model");
-			modelUniform(glm::scale(glm::rotate(glm::translate(Tools::GetModelMatrix(*missile.body),
+			modelUniform(glm::scale(glm::rotate(glm::translate(Tools::GetInterpolatedModelMatrix(*missile.body),
 				{ -0.5f, 0.0f, 0.0f }),
 				-glm::half_pi<float>(), { 0.0f, 0.0f, 1.0f }),
 				{ std::min(thrustScale * 0.2f, 0.3f), thrustScale, 1.0f }));
@@ -208,9 +208,9 @@ namespace Tools
 			const float targetFrameDurationFactor = Globals::Components().physics().frameDuration * 6.0f;
 			thrustScale = std::min(thrustScale * (1.0f + targetFrameDurationFactor), 3.0f);
 
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+			glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-			return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+			return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 		};
 
 		decoration.renderLayer = RenderLayer::FarMidground;
@@ -243,11 +243,11 @@ namespace Tools
 					glm::vec3(-Globals::Components().camera2D().details.prevPosition * (0.0002f + layer * 0.0002f), 0.0f)));
 				program.color(fColor() * glm::vec4(1.0f, 1.0f, 1.0f, alphaPerLayer));
 
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
 				return [&]() mutable {
 					program.vp(Globals::Components().vpDefault2D().getVP());
-					glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+					glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 				};
 			};
 
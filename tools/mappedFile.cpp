@@ -0,0 +1,107 @@
+#include "mappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tools
+{
+	MappedFile::MappedFile(const std::string& path)
+	{
+		// Handles can be closed right after mapping, the view keeps the file open.
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+
+		LARGE_INTEGER fileSize{};
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			if (const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+			{
+				data = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+				if (data)
+					size = (size_t)fileSize.QuadPart;
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return;
+
+		struct stat fileStat{};
+		if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+		{
+			void* mapping = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+			if (mapping != MAP_FAILED)
+			{
+				data = static_cast<std::byte*>(mapping);
+				size = (size_t)fileStat.st_size;
+			}
+		}
+		::close(file);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept:
+		data(std::exchange(other.data, nullptr)),
+		size(std::exchange(other.size, 0))
+	{
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+		return *this;
+	}
+
+	bool MappedFile::isOpen() const
+	{
+		return data != nullptr;
+	}
+
+	std::byte* MappedFile::getData() const
+	{
+		return data;
+	}
+
+	size_t MappedFile::getSize() const
+	{
+		return size;
+	}
+
+	void MappedFile::close()
+	{
+		if (!data)
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap(data, size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Tools
+{
+	// Whole file mapped into memory. Mapping is copy-on-write, so the content can be modified in memory without affecting the file.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool isOpen() const;
+		std::byte* getData() const;
+		size_t getSize() const;
+
+	private:
+		void close();
+
+		std::byte* data = nullptr;
+		size_t size = 0;
+	};
+}
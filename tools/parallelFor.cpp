@@ -0,0 +1,86 @@
+#include "parallelFor.hpp"
+
+#include <globals/threadPool.hpp>
+
+#include <commonTypes/threadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	constexpr size_t chunksPerThread = 4;
+}
+
+namespace Tools
+{
+	void ParallelForChunks(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& chunkF)
+	{
+		if (begin >= end)
+			return;
+
+		auto& threadPool = Globals::ThreadPool();
+		const size_t size = end - begin;
+		const size_t numOfThreads = (size_t)threadPool.getNumOfWorkers() + 1;
+		if (grainSize == 0)
+			grainSize = std::max<size_t>(1, size / (numOfThreads * chunksPerThread));
+		const size_t numOfChunks = (size + grainSize - 1) / grainSize;
+
+		if (numOfChunks == 1)
+		{
+			chunkF(begin, end);
+			return;
+		}
+
+		// Chunks are claimed dynamically, so uneven chunks are balanced. State is shared with helper jobs, so the caller waits only for claimed chunks,
+		// never for helpers which are still queued behind other jobs. Such helpers find no chunks left and don't touch chunkF, which may be gone then.
+		struct State
+		{
+			std::atomic<size_t> nextChunk = 0;
+			std::atomic<size_t> completedChunks = 0;
+			std::atomic<bool> failed = false;
+			std::exception_ptr exception;
+			std::mutex exceptionMutex;
+		};
+
+		auto state = std::make_shared<State>();
+
+		auto runChunks = [state, begin, end, grainSize, numOfChunks, chunkF = &chunkF]() {
+			for (size_t chunk = state->nextChunk++; chunk < numOfChunks; chunk = state->nextChunk++)
+			{
+				const size_t chunkBegin = begin + chunk * grainSize;
+				if (!state->failed)
+					try
+					{
+						(*chunkF)(chunkBegin, std::min(chunkBegin + grainSize, end));
+					}
+					catch (...)
+					{
+						std::scoped_lock lock(state->exceptionMutex);
+						if (!state->exception)
+							state->exception = std::current_exception();
+						state->failed = true;
+					}
+
+				if (++state->completedChunks == numOfChunks)
+					state->completedChunks.notify_all();
+			}
+			};
+
+		const size_t numOfHelpers = std::min(numOfChunks, numOfThreads) - 1;
+		for (size_t i = 0; i < numOfHelpers; ++i)
+			threadPool.submit(runChunks);
+
+		runChunks();
+
+		// Caller doesn't run unrelated pending jobs, as they may be long (e.g. texture decoding), it waits only for chunks claimed by helpers.
+		for (size_t completedChunks = state->completedChunks; completedChunks < numOfChunks; completedChunks = state->completedChunks)
+			state->completedChunks.wait(completedChunks);
+
+		if (state->exception)
+			std::rethrow_exception(state->exception);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/common.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace Tools
+{
+	// Chunks of [begin, end) are run by the calling thread and the workers of the global thread pool. Returns once all of them are done.
+	// Zero grain size splits the range into a few chunks per thread. The first exception thrown by a chunk is rethrown to the caller.
+	void ParallelForChunks(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& chunkF);
+
+	template <typename F>
+	inline void ParallelFor(size_t begin, size_t end, size_t grainSize, F&& f)
+	{
+		ParallelForChunks(begin, end, grainSize, [&](size_t chunkBegin, size_t chunkEnd) {
+			for (size_t i = chunkBegin; i < chunkEnd; ++i)
+				f(i);
+			});
+	}
+
+	// Tiles cover [begin, end) and are clipped at its edges. Every tile is a single job, called with its begin and end.
+	template <typename F>
+	inline void ParallelFor2D(glm::ivec2 begin, glm::ivec2 end, glm::ivec2 tileSize, F&& f)
+	{
+		if (end.x <= begin.x || end.y <= begin.y)
+			return;
+
+		const glm::ivec2 numOfTiles = (end - begin + tileSize - 1) / tileSize;
+		ParallelFor(0, (size_t)numOfTiles.x * numOfTiles.y, 1, [&](size_t tileId) {
+			const glm::ivec2 tileBegin = begin + glm::ivec2((int)(tileId % numOfTiles.x), (int)(tileId / numOfTiles.x)) * tileSize;
+			f(tileBegin, glm::min(tileBegin + tileSize, end));
+			});
+	}
+}
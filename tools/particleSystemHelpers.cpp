@@ -32,21 +32,21 @@ namespace Tools
 			explosionDecoration.renderLayer = params.renderLayer_;
 			explosionDecoration.targetTextures = { Globals::Components().standardRenderTexture(params.renderMode_) };
 			explosionDecoration.drawMode = GL_POINTS;
-			explosionDecoration.bufferDataUsage = GL_DYNAMIC_DRAW;
+			explosionDecoration.bufferDataUsage = GL_STREAM_DRAW;
 
 			explosionDecoration.renderingSetupF = [params, startTime = Globals::Components().physics().simulationDuration, &billboards](ShadersUtils::ProgramId program) mutable {
 				billboards.vp(Globals::Components().vpDefault2D().getVP());
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, params.explosionTexture_.component->loaded.textureObject);
+				glProxyActiveTexture(GL_TEXTURE0);
+				glProxyBindTexture(GL_TEXTURE_2D, params.explosionTexture_.component->loaded.textureObject);
 				billboards.texture0(0);
 
 				const float elapsed = Globals::Components().physics().simulationDuration - startTime;
 
 				if (params.additiveBlending_)
 				{
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+					glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 					billboards.color(glm::vec4(glm::vec3(glm::pow(1.0f - elapsed / (params.explosionDuration_ * 2.0f), 10.0f)), 1.0f) * params.color_);
-					return std::function<void()>([]() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); });
+					return std::function<void()>([]() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); });
 				}
 				else
 				{
@@ -105,10 +105,10 @@ namespace Tools
 		sparking.renderingSetupF = [&, params](auto&) {
 			Globals::Shaders().trails().vp(Globals::Components().vpDefault2D().getVP());
 			Globals::Shaders().trails().deltaTimeFactor(params.trailsScale_);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+			glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 			glLineWidth(params.lineWidth_);
 			return [&]() {
-				glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+				glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 				glLineWidth(Globals::Components().graphicsSettings().lineWidth);
 			};
 		};
@@ -164,14 +164,14 @@ namespace Tools
 			particlesInstance.customShadersProgram = &billboardsShader;
 			particlesInstance.renderingSetupF = [&, params](auto&) mutable -> std::function<void()> {
 				billboardsShader.vp(Globals::Components().vpDefault2D().getVP());
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, params.texture_.component->loaded.textureObject);
+				glProxyActiveTexture(GL_TEXTURE0);
+				glProxyBindTexture(GL_TEXTURE_2D, params.texture_.component->loaded.textureObject);
 				billboardsShader.texture0(0);
 
 				if (params.blendMode_ == ParticleSystemParams::BlendMode::Additive)
 				{
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-					return []() { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
+					glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
+					return []() { glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); };
 				}
 
 				return nullptr;
@@ -187,12 +187,12 @@ namespace Tools
 				glPointSize(params.pointSize_);
 				
 				if (params.blendMode_ == ParticleSystemParams::BlendMode::Additive)
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+					glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
 				return [=]() {
 					glProxySetPointSmooth(prevPointSmooth);
 					glPointSize(prevPointSize);
-					glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+					glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 				};
 			};
 		}
@@ -210,12 +210,12 @@ namespace Tools
 				trailsShader.deltaTimeFactor(params.deltaTimeFactor_);
 
 				if (params.blendMode_ == ParticleSystemParams::BlendMode::Additive)
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+					glProxyBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
 				return [=]() {
 					glProxySetLineSmooth(prevLineSmooth);
 					glLineWidth(prevLineWidth);
-					glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+					glProxyBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 				};
 			};
 		}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "glmHelpers.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Tools
+{
+	template <typename Value>
+	class SpatialHash
+	{
+	public:
+		struct Entry
+		{
+			glm::vec2 position;
+			float radius;
+			Value value;
+		};
+
+		struct QueryResult
+		{
+			const Entry* entry;
+			float distance;
+		};
+
+		SpatialHash(float cellSize):
+			cellSize(cellSize)
+		{
+			assert(cellSize > 0.0f);
+		}
+
+		// Cells' vectors are kept, so rebuilding the index every frame doesn't allocate once it warmed up.
+		void clear()
+		{
+			for (auto& [cellKey, cellEntries] : cells)
+				cellEntries.clear();
+			entries.clear();
+			maxRadius = 0.0f;
+			minCell = glm::ivec2(std::numeric_limits<int>::max());
+			maxCell = glm::ivec2(std::numeric_limits<int>::min());
+		}
+
+		void insert(glm::vec2 position, float radius, Value value)
+		{
+			const auto cell = getCell(position);
+			cells[getCellKey(cell)].push_back((unsigned)entries.size());
+			entries.push_back({ position, radius, std::move(value) });
+			maxRadius = std::max(maxRadius, radius);
+			minCell = glm::min(minCell, cell);
+			maxCell = glm::max(maxCell, cell);
+		}
+
+		const std::vector<Entry>& getEntries() const
+		{
+			return entries;
+		}
+
+		float getCellSize() const
+		{
+			return cellSize;
+		}
+
+		// Calls f(entry, distance) for every entry whose position is not further than radius from center.
+		template <typename Function>
+		void forEachInRadius(glm::vec2 center, float radius, Function f) const
+		{
+			forEachInCellsRange(center, radius, [&](const Entry& entry) {
+				const float distance = glm::distance(center, entry.position);
+				if (distance <= radius)
+					f(entry, distance);
+			});
+		}
+
+		void queryRadius(glm::vec2 center, float radius, std::vector<QueryResult>& result, bool sortByDistance = true) const
+		{
+			result.clear();
+			forEachInRadius(center, radius, [&](const Entry& entry, float distance) {
+				result.push_back({ &entry, distance });
+			});
+
+			if (sortByDistance)
+				std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+		}
+
+		// Result is sorted by distance. Cells are visited in growing rings around the center until no unvisited cell can contain anything closer.
+		void queryKNearest(glm::vec2 center, unsigned k, std::vector<QueryResult>& result, float maxDistance = std::numeric_limits<float>::infinity()) const
+		{
+			result.clear();
+
+			if (k == 0 || entries.empty())
+				return;
+
+			auto byDistance = [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; };
+
+			const auto centerCell = getCell(center);
+			const int maxRing = std::max({ std::abs(centerCell.x - minCell.x), std::abs(centerCell.x - maxCell.x),
+				std::abs(centerCell.y - minCell.y), std::abs(centerCell.y - maxCell.y) });
+
+			for (int ring = 0; ring <= maxRing; ++ring)
+			{
+				if (ring * cellSize - cellSize > maxDistance)
+					break;
+
+				forEachCellInRing(centerCell, ring, [&](glm::ivec2, const std::vector<unsigned>& cellEntries) {
+					for (auto entryId : cellEntries)
+					{
+						const auto& entry = entries[entryId];
+						const float distance = glm::distance(center, entry.position);
+						if (distance <= maxDistance)
+							result.push_back({ &entry, distance });
+					}
+				});
+
+				if (result.size() >= k)
+				{
+					std::nth_element(result.begin(), result.begin() + (k - 1), result.end(), byDistance);
+					if (result[k - 1].distance <= ring * cellSize)
+						break;
+				}
+			}
+
+			const auto resultSize = std::min((size_t)k, result.size());
+			std::partial_sort(result.begin(), result.begin() + resultSize, result.end(), byDistance);
+			result.resize(resultSize);
+		}
+
+		// Entries (treated as circles) between nv1 and nv2 directions, or touched by one of them, as in manual aiming.
+		void queryCone(glm::vec2 origin, glm::vec2 nv1, glm::vec2 nv2, float maxDistance, std::vector<QueryResult>& result, bool sortByDistance = true) const
+		{
+			result.clear();
+			forEachInCellsRange(origin, maxDistance + maxRadius, [&](const Entry& entry) {
+				const float distance = glm::distance(origin, entry.position);
+				if (distance <= maxDistance && IsInCone(origin, nv1, nv2, entry))
+					result.push_back({ &entry, distance });
+			});
+
+			if (sortByDistance)
+				std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+		}
+
+		// Unbounded cone test. Cells are visited in growing rings around the origin and only the ones overlapping the cone are searched, so it returns early
+		// if any entry near the origin is in the cone.
+		bool anyInCone(glm::vec2 origin, glm::vec2 nv1, glm::vec2 nv2) const
+		{
+			if (entries.empty())
+				return false;
+
+			const auto originCell = getCell(origin);
+			const int maxRing = std::max({ std::abs(originCell.x - minCell.x), std::abs(originCell.x - maxCell.x),
+				std::abs(originCell.y - minCell.y), std::abs(originCell.y - maxCell.y) });
+
+			// Entries are stored in cells of their positions, so their circles are within circles bounding cells, enlarged by the max radius.
+			const float cellBoundingRadius = cellSize * std::sqrt(0.5f) + maxRadius;
+
+			bool found = false;
+			for (int ring = 0; ring <= maxRing && !found; ++ring)
+				forEachCellInRing(originCell, ring, [&](glm::ivec2 cell, const std::vector<unsigned>& cellEntries) {
+					if (found || cellEntries.empty() || !IsInCone(origin, nv1, nv2, { (glm::vec2(cell) + 0.5f) * cellSize, cellBoundingRadius, Value{} }))
+						return;
+
+					found = std::any_of(cellEntries.begin(), cellEntries.end(), [&](auto entryId) {
+						return IsInCone(origin, nv1, nv2, entries[entryId]);
+					});
+				});
+
+			return found;
+		}
+
+		static bool IsInCone(glm::vec2 origin, glm::vec2 nv1, glm::vec2 nv2, const Entry& entry)
+		{
+			return IsPointBetweenVectors(entry.position, origin, nv1, nv2) ||
+				DoesRayIntersectCircle(origin, nv1, entry.position, entry.radius) ||
+				DoesRayIntersectCircle(origin, nv2, entry.position, entry.radius);
+		}
+
+	private:
+		glm::ivec2 getCell(glm::vec2 position) const
+		{
+			constexpr float cellLimit = (float)(std::numeric_limits<int>::max() / 2);
+			auto toCell = [&](float coord) { return (int)std::clamp(std::floor(coord / cellSize), -cellLimit, cellLimit); };
+			return { toCell(position.x), toCell(position.y) };
+		}
+
+		static std::uint64_t getCellKey(glm::ivec2 cell)
+		{
+			return ((std::uint64_t)(std::uint32_t)cell.x << 32) | (std::uint32_t)cell.y;
+		}
+
+		template <typename Function>
+		void forEachInCellsRange(glm::vec2 center, float radius, Function f) const
+		{
+			if (entries.empty())
+				return;
+
+			// Query bigger than the populated area (or unbounded) - it is cheaper to go through entries directly.
+			const glm::vec2 boundsMin = glm::vec2(minCell) * cellSize;
+			const glm::vec2 boundsMax = glm::vec2(maxCell + 1) * cellSize;
+			if (!std::isfinite(radius) || (center.x - radius <= boundsMin.x && center.y - radius <= boundsMin.y
+				&& center.x + radius >= boundsMax.x && center.y + radius >= boundsMax.y))
+			{
+				for (const auto& entry : entries)
+					f(entry);
+				return;
+			}
+
+			const auto fromCell = glm::max(getCell(center - radius), minCell);
+			const auto toCell = glm::min(getCell(center + radius), maxCell);
+
+			for (int y = fromCell.y; y <= toCell.y; ++y)
+				for (int x = fromCell.x; x <= toCell.x; ++x)
+				{
+					auto it = cells.find(getCellKey({ x, y }));
+					if (it == cells.end())
+						continue;
+					for (auto entryId : it->second)
+						f(entries[entryId]);
+				}
+		}
+
+		template <typename Function>
+		void forEachCellInRing(glm::ivec2 centerCell, int ring, Function f) const
+		{
+			auto visitCell = [&](int x, int y) {
+				auto it = cells.find(getCellKey({ x, y }));
+				if (it != cells.end())
+					f(glm::ivec2(x, y), it->second);
+			};
+
+			if (ring == 0)
+			{
+				visitCell(centerCell.x, centerCell.y);
+				return;
+			}
+
+			for (int x = centerCell.x - ring; x <= centerCell.x + ring; ++x)
+			{
+				visitCell(x, centerCell.y - ring);
+				visitCell(x, centerCell.y + ring);
+			}
+
+			for (int y = centerCell.y - ring + 1; y <= centerCell.y + ring - 1; ++y)
+			{
+				visitCell(centerCell.x - ring, y);
+				visitCell(centerCell.x + ring, y);
+			}
+		}
+
+		float cellSize;
+		float maxRadius = 0.0f;
+		glm::ivec2 minCell{ std::numeric_limits<int>::max() };
+		glm::ivec2 maxCell{ std::numeric_limits<int>::min() };
+
+		std::vector<Entry> entries;
+		std::unordered_map<std::uint64_t, std::vector<unsigned>> cells;
+	};
+}
@@ -0,0 +1,120 @@
+#include "systemsScheduler.hpp"
+
+#include <commonTypes/threadPool.hpp>
+
+namespace Tools
+{
+	SystemsScheduler::SystemsScheduler(ThreadPool& threadPool):
+		threadPool(threadPool)
+	{
+	}
+
+	void SystemsScheduler::addSystem(Access access, std::function<void()> systemF)
+	{
+		const auto systemId = (unsigned)systems.size();
+		auto& system = systems.emplace_back(System{ access, std::move(systemF) });
+
+		for (unsigned i = 0; i < systemId; ++i)
+		{
+			// Main thread systems are also kept in order, so OpenGL calls are issued deterministically.
+			auto& prevSystem = systems[i];
+			if ((access.writes_ & (prevSystem.access.reads_ | prevSystem.access.writes_)).any() || (access.reads_ & prevSystem.access.writes_).any()
+				|| (access.mainThread_ && prevSystem.access.mainThread_))
+			{
+				prevSystem.dependents.push_back(systemId);
+				++system.numOfDependencies;
+			}
+		}
+
+		remainingDependencies = std::make_unique<std::atomic<unsigned>[]>(systems.size());
+		mainThreadReadySystems.reserve(systems.size());
+	}
+
+	void SystemsScheduler::run(bool parallel)
+	{
+		if (parallel && threadPool.getNumOfWorkers() > 0)
+		{
+			runParallel();
+			return;
+		}
+
+		for (auto& system : systems)
+			system.systemF();
+	}
+
+	void SystemsScheduler::runParallel()
+	{
+		systemsDone = 0;
+		exception = nullptr;
+		mainThreadReadySystems.clear();
+		for (unsigned i = 0; i < systems.size(); ++i)
+			remainingDependencies[i] = systems[i].numOfDependencies;
+
+		for (unsigned i = 0; i < systems.size(); ++i)
+			if (systems[i].numOfDependencies == 0)
+				schedule(i);
+
+		while (true)
+		{
+			std::unique_lock lock(mutex);
+			if (systemsDone == systems.size())
+				break;
+
+			if (!mainThreadReadySystems.empty())
+			{
+				const auto systemId = mainThreadReadySystems.back();
+				mainThreadReadySystems.pop_back();
+				lock.unlock();
+				execute(systemId);
+				continue;
+			}
+
+			lock.unlock();
+			if (threadPool.tryRunPendingJob())
+				continue;
+
+			lock.lock();
+			condition.wait(lock, [&]() { return systemsDone == systems.size() || !mainThreadReadySystems.empty(); });
+		}
+
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+
+	void SystemsScheduler::schedule(unsigned systemId)
+	{
+		if (systems[systemId].access.mainThread_)
+		{
+			std::lock_guard lock(mutex);
+			mainThreadReadySystems.push_back(systemId);
+			condition.notify_one();
+		}
+		else
+			threadPool.submit([this, systemId]() { execute(systemId); });
+	}
+
+	void SystemsScheduler::execute(unsigned systemId)
+	{
+		auto& system = systems[systemId];
+
+		try
+		{
+			system.systemF();
+		}
+		catch (...)
+		{
+			std::lock_guard lock(mutex);
+			if (!exception)
+				exception = std::current_exception();
+		}
+
+		for (auto dependentId : system.dependents)
+			if (--remainingDependencies[dependentId] == 0)
+				schedule(dependentId);
+
+		// Notifying under the lock, as the calling thread may return from run() as soon as it sees the last system done.
+		std::lock_guard lock(mutex);
+		++systemsDone;
+		condition.notify_one();
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+namespace Tools
+{
+	// Systems are run in their registration order, except that the ones which don't conflict on declared resources (write-write or read-write)
+	// may run concurrently. As long as declarations are complete, the result is the same as in serial run.
+	class SystemsScheduler
+	{
+	public:
+		enum class Resource
+		{
+			Physics,
+			Textures,
+			Actors,
+			Temporaries,
+			Structures,
+			Decorations,
+			Camera,
+			Audio,
+			OpenGL,
+			// Global component id generator, used by every emplace, e.g. by step functions spawning explosions or decorations.
+			ComponentIds,
+			COUNT
+		};
+
+		using Resources = std::bitset<(size_t)Resource::COUNT>;
+
+		struct Access
+		{
+			Access& reads(std::initializer_list<Resource> value)
+			{
+				for (auto resource : value)
+					reads_.set((size_t)resource);
+				return *this;
+			}
+
+			Access& writes(std::initializer_list<Resource> value)
+			{
+				for (auto resource : value)
+					writes_.set((size_t)resource);
+				return *this;
+			}
+
+			// OpenGL context is bound to the main thread, so everything touching it has to stay there.
+			Access& mainThread(bool value)
+			{
+				mainThread_ = value;
+				return *this;
+			}
+
+			Resources reads_;
+			Resources writes_;
+			bool mainThread_ = false;
+		};
+
+		SystemsScheduler(ThreadPool& threadPool);
+
+		void addSystem(Access access, std::function<void()> systemF);
+
+		// Serial run is deterministic, parallel one uses workers of the thread pool. Exceptions thrown by systems are rethrown on the calling thread.
+		void run(bool parallel);
+
+	private:
+		struct System
+		{
+			Access access;
+			std::function<void()> systemF;
+			std::vector<unsigned> dependents;
+			unsigned numOfDependencies = 0;
+		};
+
+		void runParallel();
+		void schedule(unsigned systemId);
+		void execute(unsigned systemId);
+
+		ThreadPool& threadPool;
+		std::vector<System> systems;
+
+		std::unique_ptr<std::atomic<unsigned>[]> remainingDependencies;
+		std::vector<unsigned> mainThreadReadySystems;
+		unsigned systemsDone = 0;
+		std::exception_ptr exception;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+}
@@ -0,0 +1,513 @@
+#include "texelKernels.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TEXEL_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC emits any intrinsics, other compilers need instruction sets enabled per function.
+#if defined(TEXEL_KERNELS_X86) && (!defined(_MSC_VER) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2,f16c")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+	using Tools::TexelKernels::InstructionSet;
+	using Tools::TexelKernels::AlphaProcessing;
+
+	template <typename Component>
+	float toFloat(Component value)
+	{
+		if constexpr (std::is_same_v<Component, std::uint8_t>)
+			return value * (1.0f / 255.0f);
+		else
+			return value;
+	}
+
+	template <typename Component>
+	Component fromFloat(float value)
+	{
+		if constexpr (std::is_same_v<Component, std::uint8_t>)
+			return (std::uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		else if constexpr (std::is_same_v<Component, std::uint16_t>)
+			return (std::uint16_t)glm::packHalf1x16(value);
+		else
+			return value;
+	}
+
+	template <typename Component>
+	void processAlphaScalar(Component* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		for (size_t i = 0; i < numOfTexels * 4; i += 4)
+		{
+			float alpha = toFloat(texels[i + 3]);
+			if (alphaProcessing.darkToTransparent)
+				alpha = std::min(toFloat(texels[i]) + toFloat(texels[i + 1]) + toFloat(texels[i + 2]), 1.0f);
+			texels[i + 3] = fromFloat<Component>(alpha);
+
+			const float premultipliedAlphaFactor = alphaProcessing.premultiply ? alpha : 1.0f;
+			const float darkeningFactor = alphaProcessing.transparentToDark ? alpha : 1.0f;
+			for (int c = 0; c < 3; ++c)
+				texels[i + c] = fromFloat<Component>(toFloat(texels[i + c]) * premultipliedAlphaFactor * darkeningFactor);
+		}
+	}
+
+	template <typename Component>
+	void changeNumOfChannelsScalar(const Component* source, int sourceNumOfChannels, Component* dest, int destNumOfChannels, size_t numOfTexels)
+	{
+		const Component defaultComponents[4] = { fromFloat<Component>(0.0f), fromFloat<Component>(0.0f), fromFloat<Component>(0.0f), fromFloat<Component>(1.0f) };
+		const int minChannels = std::min(sourceNumOfChannels, destNumOfChannels);
+
+		for (size_t i = 0; i < numOfTexels; ++i)
+		{
+			const Component* sourceTexel = source + i * sourceNumOfChannels;
+			Component* destTexel = dest + i * destNumOfChannels;
+			for (int c = 0; c < minChannels; ++c)
+				destTexel[c] = sourceTexel[c];
+			for (int c = minChannels; c < destNumOfChannels; ++c)
+				destTexel[c] = defaultComponents[c];
+		}
+	}
+
+	template <typename Component>
+	void packScalar(const float* source, Component* dest, size_t numOfComponents)
+	{
+		for (size_t i = 0; i < numOfComponents; ++i)
+			dest[i] = fromFloat<Component>(source[i]);
+	}
+
+#ifdef TEXEL_KERNELS_X86
+	// Kernels keep the scalar operations' order, so 8 bit results match the scalar ones.
+	TARGET_SSE2 inline __m128 processAlphaTexelSSE2(__m128 rgba, AlphaProcessing alphaProcessing)
+	{
+		__m128 alpha = _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(3, 3, 3, 3));
+		if (alphaProcessing.darkToTransparent)
+		{
+			const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(1, 1, 1, 1))),
+				_mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(2, 2, 2, 2)));
+			alpha = _mm_min_ps(sum, _mm_set1_ps(1.0f));
+		}
+
+		if (alphaProcessing.premultiply)
+			rgba = _mm_mul_ps(rgba, alpha);
+		if (alphaProcessing.transparentToDark)
+			rgba = _mm_mul_ps(rgba, alpha);
+
+		const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+		return _mm_or_ps(_mm_andnot_ps(alphaMask, rgba), _mm_and_ps(alphaMask, alpha));
+	}
+
+	TARGET_SSE2 inline __m128i packUNorm8SSE2(__m128 components)
+	{
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(components, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+	}
+
+	TARGET_SSE2 void processAlphaSSE2(float* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		for (size_t i = 0; i < numOfTexels * 4; i += 4)
+			_mm_storeu_ps(texels + i, processAlphaTexelSSE2(_mm_loadu_ps(texels + i), alphaProcessing));
+	}
+
+	TARGET_SSE2 void processAlphaSSE2(std::uint8_t* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (size_t i = 0; i < numOfTexels * 4; i += 4)
+		{
+			std::int32_t packedTexel;
+			std::memcpy(&packedTexel, texels + i, sizeof(packedTexel));
+			const __m128i components = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packedTexel), zero), zero);
+			const __m128 rgba = _mm_mul_ps(_mm_cvtepi32_ps(components), _mm_set1_ps(1.0f / 255.0f));
+
+			const __m128i newComponents = packUNorm8SSE2(processAlphaTexelSSE2(rgba, alphaProcessing));
+			packedTexel = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(newComponents, newComponents), zero));
+			std::memcpy(texels + i, &packedTexel, sizeof(packedTexel));
+		}
+	}
+
+	// Texels are copied with 4 component loads and stores, so the last texel, which could be accessed out of bounds, is left to the scalar kernel.
+	TARGET_SSE2 void changeNumOfChannelsSSE2(const float* source, int sourceNumOfChannels, float* dest, int destNumOfChannels, size_t numOfTexels)
+	{
+		const size_t numOfVectorTexels = numOfTexels > 0 ? numOfTexels - 1 : 0;
+
+		if (sourceNumOfChannels == 3 && destNumOfChannels == 4)
+		{
+			const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+			const __m128 opaqueAlpha = _mm_and_ps(alphaMask, _mm_set1_ps(1.0f));
+			for (size_t i = 0; i < numOfVectorTexels; ++i)
+				_mm_storeu_ps(dest + i * 4, _mm_or_ps(_mm_andnot_ps(alphaMask, _mm_loadu_ps(source + i * 3)), opaqueAlpha));
+		}
+		else if (sourceNumOfChannels == 4 && destNumOfChannels == 3)
+		{
+			// Stored alpha is overwritten by the next texel.
+			for (size_t i = 0; i < numOfVectorTexels; ++i)
+				_mm_storeu_ps(dest + i * 3, _mm_loadu_ps(source + i * 4));
+		}
+		else
+		{
+			changeNumOfChannelsScalar(source, sourceNumOfChannels, dest, destNumOfChannels, numOfTexels);
+			return;
+		}
+
+		changeNumOfChannelsScalar(source + numOfVectorTexels * sourceNumOfChannels, sourceNumOfChannels, dest + numOfVectorTexels * destNumOfChannels,
+			destNumOfChannels, numOfTexels - numOfVectorTexels);
+	}
+
+	TARGET_SSE2 void packUNorm8SSE2(const float* source, std::uint8_t* dest, size_t numOfComponents)
+	{
+		size_t i = 0;
+		for (; i + 16 <= numOfComponents; i += 16)
+		{
+			const __m128i components01 = _mm_packs_epi32(packUNorm8SSE2(_mm_loadu_ps(source + i)), packUNorm8SSE2(_mm_loadu_ps(source + i + 4)));
+			const __m128i components23 = _mm_packs_epi32(packUNorm8SSE2(_mm_loadu_ps(source + i + 8)), packUNorm8SSE2(_mm_loadu_ps(source + i + 12)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(components01, components23));
+		}
+		packScalar(source + i, dest + i, numOfComponents - i);
+	}
+
+	TARGET_AVX2 inline __m256 processAlphaTexelsAVX2(__m256 rgba, AlphaProcessing alphaProcessing)
+	{
+		__m256 alpha = _mm256_permute_ps(rgba, _MM_SHUFFLE(3, 3, 3, 3));
+		if (alphaProcessing.darkToTransparent)
+		{
+			const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_permute_ps(rgba, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_permute_ps(rgba, _MM_SHUFFLE(1, 1, 1, 1))),
+				_mm256_permute_ps(rgba, _MM_SHUFFLE(2, 2, 2, 2)));
+			alpha = _mm256_min_ps(sum, _mm256_set1_ps(1.0f));
+		}
+
+		if (alphaProcessing.premultiply)
+			rgba = _mm256_mul_ps(rgba, alpha);
+		if (alphaProcessing.transparentToDark)
+			rgba = _mm256_mul_ps(rgba, alpha);
+
+		return _mm256_blend_ps(rgba, alpha, 0b10001000);
+	}
+
+	TARGET_AVX2 inline __m256i packUNorm8AVX2(__m256 components)
+	{
+		const __m256 clamped = _mm256_min_ps(_mm256_max_ps(components, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+		return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+	}
+
+	// Two texels per register.
+	TARGET_AVX2 void processAlphaAVX2(float* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		size_t i = 0;
+		for (; i + 8 <= numOfTexels * 4; i += 8)
+			_mm256_storeu_ps(texels + i, processAlphaTexelsAVX2(_mm256_loadu_ps(texels + i), alphaProcessing));
+		processAlphaSSE2(texels + i, numOfTexels - i / 4, alphaProcessing);
+	}
+
+	TARGET_AVX2 void processAlphaAVX2(std::uint8_t* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		size_t i = 0;
+		for (; i + 8 <= numOfTexels * 4; i += 8)
+		{
+			const __m256i components = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(texels + i)));
+			const __m256 rgba = _mm256_mul_ps(_mm256_cvtepi32_ps(components), _mm256_set1_ps(1.0f / 255.0f));
+
+			const __m256i newComponents = packUNorm8AVX2(processAlphaTexelsAVX2(rgba, alphaProcessing));
+			const __m128i packedComponents = _mm_packs_epi32(_mm256_castsi256_si128(newComponents), _mm256_extracti128_si256(newComponents, 1));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(texels + i), _mm_packus_epi16(packedComponents, packedComponents));
+		}
+		processAlphaSSE2(texels + i, numOfTexels - i / 4, alphaProcessing);
+	}
+
+	// Four texels per shuffle. 16 bytes are loaded, so the last texels, which could be accessed out of bounds, are left to the scalar kernel.
+	TARGET_AVX2 void changeNumOfChannelsAVX2(const std::uint8_t* source, int sourceNumOfChannels, std::uint8_t* dest, int destNumOfChannels, size_t numOfTexels)
+	{
+		size_t i = 0;
+
+		if (sourceNumOfChannels == 3 && destNumOfChannels == 4)
+		{
+			const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i opaqueAlpha = _mm_set1_epi32((int)0xff000000);
+			for (; i * 3 + 16 <= numOfTexels * 3; i += 4)
+			{
+				const __m128i texels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3)), shuffle);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), _mm_or_si128(texels, opaqueAlpha));
+			}
+		}
+		else if (sourceNumOfChannels == 4 && destNumOfChannels == 3)
+		{
+			const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+			for (; i + 4 <= numOfTexels; i += 4)
+			{
+				const __m128i texels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4)), shuffle);
+				const std::int32_t lastTexels = _mm_cvtsi128_si32(_mm_srli_si128(texels, 8));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dest + i * 3), texels);
+				std::memcpy(dest + i * 3 + 8, &lastTexels, sizeof(lastTexels));
+			}
+		}
+
+		changeNumOfChannelsScalar(source + i * sourceNumOfChannels, sourceNumOfChannels, dest + i * destNumOfChannels, destNumOfChannels, numOfTexels - i);
+	}
+
+	TARGET_AVX2 void packUNorm8AVX2(const float* source, std::uint8_t* dest, size_t numOfComponents)
+	{
+		// Packing interleaves 128 bit lanes, the permutation restores the order.
+		const __m256i lanesOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		size_t i = 0;
+		for (; i + 32 <= numOfComponents; i += 32)
+		{
+			const __m256i components01 = _mm256_packs_epi32(packUNorm8AVX2(_mm256_loadu_ps(source + i)), packUNorm8AVX2(_mm256_loadu_ps(source + i + 8)));
+			const __m256i components23 = _mm256_packs_epi32(packUNorm8AVX2(_mm256_loadu_ps(source + i + 16)), packUNorm8AVX2(_mm256_loadu_ps(source + i + 24)));
+			const __m256i components = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(components01, components23), lanesOrder);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), components);
+		}
+		packUNorm8SSE2(source + i, dest + i, numOfComponents - i);
+	}
+
+	// F16C rounds to nearest even, so results may differ from the scalar packing in the last bit.
+	TARGET_AVX2 void packHalfAVX2(const float* source, std::uint16_t* dest, size_t numOfComponents)
+	{
+		size_t i = 0;
+		for (; i + 8 <= numOfComponents; i += 8)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT));
+		packScalar(source + i, dest + i, numOfComponents - i);
+	}
+
+	std::uint64_t getEnabledXStates()
+	{
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		std::uint32_t eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((std::uint64_t)edx << 32) | eax;
+#endif
+	}
+
+	std::array<int, 4> cpuid(int leaf, int subleaf)
+	{
+		std::array<int, 4> registers{};
+#ifdef _MSC_VER
+		__cpuidex(registers.data(), leaf, subleaf);
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+		return registers;
+	}
+#endif
+
+	InstructionSet detectInstructionSet()
+	{
+#ifdef TEXEL_KERNELS_X86
+		const auto features = cpuid(1, 0);
+		const bool sse2 = features[3] & (1 << 26);
+		const bool ssse3 = features[2] & (1 << 9);
+		const bool osxsave = features[2] & (1 << 27);
+		const bool avx = features[2] & (1 << 28);
+		const bool f16c = features[2] & (1 << 29);
+
+		// AVX registers have to be preserved by the OS as well.
+		const bool avxEnabled = osxsave && avx && (getEnabledXStates() & 0x6) == 0x6;
+		const bool avx2 = avxEnabled && cpuid(0, 0)[0] >= 7 && (cpuid(7, 0)[1] & (1 << 5));
+
+		if (avx2 && ssse3 && f16c)
+			return InstructionSet::AVX2;
+		if (sse2)
+			return InstructionSet::SSE2;
+#endif
+		return InstructionSet::Scalar;
+	}
+
+	struct Kernels
+	{
+		void (*processAlphaFloat)(float*, size_t, AlphaProcessing);
+		void (*processAlphaUNorm8)(std::uint8_t*, size_t, AlphaProcessing);
+		void (*changeNumOfChannelsFloat)(const float*, int, float*, int, size_t);
+		void (*changeNumOfChannelsUNorm8)(const std::uint8_t*, int, std::uint8_t*, int, size_t);
+		void (*packUNorm8)(const float*, std::uint8_t*, size_t);
+		void (*packHalf)(const float*, std::uint16_t*, size_t);
+	};
+
+	const Kernels& getKernels(InstructionSet instructionSet)
+	{
+		static const std::array<Kernels, (size_t)InstructionSet::COUNT> kernels = {
+			Kernels{ processAlphaScalar<float>, processAlphaScalar<std::uint8_t>, changeNumOfChannelsScalar<float>, changeNumOfChannelsScalar<std::uint8_t>,
+				packScalar<std::uint8_t>, packScalar<std::uint16_t> },
+#ifdef TEXEL_KERNELS_X86
+			Kernels{ processAlphaSSE2, processAlphaSSE2, changeNumOfChannelsSSE2, changeNumOfChannelsScalar<std::uint8_t>,
+				packUNorm8SSE2, packScalar<std::uint16_t> },
+			Kernels{ processAlphaAVX2, processAlphaAVX2, changeNumOfChannelsSSE2, changeNumOfChannelsAVX2,
+				packUNorm8AVX2, packHalfAVX2 }
+#endif
+		};
+
+		assert(instructionSet <= Tools::TexelKernels::GetInstructionSet());
+		return kernels[(size_t)instructionSet];
+	}
+
+	const Kernels& getKernels()
+	{
+		static const Kernels& kernels = getKernels(Tools::TexelKernels::GetInstructionSet());
+		return kernels;
+	}
+}
+
+namespace Tools::TexelKernels
+{
+	InstructionSet GetInstructionSet()
+	{
+		static const InstructionSet instructionSet = detectInstructionSet();
+		return instructionSet;
+	}
+
+	const char* GetInstructionSetName(InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::Scalar: return "scalar";
+		case InstructionSet::SSE2: return "SSE2";
+		case InstructionSet::AVX2: return "AVX2";
+		default: assert(!"unsupported instruction set"); return "";
+		}
+	}
+
+	void ProcessAlpha(float* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		getKernels().processAlphaFloat(texels, numOfTexels, alphaProcessing);
+	}
+
+	void ProcessAlpha(std::uint8_t* texels, size_t numOfTexels, AlphaProcessing alphaProcessing)
+	{
+		getKernels().processAlphaUNorm8(texels, numOfTexels, alphaProcessing);
+	}
+
+	void ChangeNumOfChannels(const float* source, int sourceNumOfChannels, float* dest, int destNumOfChannels, size_t numOfTexels)
+	{
+		getKernels().changeNumOfChannelsFloat(source, sourceNumOfChannels, dest, destNumOfChannels, numOfTexels);
+	}
+
+	void ChangeNumOfChannels(const std::uint8_t* source, int sourceNumOfChannels, std::uint8_t* dest, int destNumOfChannels, size_t numOfTexels)
+	{
+		getKernels().changeNumOfChannelsUNorm8(source, sourceNumOfChannels, dest, destNumOfChannels, numOfTexels);
+	}
+
+	void PackUNorm8(const float* source, std::uint8_t* dest, size_t numOfComponents)
+	{
+		getKernels().packUNorm8(source, dest, numOfComponents);
+	}
+
+	void PackHalf(const float* source, std::uint16_t* dest, size_t numOfComponents)
+	{
+		getKernels().packHalf(source, dest, numOfComponents);
+	}
+
+	std::string Benchmark()
+	{
+		constexpr size_t numOfTexels = 2048 * 2048;
+		constexpr int numOfRepetitions = 5;
+
+		std::mt19937 randomGenerator(0);
+		std::uniform_real_distribution<float> floatDistribution(-0.1f, 1.1f);
+		std::uniform_int_distribution<int> unorm8Distribution(0, 255);
+
+		std::vector<float> sourceFloats(numOfTexels * 4);
+		std::vector<std::uint8_t> sourceUNorm8s(numOfTexels * 4);
+		std::generate(sourceFloats.begin(), sourceFloats.end(), [&]() { return floatDistribution(randomGenerator); });
+		std::generate(sourceUNorm8s.begin(), sourceUNorm8s.end(), [&]() { return (std::uint8_t)unorm8Distribution(randomGenerator); });
+
+		std::vector<float> floats(numOfTexels * 4);
+		std::vector<std::uint8_t> unorm8s(numOfTexels * 4);
+		std::vector<std::uint16_t> halves(numOfTexels * 4);
+
+		// Best of repetitions. Every repetition starts from the same source, as some kernels work in place.
+		auto measure = [&](const std::function<void()>& prepareF, const std::function<void()>& kernelF) {
+			float bestDurationMs = std::numeric_limits<float>::max();
+			for (int i = 0; i < numOfRepetitions; ++i)
+			{
+				prepareF();
+				const auto start = std::chrono::high_resolution_clock::now();
+				kernelF();
+				const auto end = std::chrono::high_resolution_clock::now();
+				bestDurationMs = std::min(bestDurationMs, std::chrono::duration<float, std::milli>(end - start).count());
+			}
+			return bestDurationMs;
+		};
+
+		const AlphaProcessing premultiply{ true, false, false };
+		const AlphaProcessing darkToTransparent{ true, true, false };
+		const AlphaProcessing transparentToDark{ true, false, true };
+
+		struct Case
+		{
+			const char* name;
+			std::function<void()> prepareF;
+			std::function<void(const Kernels&)> kernelF;
+			std::function<std::vector<std::uint8_t>()> resultF;
+		};
+
+		auto floatsResult = [&]() { return std::vector<std::uint8_t>(reinterpret_cast<const std::uint8_t*>(floats.data()), reinterpret_cast<const std::uint8_t*>(floats.data() + floats.size())); };
+		auto unorm8sResult = [&]() { return unorm8s; };
+		auto halvesResult = [&]() { return std::vector<std::uint8_t>(reinterpret_cast<const std::uint8_t*>(halves.data()), reinterpret_cast<const std::uint8_t*>(halves.data() + halves.size())); };
+		auto copyFloats = [&]() { floats = sourceFloats; };
+		auto copyUNorm8s = [&]() { unorm8s = sourceUNorm8s; };
+		auto nothing = []() {};
+
+		const std::vector<Case> cases = {
+			{ "premultiply float", copyFloats, [&](const Kernels& kernels) { kernels.processAlphaFloat(floats.data(), numOfTexels, premultiply); }, floatsResult },
+			{ "premultiply unorm8", copyUNorm8s, [&](const Kernels& kernels) { kernels.processAlphaUNorm8(unorm8s.data(), numOfTexels, premultiply); }, unorm8sResult },
+			{ "dark to transparent float", copyFloats, [&](const Kernels& kernels) { kernels.processAlphaFloat(floats.data(), numOfTexels, darkToTransparent); }, floatsResult },
+			{ "transparent to dark float", copyFloats, [&](const Kernels& kernels) { kernels.processAlphaFloat(floats.data(), numOfTexels, transparentToDark); }, floatsResult },
+			{ "dark to transparent unorm8", copyUNorm8s, [&](const Kernels& kernels) { kernels.processAlphaUNorm8(unorm8s.data(), numOfTexels, darkToTransparent); }, unorm8sResult },
+			{ "transparent to dark unorm8", copyUNorm8s, [&](const Kernels& kernels) { kernels.processAlphaUNorm8(unorm8s.data(), numOfTexels, transparentToDark); }, unorm8sResult },
+			{ "3 to 4 channels float", nothing, [&](const Kernels& kernels) { kernels.changeNumOfChannelsFloat(sourceFloats.data(), 3, floats.data(), 4, numOfTexels); }, floatsResult },
+			{ "4 to 3 channels float", nothing, [&](const Kernels& kernels) { kernels.changeNumOfChannelsFloat(sourceFloats.data(), 4, floats.data(), 3, numOfTexels); }, floatsResult },
+			{ "3 to 4 channels unorm8", nothing, [&](const Kernels& kernels) { kernels.changeNumOfChannelsUNorm8(sourceUNorm8s.data(), 3, unorm8s.data(), 4, numOfTexels); }, unorm8sResult },
+			{ "4 to 3 channels unorm8", nothing, [&](const Kernels& kernels) { kernels.changeNumOfChannelsUNorm8(sourceUNorm8s.data(), 4, unorm8s.data(), 3, numOfTexels); }, unorm8sResult },
+			{ "float to unorm8", nothing, [&](const Kernels& kernels) { kernels.packUNorm8(sourceFloats.data(), unorm8s.data(), sourceFloats.size()); }, unorm8sResult },
+			{ "float to half", nothing, [&](const Kernels& kernels) { kernels.packHalf(sourceFloats.data(), halves.data(), sourceFloats.size()); }, halvesResult }
+		};
+
+		std::ostringstream report;
+		report << "Texel kernels benchmark, " << numOfTexels << " texels, best of " << numOfRepetitions << ", detected " << GetInstructionSetName(GetInstructionSet()) << "\n";
+
+		for (const auto& benchmarkCase : cases)
+		{
+			const auto& scalarKernels = getKernels(InstructionSet::Scalar);
+			const float scalarDurationMs = measure(benchmarkCase.prepareF, [&]() { benchmarkCase.kernelF(scalarKernels); });
+			const auto scalarResult = benchmarkCase.resultF();
+
+			report << benchmarkCase.name << ": scalar " << scalarDurationMs << " ms";
+
+			for (int instructionSet = (int)InstructionSet::Scalar + 1; instructionSet <= (int)GetInstructionSet(); ++instructionSet)
+			{
+				const auto& kernels = getKernels((InstructionSet)instructionSet);
+				const float durationMs = measure(benchmarkCase.prepareF, [&]() { benchmarkCase.kernelF(kernels); });
+				const bool matching = benchmarkCase.resultF() == scalarResult;
+
+				report << ", " << GetInstructionSetName((InstructionSet)instructionSet) << " " << durationMs << " ms (x" << scalarDurationMs / durationMs << (matching ? "" : ", differs") << ")";
+			}
+
+			report << "\n";
+		}
+
+		return report.str();
+	}
+}
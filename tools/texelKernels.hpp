@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Tools::TexelKernels
+{
+	enum class InstructionSet { Scalar, SSE2, AVX2, COUNT };
+
+	struct AlphaProcessing
+	{
+		bool premultiply = false;
+		bool darkToTransparent = false;
+		bool transparentToDark = false;
+	};
+
+	// Detected once. Kernels dispatch to the widest instruction set supported by the CPU and the OS, with the scalar fallback.
+	InstructionSet GetInstructionSet();
+	const char* GetInstructionSetName(InstructionSet instructionSet);
+
+	// RGBA texels, processed in place. 8 bit components are processed as normalized floats.
+	void ProcessAlpha(float* texels, size_t numOfTexels, AlphaProcessing alphaProcessing);
+	void ProcessAlpha(std::uint8_t* texels, size_t numOfTexels, AlphaProcessing alphaProcessing);
+
+	// Interleaved texels. Added channels are filled with 0, except alpha, which is filled with 1.
+	void ChangeNumOfChannels(const float* source, int sourceNumOfChannels, float* dest, int destNumOfChannels, size_t numOfTexels);
+	void ChangeNumOfChannels(const std::uint8_t* source, int sourceNumOfChannels, std::uint8_t* dest, int destNumOfChannels, size_t numOfTexels);
+
+	// Floats are clamped to [0, 1] and rounded.
+	void PackUNorm8(const float* source, std::uint8_t* dest, size_t numOfComponents);
+	void PackHalf(const float* source, std::uint16_t* dest, size_t numOfComponents);
+
+	// Microbenchmark of every supported instruction set against the scalar kernels, on a synthetic texture. Returns a printable report.
+	std::string Benchmark();
+}
@@ -11,6 +11,9 @@
 
 #include <string>
 #include <random>
+#include <compare>
+#include <cstddef>
+#include <iterator>
 
 namespace Tools
 {
@@ -67,25 +70,54 @@ namespace Tools
 				glm::vec3(-textureComponent.translate, 0.0f));
 	}
 
+	// Maps centered texture coordinates into the texture's region of the atlas page.
+	template <typename TextureComponent>
+	inline glm::mat4 AtlasRegionTransform(const TextureComponent& textureComponent)
+	{
+		if constexpr (requires { textureComponent.loaded.atlasRegion; })
+			if (textureComponent.loaded.atlasRegion)
+			{
+				const auto& [corner, size] = *textureComponent.loaded.atlasRegion;
+				return glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(corner + size * 0.5f - 0.5f, 0.0f)), glm::vec3(size, 1.0f));
+			}
+		return glm::mat4(1.0f);
+	}
+
 	template<class... Ts>
 	struct Overloads : Ts... { using Ts::operator()...; };
 
+	// Random access, so parallel algorithms can split the range instead of walking it.
 	class ItToId
 	{
 	public:
 		class It {
 		public:
+			// Dereferencing yields a value, so it's only an input iterator by the legacy requirements, but it models random access.
+			using iterator_category = std::input_iterator_tag;
+			using iterator_concept = std::random_access_iterator_tag;
 			using value_type = size_t;
 			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = value_type;
 
 			It() : id(0) {}
 			It(value_type id) : id(id) {}
 
 			value_type operator*() const { return id; }
+			value_type operator[](difference_type n) const { return id + n; }
 			It& operator++() { id++; return *this; }
 			It operator++(int) { It tmp = *this; ++(*this); return tmp; }
+			It& operator--() { id--; return *this; }
+			It operator--(int) { It tmp = *this; --(*this); return tmp; }
+			It& operator+=(difference_type n) { id += n; return *this; }
+			It& operator-=(difference_type n) { id -= n; return *this; }
+			It operator+(difference_type n) const { return It(id + n); }
+			It operator-(difference_type n) const { return It(id - n); }
+			friend It operator+(difference_type n, const It& it) { return It(it.id + n); }
+			difference_type operator-(const It& other) const { return (difference_type)id - (difference_type)other.id; }
 			bool operator==(const It& other) const { return id == other.id; }
 			bool operator!=(const It& other) const { return id != other.id; }
+			auto operator<=>(const It& other) const { return id <=> other.id; }
 
 		private:
 			value_type id;